@@ -0,0 +1,113 @@
+/* Common code for the benchmarks and checks in this directory.
+ *
+ * GNU Library General Public License (LGPL) version 2 or later.
+ *
+ * Built with the cross compiler, the programs see this tree's headers
+ * as the system ones.  Built with the build machine's compiler they
+ * find them through -idirafter ../usr/include, behind the host's own
+ * <pthread.h>, <regex.h> and so on; what the uClibc versions of those
+ * add is declared again by each program.  The atomic and futex
+ * primitives of <bits/uClibc_pthread_lock.h> go through the ARM
+ * kernel's cmpxchg helper, so on the host they are provided here with
+ * the compiler's __sync builtins and the host futex, and the lock on
+ * top of them is the same one.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H	1
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#ifndef __UCLIBC__
+# include <sys/syscall.h>
+# include <linux/futex.h>
+
+static __inline int
+__pthread_atomic_add (volatile int *__mem, int __val)
+{
+  return __sync_fetch_and_add (__mem, __val);
+}
+
+static __inline int
+__pthread_atomic_cas (volatile int *__mem, int __oldval, int __newval)
+{
+  return __sync_bool_compare_and_swap (__mem, __oldval, __newval);
+}
+
+static __inline void
+__pthread_futex_wait (volatile int *__addr, int __val)
+{
+  syscall (SYS_futex, __addr, FUTEX_WAIT, __val, NULL);
+}
+
+static __inline void
+__pthread_futex_wake (volatile int *__addr, int __nr)
+{
+  syscall (SYS_futex, __addr, FUTEX_WAKE, __nr);
+}
+
+static __inline void
+__pthread_futex_lock (volatile int *__l)
+{
+  if (__pthread_atomic_cas (__l, 0, 1))
+    return;
+  do
+    if (*__l == 2 || __pthread_atomic_cas (__l, 1, 2))
+      __pthread_futex_wait (__l, 2);
+  while (!__pthread_atomic_cas (__l, 0, 2));
+}
+
+static __inline void
+__pthread_futex_unlock (volatile int *__l)
+{
+  if (__pthread_atomic_add (__l, -1) != 1)
+    {
+      *__l = 0;
+      __pthread_futex_wake (__l, 1);
+    }
+}
+#endif /* !__UCLIBC__ */
+
+/* Seconds since the epoch; clock_gettime is in librt on the target. */
+static __inline double
+bench_now (void)
+{
+  struct timeval tv;
+
+  gettimeofday (&tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+/* A small, fast generator, so that runs are repeatable. */
+static __inline unsigned int
+bench_rand (unsigned int *seed)
+{
+  *seed = *seed * 1103515245U + 12345U;
+  return *seed >> 8;
+}
+
+/* Checks that count failures and report them, from any thread. */
+static volatile int bench_failures;
+
+#define BENCH_CHECK(cond) \
+  ((cond) ? (void) 0							\
+	  : (void) (fprintf (stderr, "%s:%d: check failed: %s\n",	\
+			     __FILE__, __LINE__, #cond),		\
+		    __pthread_atomic_add (&bench_failures, 1)))
+
+/* Exit status for main: 0, or 1 after a failed check. */
+static __inline int
+bench_status (const char *name)
+{
+  if (bench_failures != 0)
+    fprintf (stderr, "%s: %d checks failed\n", name, bench_failures);
+  return bench_failures != 0;
+}
+
+#endif /* BENCH_H */
@@ -0,0 +1,121 @@
+/* Checks the sampling heap profiler of the thread-caching malloc.
+ *
+ * GNU Library General Public License (LGPL) version 2 or later.
+ *
+ * Intervals between samples are at most one and a half times the
+ * mean, so larger blocks are always sampled and count once each, and
+ * the live and total figures for a known call stack are exact.  The
+ * functions on that stack note where they were called from, and the
+ * dumped stack must hold the same addresses.
+ * Build with -fno-omit-frame-pointer, as the profiler needs.
+ */
+
+#include "bench.h"
+#include "malloc_tc.h"
+#include <stdio.h>
+
+#define NBLOCKS	1000
+#define SIZE	8000
+#define RATE	4096
+
+static void *blocks[NBLOCKS];
+static void *called_from[3];		/* In check_2, check_1 and main */
+
+static void * __attribute__ ((__noinline__))
+check_3 (int i)
+{
+  called_from[0] = __builtin_return_address (0);
+  blocks[i] = malloc (SIZE);
+  return blocks[i];
+}
+
+static void * __attribute__ ((__noinline__))
+check_2 (int i)
+{
+  void *p;
+
+  called_from[1] = __builtin_return_address (0);
+  p = check_3 (i);
+  __asm__ __volatile__ ("" : : : "memory");
+  return p;
+}
+
+static void * __attribute__ ((__noinline__))
+check_1 (int i)
+{
+  void *p;
+
+  called_from[2] = __builtin_return_address (0);
+  p = check_2 (i);
+  __asm__ __volatile__ ("" : : : "memory");
+  return p;
+}
+
+/* Dumps the profile and returns the figures of the bucket whose stack
+   runs through check_3, check_2, check_1 and main. */
+static int
+check_dump (unsigned long *live_n, unsigned long *live_bytes,
+	    unsigned long *total_n, unsigned long *total_bytes)
+{
+  static char text[1 << 16];
+  FILE *f = tmpfile ();
+  char *line, *at;
+  void *pc[4];
+  size_t len;
+  int found = 0;
+
+  if (f == NULL)
+    return 0;
+  BENCH_CHECK (malloc_profile_dump (fileno (f)) == 0);
+  rewind (f);
+  len = fread (text, 1, sizeof (text) - 1, f);
+  text[len] = '\0';
+  fclose (f);
+
+  for (line = strtok (text, "\n"); line != NULL; line = strtok (NULL, "\n"))
+    {
+      at = strchr (line, '@');
+      if (at == NULL
+	  || sscanf (line, "%lu: %lu [%lu: %lu]", live_n, live_bytes,
+		     total_n, total_bytes) != 4
+	  || sscanf (at + 1, "%p %p %p %p", &pc[0], &pc[1], &pc[2],
+		     &pc[3]) != 4)
+	continue;
+      if (pc[1] == called_from[0] && pc[2] == called_from[1]
+	  && pc[3] == called_from[2])
+	{
+	  ++found;
+	  break;
+	}
+    }
+  return found;
+}
+
+int
+main (void)
+{
+  unsigned long live_n, live_bytes, total_n, total_bytes;
+  int i;
+
+  BENCH_CHECK (malloc_profile_start (RATE) == 0);
+  for (i = 0; i < NBLOCKS; ++i)
+    check_1 (i);
+
+  BENCH_CHECK (check_dump (&live_n, &live_bytes, &total_n, &total_bytes));
+  BENCH_CHECK (live_n == NBLOCKS && live_bytes == NBLOCKS * SIZE);
+  BENCH_CHECK (total_n == NBLOCKS && total_bytes == NBLOCKS * SIZE);
+
+  for (i = 0; i < NBLOCKS; i += 2)
+    free (blocks[i]);
+  BENCH_CHECK (check_dump (&live_n, &live_bytes, &total_n, &total_bytes));
+  BENCH_CHECK (live_n == NBLOCKS / 2 && live_bytes == NBLOCKS / 2 * SIZE);
+  BENCH_CHECK (total_n == NBLOCKS && total_bytes == NBLOCKS * SIZE);
+
+  malloc_profile_stop ();
+  for (i = 1; i < NBLOCKS; i += 2)
+    free (blocks[i]);
+  printf ("heap profile: %lu of %lu sampled blocks live,"
+	  " stack found through check_3, check_2, check_1, main\n",
+	  live_n, total_n);
+  return bench_status ("heap_profile_check");
+}
@@ -0,0 +1,213 @@
+/* Multi-threaded allocation benchmark: the thread-caching malloc
+ * against the one in libc.
+ *
+ * GNU Library General Public License (LGPL) version 2 or later.
+ *
+ * Built as malloc_bench_tc with -DBENCH_TC, and as malloc_bench
+ * without it, from the same source.  Each thread churns a table of
+ * blocks the way C++ containers do: mostly small objects, some
+ * buffers, the odd large one, freed in random order, and one block in
+ * eight handed to the next thread to free, as with work queues.
+ * Every block is filled and checked before it is freed, so a run also
+ * checks the allocator.
+ *
+ *	malloc_bench[_tc] [threads [operations per thread [blocks per thread]]]
+ */
+
+#include "bench.h"
+#ifdef BENCH_TC
+# include "malloc_tc.h"
+#else
+# include <malloc.h>
+#endif
+#include <sys/resource.h>
+
+struct bench_block
+{
+  struct bench_block *next;		/* In a hand-off list */
+  size_t size;
+  unsigned int tag;
+};
+
+struct bench_thread
+{
+  pthread_t thread;
+  unsigned int seed;
+  pthread_mutex_t lock;			/* Guards handed */
+  struct bench_block *handed;		/* Blocks to free for another thread */
+  struct bench_thread *next;
+};
+
+static long int bench_ops = 200000;
+static int bench_slots = 4000;
+
+static size_t
+bench_size (unsigned int *seed)
+{
+  unsigned int r = bench_rand (seed) % 100;
+
+  if (r < 70)
+    return sizeof (struct bench_block) + bench_rand (seed) % 112;
+  if (r < 90)
+    return 128 + bench_rand (seed) % 896;
+  if (r < 98)
+    return 1024 + bench_rand (seed) % 7168;
+  return 8192 + bench_rand (seed) % 57344;
+}
+
+static void
+bench_fill (struct bench_block *b, size_t size, unsigned int tag)
+{
+  b->next = NULL;
+  b->size = size;
+  b->tag = tag;
+  memset (b + 1, (int) (tag & 0xff), size - sizeof (struct bench_block));
+}
+
+static void
+bench_release (struct bench_block *b)
+{
+  const unsigned char *p = (const unsigned char *) (b + 1);
+  size_t n = b->size - sizeof (struct bench_block);
+  size_t i;
+
+  for (i = 0; i < n; i += n / 8 + 1)
+    BENCH_CHECK (p[i] == (b->tag & 0xff));
+  if (n != 0)
+    BENCH_CHECK (p[n - 1] == (b->tag & 0xff));
+  free (b);
+}
+
+static void
+bench_free_handed (struct bench_thread *t)
+{
+  struct bench_block *b, *next;
+
+  pthread_mutex_lock (&t->lock);
+  b = t->handed;
+  t->handed = NULL;
+  pthread_mutex_unlock (&t->lock);
+  for (; b != NULL; b = next)
+    {
+      next = b->next;
+      bench_release (b);
+    }
+}
+
+static void *
+bench_worker (void *arg)
+{
+  struct bench_thread *t = (struct bench_thread *) arg;
+  struct bench_block **slot;
+  struct bench_block *b;
+  long int op;
+  size_t size;
+  int i;
+
+  slot = (struct bench_block **) calloc (bench_slots, sizeof (*slot));
+  BENCH_CHECK (slot != NULL);
+  if (slot == NULL)
+    return NULL;
+  for (op = 0; op < bench_ops; ++op)
+    {
+      if ((op & 255) == 0)
+	bench_free_handed (t);
+      i = bench_rand (&t->seed) % bench_slots;
+      b = slot[i];
+      if (b != NULL)
+	{
+	  slot[i] = NULL;
+	  if (bench_rand (&t->seed) % 8 == 0)
+	    {
+	      pthread_mutex_lock (&t->next->lock);
+	      b->next = t->next->handed;
+	      t->next->handed = b;
+	      pthread_mutex_unlock (&t->next->lock);
+	    }
+	  else
+	    bench_release (b);
+	  continue;
+	}
+      size = bench_size (&t->seed);
+      b = (struct bench_block *) malloc (size);
+      BENCH_CHECK (b != NULL);
+      if (b == NULL)
+	continue;
+      bench_fill (b, size, bench_rand (&t->seed));
+      slot[i] = b;
+    }
+  for (i = 0; i < bench_slots; ++i)
+    if (slot[i] != NULL)
+      bench_release (slot[i]);
+  free (slot);
+  return NULL;
+}
+
+/* Resident size in bytes, or 0 if /proc is not there. */
+static size_t
+bench_rss (void)
+{
+  unsigned long int size, resident = 0;
+  FILE *f = fopen ("/proc/self/statm", "r");
+
+  if (f == NULL)
+    return 0;
+  if (fscanf (f, "%lu %lu", &size, &resident) != 2)
+    resident = 0;
+  fclose (f);
+  return resident * sysconf (_SC_PAGESIZE);
+}
+
+int
+main (int argc, char **argv)
+{
+  struct bench_thread *threads;
+  struct rusage ru;
+  double start, secs;
+  int nthreads = 12;
+  int i;
+
+  if (argc > 1)
+    nthreads = atoi (argv[1]);
+  if (argc > 2)
+    bench_ops = atol (argv[2]);
+  if (argc > 3)
+    bench_slots = atoi (argv[3]);
+  if (nthreads < 1 || bench_ops < 1 || bench_slots < 1)
+    {
+      fprintf (stderr, "usage: %s [threads [operations [blocks]]]\n",
+	       argv[0]);
+      return 2;
+    }
+
+  threads = (struct bench_thread *) calloc (nthreads, sizeof (*threads));
+  for (i = 0; i < nthreads; ++i)
+    {
+      threads[i].seed = i + 1;
+      pthread_mutex_init (&threads[i].lock, NULL);
+      threads[i].next = &threads[(i + 1) % nthreads];
+    }
+
+  start = bench_now ();
+  for (i = 0; i < nthreads; ++i)
+    pthread_create (&threads[i].thread, NULL, bench_worker, &threads[i]);
+  for (i = 0; i < nthreads; ++i)
+    pthread_join (threads[i].thread, NULL);
+  for (i = 0; i < nthreads; ++i)
+    bench_free_handed (&threads[i]);
+  secs = bench_now () - start;
+
+  malloc_trim (0);
+  getrusage (RUSAGE_SELF, &ru);
+  printf ("%s: %d threads x %ld operations: %.3f s, %.2f Mops/s\n",
+#ifdef BENCH_TC
+	  "thread-caching malloc",
+#else
+	  "libc malloc",
+#endif
+	  nthreads, bench_ops, secs, nthreads * bench_ops / secs / 1e6);
+  printf ("  peak RSS %.1f MB, RSS after freeing and malloc_trim %.1f MB\n",
+	  ru.ru_maxrss / 1024.0, bench_rss () / 1048576.0);
+  free (threads);
+  return bench_status ("malloc_bench");
+}
@@ -0,0 +1,46 @@
+/* Brings in the thread-caching malloc of <bits/uClibc_malloc_tc.h>.
+ *
+ * GNU Library General Public License (LGPL) version 2 or later.
+ *
+ * Include this, after bench.h, in the one source file of a program
+ * that should use it.  The host's <malloc.h> declares malloc_stats and
+ * the mallopt options differently, so on the host what uClibc's
+ * <malloc.h> declares for the allocator is spelled out here instead.
+ * Build the file with -fno-builtin: newer compilers turn the malloc
+ * plus memset inside calloc into a call to calloc.
+ */
+
+#ifndef BENCH_MALLOC_TC_H
+#define BENCH_MALLOC_TC_H	1
+
+#ifdef __UCLIBC__
+# define _MALLOC_TC_DEFINE	1
+# include <malloc.h>
+#else
+# define _MALLOC_H	1
+
+struct mallinfo
+{
+  int arena;
+  int ordblks;
+  int smblks;
+  int hblks;
+  int hblkhd;
+  int usmblks;
+  int fsmblks;
+  int uordblks;
+  int fordblks;
+  int keepcost;
+};
+
+# define M_TRIM_THRESHOLD	-1
+# define M_TOP_PAD		-2
+# define M_MMAP_THRESHOLD	-3
+# define M_MMAP_MAX		-4
+# define M_CHECK_ACTION		-5
+# define M_THREAD_CACHE_MAX	-6
+
+# include <bits/uClibc_malloc_tc.h>
+#endif
+
+#endif /* BENCH_MALLOC_TC_H */
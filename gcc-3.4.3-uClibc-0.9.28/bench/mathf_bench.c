@@ -0,0 +1,292 @@
+/* Accuracy and throughput of the float functions of
+ * <bits/uClibc_mathf.h> against libm.
+ *
+ * GNU Library General Public License (LGPL) version 2 or later.
+ *
+ * Each function is run over every STRIDE-th float, powf over random
+ * pairs, and its error taken against the double libm function; it must
+ * stay within the bound the header documents.  The libm float function
+ * is measured the same way for comparison.  Where libm gives a NaN, an
+ * infinity, a zero or one, as C99 Annex F has it do for the special
+ * arguments, the result must be the same.  Then both are timed over
+ * typical arguments.  Built
+ * as mathf_bench_fast with -D__FAST_MATH__, it checks the -ffast-math
+ * versions against their bounds instead.
+ *
+ * On the build machine libm has a hardware FPU under it, so only the
+ * accuracy figures carry over; the timings that matter are those of
+ * the cross-built program on the board.
+ *
+ *	mathf_bench[_fast] [stride [calls]]
+ */
+
+#include "bench.h"
+#include <math.h>
+#ifndef __UCLIBC__
+# include <bits/uClibc_mathf.h>
+#endif
+
+typedef float (*bench_f1) (float);
+typedef float (*bench_f2) (float, float);
+typedef double (*bench_d1) (double);
+
+/* The functions, out of line, and libm's; <math.h> maps the plain
+   names onto the inline ones. */
+#define BENCH_WRAP1(name) \
+  static float bench_##name (float x) { return __uclibc_##name (x); } \
+  static float libm_##name (float x) { return (name) (x); }
+
+BENCH_WRAP1 (sqrtf)
+BENCH_WRAP1 (expf)
+BENCH_WRAP1 (exp2f)
+BENCH_WRAP1 (logf)
+BENCH_WRAP1 (log2f)
+BENCH_WRAP1 (log10f)
+BENCH_WRAP1 (sinf)
+BENCH_WRAP1 (cosf)
+
+static float bench_powf (float x, float y) { return __uclibc_powf (x, y); }
+static float libm_powf (float x, float y) { return (powf) (x, y); }
+
+/* The header's error bounds, in ulp. */
+#ifdef __FAST_MATH__
+# define BOUND_EXP	4.2
+# define BOUND_LOG	2.7
+# define BOUND_LOG10	2.4
+# define BOUND_POW	4.1
+# define BOUND_TRIG	5.8
+#else
+# define BOUND_EXP	0.53
+# define BOUND_LOG	0.51
+# define BOUND_LOG10	0.51
+# define BOUND_POW	0.53
+# define BOUND_TRIG	0.54
+#endif
+
+static const struct bench_fn
+{
+  const char *name;
+  bench_f1 fn;
+  bench_f1 libm;
+  bench_d1 ref;
+  double bound;
+  float lo, hi;				/* Arguments timed */
+} bench_fns[] =
+{
+  { "sqrtf", bench_sqrtf, libm_sqrtf, sqrt, 0.5, 0.0f, 1000.0f },
+  { "expf", bench_expf, libm_expf, exp, BOUND_EXP, -10.0f, 10.0f },
+  { "exp2f", bench_exp2f, libm_exp2f, exp2, BOUND_EXP, -10.0f, 10.0f },
+  { "logf", bench_logf, libm_logf, log, BOUND_LOG, 0.001f, 1000.0f },
+  { "log2f", bench_log2f, libm_log2f, log2, BOUND_LOG, 0.001f, 1000.0f },
+  { "log10f", bench_log10f, libm_log10f, log10, BOUND_LOG10, 0.001f, 1000.0f },
+  { "sinf", bench_sinf, libm_sinf, sin, BOUND_TRIG, -3.2f, 3.2f },
+  { "cosf", bench_cosf, libm_cosf, cos, BOUND_TRIG, -3.2f, 3.2f },
+};
+
+#define NFNS	(sizeof (bench_fns) / sizeof (bench_fns[0]))
+
+static float
+bench_float (unsigned int u)
+{
+  float f;
+
+  memcpy (&f, &u, sizeof (f));
+  return f;
+}
+
+/* Error of GOT in ulp of the float nearest REF. */
+static double
+bench_ulps (float got, double ref)
+{
+  int e;
+
+  if (isnan (ref))
+    return isnan (got) ? 0 : 1e9;
+  if (isnan (got))
+    return 1e9;
+  if (fabs (ref) > 0x1.fffffep127)
+    {
+      /* Past FLT_MAX, in ulps of FLT_MAX, with infinity as 2^128. */
+      if ((got > 0) != (ref > 0))
+	return 1e9;
+      if (isinf (got))
+	return fabs (ref) >= 0x1p128 ? 0 : (0x1p128 - fabs (ref)) / 0x1p104;
+      return (fabs (ref) - fabs ((double) got)) / 0x1p104;
+    }
+  if (isinf (got))
+    return 1e9;
+  frexp (ref, &e);
+  e -= 24;
+  if (e < -149)
+    e = -149;
+  return fabs ((double) got - ref) / ldexp (1.0, e);
+}
+
+/* Whether GOT is right where libm gives an Annex F result, LIBM. */
+static int
+bench_special_ok (float got, float libm)
+{
+  if (isnan (libm))
+    return isnan (got);
+  if (isinf (libm) || libm == 0 || fabsf (libm) == 1)
+    return memcmp (&got, &libm, sizeof (got)) == 0;
+  return 1;
+}
+
+static const float bench_special[] =
+{
+  0.0f, -0.0f, INFINITY, -INFINITY, NAN, 1.0f, -1.0f, 0.5f, -0.5f,
+  2.0f, -2.0f, 3.0f, -3.0f, 0x1p-149f, -0x1p-149f,
+  0x1.fffffep127f, -0x1.fffffep127f, 0x1p24f, -0x1p24f, 0x1.000002p24f
+};
+
+#define NSPECIAL	(sizeof (bench_special) / sizeof (bench_special[0]))
+
+static volatile float bench_sink;
+
+static double
+bench_time1 (bench_f1 fn, const float *arg, int n, long int calls)
+{
+  double start = bench_now ();
+  float sum = 0;
+  long int i;
+
+  for (i = 0; i < calls; ++i)
+    sum += fn (arg[i & (n - 1)]);
+  bench_sink = sum;
+  return (bench_now () - start) / calls;
+}
+
+static double
+bench_time2 (bench_f2 fn, const float *x, const float *y, int n,
+	     long int calls)
+{
+  double start = bench_now ();
+  float sum = 0;
+  long int i;
+
+  for (i = 0; i < calls; ++i)
+    sum += fn (x[i & (n - 1)], y[i & (n - 1)]);
+  bench_sink = sum;
+  return (bench_now () - start) / calls;
+}
+
+#define NARGS	1024
+
+int
+main (int argc, char **argv)
+{
+  unsigned int stride = 4096, seed = 1;
+  long int calls = 1000000;
+  float x[NARGS], y[NARGS];
+  unsigned long long int u;
+  double err, libm_err, worst, libm_worst, ref;
+  float a, b;
+  size_t f;
+  int i, j, n;
+
+  if (argc > 1)
+    stride = strtoul (argv[1], NULL, 0);
+  if (argc > 2)
+    calls = atol (argv[2]);
+  if (stride == 0 || calls < 1)
+    {
+      fprintf (stderr, "usage: %s [stride [calls]]\n", argv[0]);
+      return 2;
+    }
+
+#ifdef __FAST_MATH__
+  printf ("-ffast-math versions, error in ulp and ns per call:\n");
+#else
+  printf ("error in ulp and ns per call:\n");
+#endif
+  printf ("%-8s %10s %10s %8s %8s %8s\n", "", "max err", "libm err",
+	  "bound", "ns", "libm ns");
+
+  for (f = 0; f < NFNS; ++f)
+    {
+      const struct bench_fn *fn = &bench_fns[f];
+
+      worst = libm_worst = 0;
+      for (u = 0; u <= 0xffffffffULL; u += stride)
+	{
+	  a = bench_float ((unsigned int) u);
+	  ref = fn->ref ((double) a);
+	  err = bench_ulps (fn->fn (a), ref);
+	  libm_err = bench_ulps (fn->libm (a), ref);
+	  if (err > worst)
+	    worst = err;
+	  if (libm_err > libm_worst)
+	    libm_worst = libm_err;
+	  BENCH_CHECK (err <= fn->bound
+		       || (fprintf (stderr, "%s (%a) = %a, want %a\n",
+				    fn->name, a, fn->fn (a), ref), 0));
+	}
+      for (i = 0; i < (int) NSPECIAL; ++i)
+	BENCH_CHECK (bench_special_ok (fn->fn (bench_special[i]),
+				       fn->libm (bench_special[i]))
+		     || (fprintf (stderr, "%s (%a) = %a, libm %a\n",
+				  fn->name, bench_special[i],
+				  fn->fn (bench_special[i]),
+				  fn->libm (bench_special[i])), 0));
+
+      for (i = 0; i < NARGS; ++i)
+	x[i] = fn->lo + (fn->hi - fn->lo) * (bench_rand (&seed) & 0xffff)
+			/ 65536.0f;
+      printf ("%-8s %10.4f %10.4f %8.2f %8.1f %8.1f\n", fn->name, worst,
+	      libm_worst, fn->bound,
+	      bench_time1 (fn->fn, x, NARGS, calls) * 1e9,
+	      bench_time1 (fn->libm, x, NARGS, calls) * 1e9);
+    }
+
+  /* powf, over positive X with exponents that keep most results in
+     range, and over small integral exponents of negative X. */
+  worst = libm_worst = 0;
+  n = 0x1000000 / (stride < 16 ? 1 : stride / 16) + 1;
+  for (i = 0; i < n; ++i)
+    {
+      a = bench_float (bench_rand (&seed) % 0x7f800000u);
+      b = ((int) (bench_rand (&seed) & 0xffff) - 0x8000) / 256.0f;
+      if (i & 1)
+	{
+	  a = -a;
+	  b = (float) (int) b;
+	}
+      ref = pow ((double) a, (double) b);
+      err = bench_ulps (bench_powf (a, b), ref);
+      libm_err = bench_ulps (libm_powf (a, b), ref);
+#ifdef __FAST_MATH__
+      /* Bounded only away from the ends of the float range. */
+      if (fabs (ref) < 0x1p-100 || fabs (ref) > 0x1p100)
+	err = libm_err = 0;
+#endif
+      if (err > worst)
+	worst = err;
+      if (libm_err > libm_worst)
+	libm_worst = libm_err;
+      BENCH_CHECK (err <= BOUND_POW
+		   || (fprintf (stderr, "powf (%a, %a) = %a, want %a\n",
+				a, b, bench_powf (a, b), ref), 0));
+    }
+  for (i = 0; i < (int) NSPECIAL; ++i)
+    for (j = 0; j < (int) NSPECIAL; ++j)
+      {
+	a = bench_special[i];
+	b = bench_special[j];
+	BENCH_CHECK (bench_special_ok (bench_powf (a, b), libm_powf (a, b))
+		     || (fprintf (stderr, "powf (%a, %a) = %a, libm %a\n",
+				  a, b, bench_powf (a, b),
+				  libm_powf (a, b)), 0));
+      }
+  for (i = 0; i < NARGS; ++i)
+    {
+      x[i] = 0.01f + 100.0f * (bench_rand (&seed) & 0xffff) / 65536.0f;
+      y[i] = ((int) (bench_rand (&seed) & 0xffff) - 0x8000) / 4096.0f;
+    }
+  printf ("%-8s %10.4f %10.4f %8.2f %8.1f %8.1f\n", "powf", worst,
+	  libm_worst, BOUND_POW,
+	  bench_time2 (bench_powf, x, y, NARGS, calls) * 1e9,
+	  bench_time2 (libm_powf, x, y, NARGS, calls) * 1e9);
+
+  return bench_status ("mathf_bench");
+}
@@ -0,0 +1,194 @@
+/* Log filter and URL router patterns through regcomp/regexec and
+ * through the cache of <bits/uClibc_regex_cache.h>.
+ *
+ * GNU Library General Public License (LGPL) version 2 or later.
+ *
+ * Each pattern is matched against every line, timed four ways: compiled
+ * for each line, as callers that keep no regex_t do; compiled once;
+ * through regcomp_cached and regexec_cached for each line; and the same
+ * asking for the subexpressions, as a router does.  The cached results
+ * must be those of regexec.
+ *
+ *	regex_bench [lines]
+ */
+
+#include "bench.h"
+#include <sys/types.h>
+#ifdef __UCLIBC__
+# define _REGEX_CACHE_DEFINE	1
+# include <regex.h>
+#else
+# include <regex.h>
+
+/* As declared by uClibc's <regex.h>. */
+typedef struct __regex_cached regex_cached_t;
+
+struct regex_cache_stats
+{
+  unsigned long hits;
+  unsigned long misses;
+  unsigned long evictions;
+  unsigned long prefilter_rejects;
+  unsigned long dfa_runs;
+  unsigned long regexec_runs;
+  unsigned int entries;
+  unsigned int dfa_entries;
+};
+
+# include <bits/uClibc_regex_cache.h>
+#endif
+
+static const char *const bench_log_patterns[] =
+{
+  "ERROR|WARN(ING)?",
+  "connection (refused|reset|timed out)",
+  "sshd\\[[0-9]+\\]: Failed password for (invalid user )?[a-z]+",
+  "segfault at [0-9a-f]+ ip [0-9a-f]+",
+  "^[A-Z][a-z]{2} [ 0-9][0-9] [0-9:]{8} [a-z0-9-]+ kernel:",
+};
+
+static const char *const bench_log_lines[] =
+{
+  "Mar 31 12:00:01 cam-7 kernel: eth0: link up, 100Mbps, full-duplex",
+  "Mar 31 12:00:02 cam-7 sshd[812]: Failed password for root from 10.0.0.9",
+  "Mar 31 12:00:02 cam-7 streamer[933]: frame 18231 encoded in 11 ms",
+  "Mar 31 12:00:03 cam-7 streamer[933]: WARNING: encoder queue at 80%",
+  "Mar 31 12:00:03 cam-7 httpd[701]: GET /api/v1/status 200 112 bytes",
+  "Mar 31 12:00:04 cam-7 rtsp[655]: client 10.0.0.21: connection reset",
+  "Mar 31 12:00:04 cam-7 kernel: agc[977]: segfault at 0 ip 0000a3f0 sp",
+  "Mar 31 12:00:05 cam-7 ntpd[402]: adjusting local clock by 0.012 s",
+};
+
+static const char *const bench_url_patterns[] =
+{
+  "^/api/v[0-9]+/users/([0-9]+)$",
+  "^/api/v[0-9]+/users/([0-9]+)/orders(/([0-9]+))?$",
+  "^/static/(.*)\\.(css|js|png)$",
+  "^/health$",
+};
+
+static const char *const bench_urls[] =
+{
+  "/api/v1/users/4711",
+  "/api/v2/users/4711/orders",
+  "/api/v2/users/4711/orders/99",
+  "/static/css/site.min.css",
+  "/static/img/logo.png",
+  "/health",
+  "/api/v1/users/me",
+  "/favicon.ico",
+};
+
+#define NELEM(a)	((int) (sizeof (a) / sizeof ((a)[0])))
+#define NSUB		5
+
+/* Times the patterns against the lines and checks the cached results;
+   NSUB subexpressions are asked for, or none with REG_NOSUB. */
+static void
+bench_set (const char *title, const char *const *patterns, int npatterns,
+	   const char *const *lines, int nlines, long int count, int nsub)
+{
+  const regex_cached_t *rc;
+  regmatch_t want[NSUB], got[NSUB];
+  double t[4];
+  long int i;
+  regex_t re;
+  int p, r, s;
+
+  printf ("%s, %ld lines, us per pattern and line:\n", title, count);
+  printf ("  %-56s %8s %8s %8s %8s\n", "", "regcomp", "regexec", "cached",
+	  "+ subs");
+  for (p = 0; p < npatterns; ++p)
+    {
+      const char *pat = patterns[p];
+      int cflags = REG_EXTENDED | (nsub ? 0 : REG_NOSUB);
+
+      t[0] = bench_now ();
+      for (i = 0; i < count / 10 + 1; ++i)
+	{
+	  BENCH_CHECK (regcomp (&re, pat, cflags) == 0);
+	  regexec (&re, lines[i % nlines], 0, NULL, 0);
+	  regfree (&re);
+	}
+      t[0] = (bench_now () - t[0]) / (count / 10 + 1);
+
+      BENCH_CHECK (regcomp (&re, pat, cflags) == 0);
+      t[1] = bench_now ();
+      for (i = 0; i < count; ++i)
+	regexec (&re, lines[i % nlines], 0, NULL, 0);
+      t[1] = (bench_now () - t[1]) / count;
+
+      t[2] = bench_now ();
+      for (i = 0; i < count; ++i)
+	{
+	  BENCH_CHECK (regcomp_cached (&rc, pat, cflags) == 0);
+	  regexec_cached (rc, lines[i % nlines], 0, NULL, 0);
+	  regfree_cached (rc);
+	}
+      t[2] = (bench_now () - t[2]) / count;
+
+      t[3] = 0;
+      if (nsub)
+	{
+	  t[3] = bench_now ();
+	  for (i = 0; i < count; ++i)
+	    {
+	      BENCH_CHECK (regcomp_cached (&rc, pat, cflags) == 0);
+	      regexec_cached (rc, lines[i % nlines], nsub, got, 0);
+	      regfree_cached (rc);
+	    }
+	  t[3] = (bench_now () - t[3]) / count;
+	}
+
+      /* The cached results, against regexec's. */
+      BENCH_CHECK (regcomp_cached (&rc, pat, cflags) == 0);
+      for (i = 0; i < nlines; ++i)
+	{
+	  r = regexec (&re, lines[i], nsub, want, 0);
+	  BENCH_CHECK (regexec_cached (rc, lines[i], 0, NULL, 0) == r);
+	  BENCH_CHECK (regexec_cached (rc, lines[i], nsub, got, 0) == r);
+	  for (s = 0; r == 0 && s < nsub; ++s)
+	    BENCH_CHECK (got[s].rm_so == want[s].rm_so
+			 && got[s].rm_eo == want[s].rm_eo);
+	}
+      regfree_cached (rc);
+      regfree (&re);
+
+      printf ("  %-56.56s %8.2f %8.2f %8.2f", pat, t[0] * 1e6, t[1] * 1e6,
+	      t[2] * 1e6);
+      if (nsub)
+	printf (" %8.2f\n", t[3] * 1e6);
+      else
+	printf (" %8s\n", "-");
+    }
+}
+
+int
+main (int argc, char **argv)
+{
+  struct regex_cache_stats st;
+  long int count = 100000;
+
+  if (argc > 1)
+    count = atol (argv[1]);
+  if (count < 1)
+    {
+      fprintf (stderr, "usage: %s [lines]\n", argv[0]);
+      return 2;
+    }
+
+  bench_set ("log filter", bench_log_patterns, NELEM (bench_log_patterns),
+	     bench_log_lines, NELEM (bench_log_lines), count, 0);
+  bench_set ("URL router", bench_url_patterns, NELEM (bench_url_patterns),
+	     bench_urls, NELEM (bench_urls), count, NSUB);
+
+  regex_cache_stats (&st);
+  printf ("cache: %lu hits, %lu misses, %u patterns with a DFA of %u;"
+	  " %lu prefilter rejects, %lu settled by the DFA, %lu regexec\n",
+	  st.hits, st.misses, st.dfa_entries, st.entries,
+	  st.prefilter_rejects, st.dfa_runs, st.regexec_runs);
+  BENCH_CHECK (st.misses == NELEM (bench_log_patterns)
+			    + NELEM (bench_url_patterns));
+  regex_cache_flush ();
+  return bench_status ("regex_bench");
+}
@@ -0,0 +1,172 @@
+/* Log timestamps through localtime_r and strftime, and through the
+ * per-second cache of <bits/uClibc_strftime_cache.h>.
+ *
+ * GNU Library General Public License (LGPL) version 2 or later.
+ *
+ * Stamps LINES lines 50 us apart, as a logger writing 20000 lines a
+ * second does, once with localtime_r, strftime and the milliseconds
+ * printed after them, and once with strftime_cached.  Before that the
+ * cache must give what strftime gives, for several formats and across
+ * a daylight saving change.
+ *
+ *	strftime_bench [lines]
+ */
+
+#include "bench.h"
+#include <time.h>
+
+#ifndef __UCLIBC__
+/* As declared by uClibc's <time.h>. */
+struct strftime_format
+{
+  char text[128];
+  unsigned char nfrac;
+  unsigned char digits[8];
+};
+
+struct strftime_cache
+{
+  const struct strftime_format *format;
+  time_t sec;
+  int valid;
+  size_t len;
+  struct tm tm;
+  unsigned char frac[8];
+  char text[128];
+};
+
+# include <bits/uClibc_strftime_cache.h>
+#endif
+
+static const char *const bench_formats[] =
+{
+  "%Y-%m-%d %H:%M:%S.%3N ",
+  "%b %e %T",
+  "[%s.%6N] %Z %z",
+  "%N|%1N|%9N %%N",
+  "%c",
+  "",
+};
+
+#define NFORMATS \
+  ((int) (sizeof (bench_formats) / sizeof (bench_formats[0])))
+
+/* FORMAT with its %N fields filled in from NSEC, for strftime. */
+static void
+bench_expand (char *out, const char *format, long nsec)
+{
+  char digits[16];
+  int n;
+
+  sprintf (digits, "%09ld", nsec);
+  while (*format != '\0')
+    {
+      if (format[0] == '%' && format[1] == '%')
+	{
+	  *out++ = *format++;
+	  *out++ = *format++;
+	}
+      else if (format[0] == '%'
+	       && (format[1] == 'N'
+		   || (format[1] >= '1' && format[1] <= '9'
+		       && format[2] == 'N')))
+	{
+	  n = format[1] == 'N' ? 9 : format[1] - '0';
+	  memcpy (out, digits, n);
+	  out += n;
+	  format += format[1] == 'N' ? 2 : 3;
+	}
+      else
+	*out++ = *format++;
+    }
+  *out = '\0';
+}
+
+static void
+bench_check (void)
+{
+  struct strftime_format fmt;
+  struct strftime_cache cache;
+  char got[256], want[256], expanded[256];
+  const struct tm *tm;
+  struct tm ref;
+  time_t sec;
+  long nsec;
+  size_t n;
+  int f;
+
+  /* Around the spring change of 2024 in Berlin. */
+  setenv ("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+  tzset ();
+  for (f = 0; f < NFORMATS; ++f)
+    {
+      BENCH_CHECK (strftime_parse (&fmt, bench_formats[f]) == 0);
+      strftime_cache_init (&cache, &fmt);
+      for (sec = 1711846790; sec < 1711846810; ++sec)
+	for (nsec = 0; nsec < 1000000000; nsec += 123456789)
+	  {
+	    n = strftime_cached (got, sizeof (got), &cache, sec, nsec);
+	    bench_expand (expanded, bench_formats[f], nsec);
+	    localtime_r (&sec, &ref);
+	    BENCH_CHECK (n == strftime (want, sizeof (want), expanded,
+					&ref));
+	    BENCH_CHECK (strcmp (got, want) == 0);
+	    tm = localtime_cached (&cache, sec);
+	    BENCH_CHECK (tm != NULL && tm->tm_hour == ref.tm_hour
+			 && tm->tm_isdst == ref.tm_isdst);
+	  }
+    }
+  BENCH_CHECK (strftime_parse (&fmt, "%N%N%N%N%N%N%N%N%N") == -1);
+}
+
+int
+main (int argc, char **argv)
+{
+  struct strftime_format fmt;
+  struct strftime_cache cache;
+  long int lines = 1000000, i;
+  double t[2];
+  char buf[64];
+  size_t n, total = 0;
+  struct tm tm;
+  time_t sec;
+  long nsec;
+
+  if (argc > 1)
+    lines = atol (argv[1]);
+  if (lines < 1)
+    {
+      fprintf (stderr, "usage: %s [lines]\n", argv[0]);
+      return 2;
+    }
+
+  bench_check ();
+
+  t[0] = bench_now ();
+  for (i = 0; i < lines; ++i)
+    {
+      sec = 1711846790 + i / 20000;
+      nsec = i % 20000 * 50000;
+      localtime_r (&sec, &tm);
+      n = strftime (buf, sizeof (buf), "%Y-%m-%d %H:%M:%S", &tm);
+      n += sprintf (buf + n, ".%03ld ", nsec / 1000000);
+      total += n;
+    }
+  t[0] = (bench_now () - t[0]) / lines;
+
+  strftime_parse (&fmt, "%Y-%m-%d %H:%M:%S.%3N ");
+  strftime_cache_init (&cache, &fmt);
+  t[1] = bench_now ();
+  for (i = 0; i < lines; ++i)
+    {
+      sec = 1711846790 + i / 20000;
+      nsec = i % 20000 * 50000;
+      total -= strftime_cached (buf, sizeof (buf), &cache, sec, nsec);
+    }
+  t[1] = (bench_now () - t[1]) / lines;
+  BENCH_CHECK (total == 0);
+
+  printf ("%ld timestamps, ns each: localtime_r + strftime %.1f,"
+	  " strftime_cached %.1f\n", lines, t[0] * 1e9, t[1] * 1e9);
+  return bench_status ("strftime_bench");
+}
@@ -42,6 +42,10 @@ namespace __cxxabiv1
 #define _GLIBCXX_GUARD_RELEASE(x) *(x) = 1
   typedef int __guard;
 
+  // The initialized bit as seen in the first int of the guard.
+#define _GLIBCXX_GUARD_BIT 1
+#define _GLIBCXX_GUARD_LOAD(x) (*(volatile int *) (x) & 1)
+
   // We also want the element size in array cookies.
 #define _GLIBCXX_ELTSIZE_IN_COOKIE 1
   
@@ -58,6 +62,14 @@ namespace __cxxabiv1
 #define _GLIBCXX_GUARD_RELEASE(x) *(char *) (x) = 1
   __extension__ typedef int __guard __attribute__((mode (__DI__)));
 
+  // The initialized byte as seen in the first int of the guard.
+#ifdef __ARMEB__
+#define _GLIBCXX_GUARD_BIT (1 << 24)
+#else
+#define _GLIBCXX_GUARD_BIT 1
+#endif
+#define _GLIBCXX_GUARD_LOAD(x) (*(volatile char *) (x))
+
   // __cxa_vec_ctor has void return type.
   typedef void __cxa_vec_ctor_return_type;
 #define _GLIBCXX_CXA_VEC_CTOR_RETURN(x) return
@@ -66,6 +78,18 @@ namespace __cxxabiv1
 
 #endif //!__ARM_EABI__
 
+  // Bits of the first int of the guard, apart from the initialized
+  // bit, used by the locking guard protocol in <ext/guard.h>: an
+  // initialization is in progress, and a thread is waiting for it.
+#define _GLIBCXX_GUARD_PENDING_BIT (1 << 8)
+#define _GLIBCXX_GUARD_WAITING_BIT (1 << 16)
+
+  // Acquire-load test of the initialized bit: once it is seen set, the
+  // guarded object's initialization is visible too.  ARMv5 cores are
+  // uniprocessor, so only the compiler needs fencing.
+#define _GLIBCXX_GUARD_TEST(x) \
+  (_GLIBCXX_GUARD_LOAD(x) && ({ __asm__ __volatile__ ("" : : : "memory"); 1; }))
+
 #ifdef __cplusplus
 } // namespace __cxxabiv1
 #endif
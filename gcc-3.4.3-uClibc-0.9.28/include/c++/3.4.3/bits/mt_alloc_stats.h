@@ -0,0 +1,129 @@
+// __mt_alloc statistics dump -*- C++ -*-
+
+// Copyright (C) 2004 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 2, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING.  If not, write to the Free
+// Software Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+// USA.
+
+// As a special exception, you may use this file as part of a free software
+// library without restriction.  Specifically, if other files instantiate
+// templates or use macros or inline functions from this file, or you compile
+// this file and link it with other files to produce an executable, this
+// file does not by itself cause the resulting executable to be covered by
+// the GNU General Public License.  This exception does not however
+// invalidate any other reasons why the executable file might be covered by
+// the GNU General Public License.
+
+/** @file mt_alloc_stats.h
+ *  This is an internal header file, included by other library headers.
+ *  You should not attempt to use it directly.
+ */
+
+// The statistics dump of __mt_alloc, at exit and on a signal.  It
+// needs <signal.h> and <fcntl.h>, so it is compiled only into the one
+// source file that defines _GLIBCXX_MT_ALLOC_STATS_DEFINE, and the
+// instantiations reach it through the weak __mt_alloc_stats_register.
+
+#ifndef _MT_ALLOC_STATS_H
+#define _MT_ALLOC_STATS_H 1
+
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace __gnu_cxx
+{
+  // Instantiations past the first 64 are counted but not printed.
+  enum { _S_mt_alloc_stats_max = 64 };
+
+  static void (*__mt_alloc_stats_print[_S_mt_alloc_stats_max])(int);
+  static _Atomic_word __mt_alloc_stats_count;
+  static struct sigaction __mt_alloc_stats_old_action;
+
+  // Writes the statistics of every registered instantiation to where
+  // GLIBCXX_MT_ALLOC_STATS says: "1" or "stderr" for standard error,
+  // anything else is a file name appended to.
+  static void
+  __mt_alloc_stats_dump()
+  {
+    const char* __dest = getenv("GLIBCXX_MT_ALLOC_STATS");
+    if (!__dest)
+      return;
+    int __fd = 2;
+    if (std::strcmp(__dest, "1") != 0 && std::strcmp(__dest, "stderr") != 0)
+      {
+	__fd = ::open(__dest, O_WRONLY | O_CREAT | O_APPEND, 0666);
+	if (__fd < 0)
+	  return;
+      }
+
+    int __n = __mt_alloc_stats_count;
+    if (__n > _S_mt_alloc_stats_max)
+      __n = _S_mt_alloc_stats_max;
+    for (int __i = 0; __i < __n; ++__i)
+      if (__mt_alloc_stats_print[__i])
+	__mt_alloc_stats_print[__i](__fd);
+
+    if (__fd != 2)
+      ::close(__fd);
+  }
+
+  static void
+  __mt_alloc_stats_at_exit()
+  { __mt_alloc_stats_dump(); }
+
+  static void
+  __mt_alloc_stats_on_signal(int __sig, siginfo_t* __info, void* __ctx)
+  {
+    __mt_alloc_stats_dump();
+
+    // Pass the signal on to the handler installed before us, the way
+    // it asked to be called.
+    const struct sigaction& __old = __mt_alloc_stats_old_action;
+    if (__old.sa_flags & SA_SIGINFO)
+      __old.sa_sigaction(__sig, __info, __ctx);
+    else if (__old.sa_handler != SIG_DFL && __old.sa_handler != SIG_IGN)
+      __old.sa_handler(__sig);
+  }
+
+  void
+  __mt_alloc_stats_register(void (*__print)(int))
+  {
+    if (!getenv("GLIBCXX_MT_ALLOC_STATS"))
+      return;
+
+    const int __i = __exchange_and_add(&__mt_alloc_stats_count, 1);
+    if (__i < _S_mt_alloc_stats_max)
+      __mt_alloc_stats_print[__i] = __print;
+    if (__i != 0)
+      return;
+
+    // The first instantiation to register sets up the dump for all.
+    atexit(__mt_alloc_stats_at_exit);
+    const char* __sig = getenv("GLIBCXX_MT_ALLOC_STATS_SIGNAL");
+    if (__sig && atoi(__sig) > 0)
+      {
+	struct sigaction __sa;
+	std::memset(&__sa, 0, sizeof(__sa));
+	__sa.sa_sigaction = __mt_alloc_stats_on_signal;
+	sigemptyset(&__sa.sa_mask);
+	__sa.sa_flags = SA_SIGINFO | SA_RESTART;
+	sigaction(atoi(__sig), &__sa, &__mt_alloc_stats_old_action);
+      }
+  }
+} // namespace __gnu_cxx
+
+#endif
@@ -0,0 +1,578 @@
+// "C" locale numeric conversions for iostreams -*- C++ -*-
+
+// Copyright (C) 2004 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 2, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING.  If not, write to the Free
+// Software Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+// USA.
+
+// As a special exception, you may use this file as part of a free software
+// library without restriction.  Specifically, if other files instantiate
+// templates or use macros or inline functions from this file, or you compile
+// this file and link it with other files to produce an executable, this
+// file does not by itself cause the resulting executable to be covered by
+// the GNU General Public License.  This exception does not however
+// invalidate any other reasons why the executable file might be covered by
+// the GNU General Public License.
+
+/** @file num_classic.h
+ *  This is an internal header file, included by other library headers.
+ *  You should not attempt to use it directly.
+ */
+
+// Warning: this file is not meant for user inclusion. Use <ostream>
+// or <istream>.
+
+#ifndef _NUM_CLASSIC_H
+#define _NUM_CLASSIC_H 1
+
+#pragma GCC system_header
+
+#include <cstdlib>
+#include <cerrno>
+#include <limits>
+#include <locale>
+
+namespace std
+{
+  // num_get has no int overload of get: extract a long and range check
+  // it, as basic_istream::operator>>(int&) always did.
+  // _GLIBCXX_RESOLVE_LIB_DEFECTS
+  // 118. basic_istream uses nonexistent num_get member functions.
+  template<typename _CharT, typename _InIter, typename _ValueT>
+    inline void
+    __num_get_value(const num_get<_CharT, _InIter>& __ng,
+		    basic_ios<_CharT, typename _InIter::traits_type>& __io,
+		    ios_base::iostate& __err, _ValueT& __v)
+    { __ng.get(__io.rdbuf(), _InIter(), __io, __err, __v); }
+
+  template<typename _CharT, typename _InIter>
+    inline void
+    __num_get_value(const num_get<_CharT, _InIter>& __ng,
+		    basic_ios<_CharT, typename _InIter::traits_type>& __io,
+		    ios_base::iostate& __err, int& __v)
+    {
+      long __l;
+      __ng.get(__io.rdbuf(), _InIter(), __io, __err, __l);
+      if (!(__err & ios_base::failbit)
+	  && (numeric_limits<int>::min() <= __l
+	      && __l <= numeric_limits<int>::max()))
+	__v = __l;
+      else
+	__err |= ios_base::failbit;
+    }
+
+  /**
+   *  @if maint
+   *  Numeric conversion for streams imbued with the classic "C" locale.
+   *
+   *  uClibc is configured without locale support, so in practice every
+   *  stream formats numbers in the "C" locale; yet num_put and num_get
+   *  build a numpunct cache, copy through several alloca'd buffers and,
+   *  for floating point, round-trip through setlocale and vsnprintf on
+   *  every value.  For char streams whose num_put/num_get and numpunct
+   *  facets are those of locale::classic(), _S_put and _S_get convert
+   *  directly to and from the stream buffer instead.  They return false,
+   *  having touched nothing, whenever the value or the stream's flags
+   *  need something they do not handle, and the caller then uses the
+   *  facet as before.  The output is character for character that of
+   *  num_put, so the choice is invisible to the user.
+   *
+   *  The primary template never applies.
+   *  @endif
+  */
+  template<typename _CharT, typename _Traits>
+    struct __num_classic
+    {
+      template<typename _Facet, typename _ValueT>
+        static bool
+        _S_put(basic_ios<_CharT, _Traits>&, const _Facet&, _ValueT,
+	       ios_base::iostate&)
+        { return false; }
+
+      template<typename _Facet, typename _ValueT>
+        static bool
+        _S_get(basic_ios<_CharT, _Traits>&, const _Facet&, _ValueT&,
+	       ios_base::iostate&)
+        { return false; }
+    };
+
+  template<>
+    struct __num_classic<char, char_traits<char> >
+    {
+      typedef basic_ios<char, char_traits<char> >	__ios_type;
+      typedef basic_streambuf<char, char_traits<char> > __streambuf_type;
+      typedef char_traits<char>				__traits_type;
+
+      // True if __f and the numpunct of __io's locale are the facets of
+      // the classic locale.
+      template<typename _Facet>
+        static bool
+        _S_classic(const ios_base& __io, const _Facet& __f)
+        {
+	  const locale& __c = locale::classic();
+	  return &__f == &use_facet<_Facet>(__c)
+	    && (&use_facet<numpunct<char> >(__io._M_getloc())
+		== &use_facet<numpunct<char> >(__c));
+	}
+
+      // Like __int_to_char, decimal only: the digits of __v end at
+      // __bufend, and the returned pointer is their start.
+      static char*
+      _S_utoa(char* __bufend, unsigned long __v)
+      {
+	do
+	  {
+	    *--__bufend = '0' + __v % 10;
+	    __v /= 10;
+	  }
+	while (__v != 0);
+	return __bufend;
+      }
+
+      // Pads as num_put::_M_pad does, then writes the result.
+      static void
+      _S_write(__ios_type& __io, const char* __cs, streamsize __len,
+	       ios_base::iostate& __err)
+      {
+	const streamsize __w = __io.width();
+	if (__w > __len)
+	  {
+	    char* __cs3 = static_cast<char*>(__builtin_alloca(__w));
+	    __pad<char, __traits_type>::_S_pad(__io, __io.fill(), __cs3, __cs,
+					       __w, __len, true);
+	    __cs = __cs3;
+	    __len = __w;
+	  }
+	__io.width(0);
+	if (__io.rdbuf()->sputn(__cs, __len) != __len)
+	  __err |= ios_base::badbit;
+      }
+
+      // Anything but oct or hex formats in decimal, see __int_to_char.
+      static bool
+      _S_decimal(ios_base::fmtflags __flags)
+      {
+	const ios_base::fmtflags __basefield = __flags & ios_base::basefield;
+	return __basefield != ios_base::oct && __basefield != ios_base::hex;
+      }
+
+      template<typename _Facet>
+        static bool
+        _S_put(__ios_type& __io, const _Facet& __np, long __v,
+	       ios_base::iostate& __err)
+        {
+	  const ios_base::fmtflags __flags = __io.flags();
+	  if (!_S_decimal(__flags) || !_S_classic(__io, __np))
+	    return false;
+
+	  char __buf[4 * sizeof(long)];
+	  char* const __bufend = __buf + sizeof(__buf);
+	  char* __cs;
+	  if (__v < 0)
+	    {
+	      __cs = _S_utoa(__bufend, -static_cast<unsigned long>(__v));
+	      *--__cs = '-';
+	    }
+	  else
+	    {
+	      __cs = _S_utoa(__bufend, __v);
+	      if (__flags & ios_base::showpos)
+		*--__cs = '+';
+	    }
+	  _S_write(__io, __cs, __bufend - __cs, __err);
+	  return true;
+	}
+
+      // About showpos, see Table 60 and C99 7.19.6.1, p6 (+).
+      template<typename _Facet>
+        static bool
+        _S_put(__ios_type& __io, const _Facet& __np, unsigned long __v,
+	       ios_base::iostate& __err)
+        {
+	  if (!_S_decimal(__io.flags()) || !_S_classic(__io, __np))
+	    return false;
+
+	  char __buf[4 * sizeof(unsigned long)];
+	  char* const __bufend = __buf + sizeof(__buf);
+	  const char* __cs = _S_utoa(__bufend, __v);
+	  _S_write(__io, __cs, __bufend - __cs, __err);
+	  return true;
+	}
+
+      template<typename _Facet>
+        static bool
+        _S_put(__ios_type& __io, const _Facet& __np, double __v,
+	       ios_base::iostate& __err)
+        {
+	  const ios_base::fmtflags __flags = __io.flags();
+	  const ios_base::fmtflags __fltfield = __flags & ios_base::floatfield;
+	  if (__fltfield == ios_base::fixed
+	      || __fltfield == ios_base::scientific
+	      || (__flags & ios_base::showpoint))
+	    return false;
+
+	  // As in num_put::_M_insert_float, and %.0g means %.1g.
+	  streamsize __prec = __io.precision();
+	  if (__prec < static_cast<streamsize>(0))
+	    __prec = static_cast<streamsize>(6);
+	  else if (__prec == static_cast<streamsize>(0))
+	    __prec = static_cast<streamsize>(1);
+	  if (__prec > static_cast<streamsize>(15))
+	    return false;
+
+	  if (!_S_classic(__io, __np))
+	    return false;
+	  char __buf[32];
+	  const int __len = _S_dtoa(__buf, __v, static_cast<int>(__prec),
+				    __flags);
+	  if (__len < 0)
+	    return false;
+	  _S_write(__io, __buf, __len, __err);
+	  return true;
+	}
+
+      template<typename _Facet, typename _ValueT>
+        static bool
+        _S_put(__ios_type&, const _Facet&, _ValueT, ios_base::iostate&)
+        { return false; }
+
+      // Formats __v as printf's "%.*g" (or "%+.*G" &c, per __flags) with
+      // 1 <= __prec <= 15 significant digits.  Scaling by an exactly
+      // representable power of ten rounds once, so the digits are
+      // correctly rounded unless the scaled value lies within an ulp of
+      // a rounding tie; that case, and values needing a scale beyond
+      // 1e22, NaNs and infinities, return -1 and are left to snprintf.
+      static int
+      _S_dtoa(char* __out, double __v, int __prec, ios_base::fmtflags __flags)
+      {
+	static const double __pow10[] =
+	  {
+	    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	  };
+
+	const bool __neg = __v < 0 || (__v == 0 && 1 / __v < 0);
+	const double __a = __neg ? -__v : __v;
+	if (__a != __a || __a > numeric_limits<double>::max())
+	  return -1;
+
+	// Decimal exponent __x and __prec digits __n of __a, such that
+	// __a rounds to __n * 10^(__x - __prec + 1).
+	unsigned long long __n = 0;
+	int __x = 0;
+	if (__a != 0)
+	  {
+	    if (__a >= 1)
+	      {
+		if (__a >= 1e23)
+		  return -1;
+		while (__x < 22 && __pow10[__x + 1] <= __a)
+		  ++__x;
+	      }
+	    else
+	      {
+		if (__a < 1e-22)
+		  return -1;
+		__x = -1;
+		while (__x > -22 && __a * __pow10[-__x] < 1)
+		  --__x;
+	      }
+
+	    const unsigned long long __lo =
+	      static_cast<unsigned long long>(__pow10[__prec - 1]);
+	    const unsigned long long __hi =
+	      static_cast<unsigned long long>(__pow10[__prec]);
+	    for (int __tries = 0; ; ++__tries)
+	      {
+		const int __k = __prec - 1 - __x;
+		if (__tries == 3 || __k > 22 || __k < -22)
+		  return -1;
+		const double __r = __k >= 0 ? __a * __pow10[__k]
+		                            : __a / __pow10[-__k];
+		if (__r >= 1e16)
+		  {
+		    ++__x;
+		    continue;
+		  }
+		const unsigned long long __i =
+		  static_cast<unsigned long long>(__r);
+		const double __f = __r - static_cast<double>(__i);
+		const double __ulp = __r * numeric_limits<double>::epsilon();
+		if (__f - 0.5 < __ulp && 0.5 - __f < __ulp)
+		  return -1;
+		if (__i >= __hi)
+		  ++__x;
+		else if (__i < __lo)
+		  --__x;
+		else
+		  {
+		    __n = __i + (__f > 0.5);
+		    if (__n == __hi)
+		      {
+			__n = __lo;
+			++__x;
+		      }
+		    break;
+		  }
+	      }
+	  }
+
+	// The digits, most significant first, less trailing zeros.
+	char __d[16];
+	unsigned long __top = static_cast<unsigned long>(__n / 100000000UL);
+	unsigned long __bot = static_cast<unsigned long>(__n % 100000000UL);
+	for (int __j = __prec - 1; __j >= 0; --__j)
+	  {
+	    if (__j == __prec - 9)
+	      __bot = __top;
+	    __d[__j] = '0' + __bot % 10;
+	    __bot /= 10;
+	  }
+	int __nd = __prec;
+	while (__nd > 1 && __d[__nd - 1] == '0')
+	  --__nd;
+
+	char* __p = __out;
+	if (__neg)
+	  *__p++ = '-';
+	else if (__flags & ios_base::showpos)
+	  *__p++ = '+';
+
+	if (__x < -4 || __x >= __prec)
+	  {
+	    // Style e.
+	    *__p++ = __d[0];
+	    if (__nd > 1)
+	      {
+		*__p++ = '.';
+		__traits_type::copy(__p, __d + 1, __nd - 1);
+		__p += __nd - 1;
+	      }
+	    *__p++ = (__flags & ios_base::uppercase) ? 'E' : 'e';
+	    int __e = __x;
+	    if (__e < 0)
+	      {
+		*__p++ = '-';
+		__e = -__e;
+	      }
+	    else
+	      *__p++ = '+';
+	    *__p++ = '0' + __e / 10;
+	    *__p++ = '0' + __e % 10;
+	  }
+	else if (__x >= 0)
+	  {
+	    // Style f, __x + 1 integral digits.
+	    __traits_type::copy(__p, __d, __x + 1);
+	    __p += __x + 1;
+	    if (__nd > __x + 1)
+	      {
+		*__p++ = '.';
+		__traits_type::copy(__p, __d + __x + 1, __nd - __x - 1);
+		__p += __nd - __x - 1;
+	      }
+	  }
+	else
+	  {
+	    // Style f, 0.000ddd.
+	    *__p++ = '0';
+	    *__p++ = '.';
+	    __traits_type::assign(__p, -__x - 1, '0');
+	    __p += -__x - 1;
+	    __traits_type::copy(__p, __d, __nd);
+	    __p += __nd;
+	  }
+	return __p - __out;
+      }
+
+      // The decimal part of num_get::_M_extract_int, reading the
+      // stream buffer directly.
+      template<typename _Facet, typename _ValueT>
+        static bool
+        _S_get_int(__ios_type& __io, const _Facet& __ng, _ValueT& __v,
+		   ios_base::iostate& __err)
+        {
+	  if ((__io.flags() & ios_base::basefield) != ios_base::dec
+	      || !_S_classic(__io, __ng))
+	    return false;
+
+	  const int __eof = __traits_type::eof();
+	  __streambuf_type* __sb = __io.rdbuf();
+	  int __c = __sb->sgetc();
+
+	  bool __neg = false;
+	  if (numeric_limits<_ValueT>::is_signed)
+	    __neg = __c == '-';
+	  if (__neg || __c == '+')
+	    __c = __sb->snextc();
+
+	  // Accumulate the magnitude, bounded by that of max() or min().
+	  const unsigned long __max = __neg
+	    ? -static_cast<unsigned long>(numeric_limits<_ValueT>::min())
+	    : static_cast<unsigned long>(numeric_limits<_ValueT>::max());
+	  unsigned long __result = 0;
+	  bool __found_num = false;
+	  bool __overflow = false;
+	  for (; __c != __eof; __c = __sb->snextc())
+	    {
+	      const unsigned int __digit = __c - '0';
+	      if (__digit > 9)
+		break;
+	      __found_num = true;
+	      if (__result > (__max - __digit) / 10)
+		__overflow = true;
+	      else
+		__result = __result * 10 + __digit;
+	    }
+
+	  if (!__overflow && __found_num)
+	    __v = __neg ? static_cast<_ValueT>(-__result)
+	                : static_cast<_ValueT>(__result);
+	  else
+	    __err |= ios_base::failbit;
+
+	  if (__c == __eof)
+	    __err |= ios_base::eofbit;
+	  return true;
+	}
+
+      template<typename _Facet>
+        static bool
+        _S_get(__ios_type& __io, const _Facet& __ng, int& __v,
+	       ios_base::iostate& __err)
+        { return _S_get_int(__io, __ng, __v, __err); }
+
+      template<typename _Facet>
+        static bool
+        _S_get(__ios_type& __io, const _Facet& __ng, unsigned int& __v,
+	       ios_base::iostate& __err)
+        { return _S_get_int(__io, __ng, __v, __err); }
+
+      template<typename _Facet>
+        static bool
+        _S_get(__ios_type& __io, const _Facet& __ng, long& __v,
+	       ios_base::iostate& __err)
+        { return _S_get_int(__io, __ng, __v, __err); }
+
+      template<typename _Facet>
+        static bool
+        _S_get(__ios_type& __io, const _Facet& __ng, unsigned long& __v,
+	       ios_base::iostate& __err)
+        { return _S_get_int(__io, __ng, __v, __err); }
+
+      // num_get::_M_extract_float followed by the generic
+      // __convert_to_v, without the setlocale calls: uClibc's strtod
+      // only knows the "C" locale.
+      template<typename _Facet>
+        static bool
+        _S_get(__ios_type& __io, const _Facet& __ng, double& __v,
+	       ios_base::iostate& __err)
+        {
+	  if (!_S_classic(__io, __ng))
+	    return false;
+
+	  const int __eof = __traits_type::eof();
+	  __streambuf_type* __sb = __io.rdbuf();
+	  int __c = __sb->sgetc();
+
+	  // Almost every number fits in __buf; longer ones spill into
+	  // __xtrc.
+	  char __buf[64];
+	  size_t __len = 0;
+	  string __xtrc;
+
+	  if (__c == '+' || __c == '-')
+	    {
+	      __buf[__len++] = __c;
+	      __c = __sb->snextc();
+	    }
+
+	  // Leading zeros.
+	  bool __found_mantissa = false;
+	  for (; __c == '0'; __c = __sb->snextc())
+	    if (!__found_mantissa)
+	      {
+		__buf[__len++] = '0';
+		__found_mantissa = true;
+	      }
+
+	  bool __found_dec = false;
+	  bool __found_sci = false;
+	  while (__c != __eof)
+	    {
+	      if (__len + 3 > sizeof(__buf))
+		{
+		  __xtrc.append(__buf, __len);
+		  __len = 0;
+		}
+
+	      if (__c == '.')
+		{
+		  if (__found_dec || __found_sci)
+		    break;
+		  __buf[__len++] = '.';
+		  __found_dec = true;
+		}
+	      else if (static_cast<unsigned int>(__c - '0') <= 9)
+		{
+		  __buf[__len++] = __c;
+		  __found_mantissa = true;
+		}
+	      else if ((__c == 'e' || __c == 'E')
+		       && __found_mantissa && !__found_sci)
+		{
+		  // Scientific notation, with an optional sign.
+		  __buf[__len++] = 'e';
+		  __found_sci = true;
+		  __c = __sb->snextc();
+		  if (__c != '+' && __c != '-')
+		    continue;
+		  __buf[__len++] = __c;
+		}
+	      else
+		break;
+	      __c = __sb->snextc();
+	    }
+	  __buf[__len] = '\0';
+
+	  const char* __s = __buf;
+	  if (!__xtrc.empty())
+	    {
+	      __xtrc.append(__buf, __len);
+	      __s = __xtrc.c_str();
+	    }
+
+	  char* __sanity;
+	  errno = 0;
+	  const double __d = std::strtod(__s, &__sanity);
+	  if (__sanity != __s && *__sanity == '\0' && errno != ERANGE)
+	    __v = __d;
+	  else
+	    __err |= ios_base::failbit;
+
+	  if (__c == __eof)
+	    __err |= ios_base::eofbit;
+	  return true;
+	}
+
+      template<typename _Facet, typename _ValueT>
+        static bool
+        _S_get(__ios_type&, const _Facet&, _ValueT&, ios_base::iostate&)
+        { return false; }
+    };
+} // namespace std
+
+#endif
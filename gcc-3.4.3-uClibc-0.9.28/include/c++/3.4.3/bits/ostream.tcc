@@ -38,6 +38,7 @@
 #pragma GCC system_header
 
 #include <locale>
+#include <bits/num_classic.h>
 
 namespace std
 {
@@ -115,61 +116,30 @@ namespace std
     }
 
   template<typename _CharT, typename _Traits>
-    basic_ostream<_CharT, _Traits>&
-    basic_ostream<_CharT, _Traits>::
-    operator<<(long __n)
-    {
-      sentry __cerb(*this);
-      if (__cerb)
-	{
-	  ios_base::iostate __err = ios_base::iostate(ios_base::goodbit);
-	  try
-	    {
-	      bool __b = false;
-	      const char_type __c = this->fill();
-	      const ios_base::fmtflags __fmt = (this->flags()
-						& ios_base::basefield);
-	      const __num_put_type& __np = __check_facet(this->_M_num_put);
-	      if ((__fmt & ios_base::oct) || (__fmt & ios_base::hex))
-		{
-		  const unsigned long __l = static_cast<unsigned long>(__n);
-		  __b = __np.put(*this, *this, __c, __l).failed();
-		}
-	      else
-		__b = __np.put(*this, *this, __c, __n).failed();
-	      if (__b)
-		__err |= ios_base::badbit;
-	    }
-	  catch(...)
-	    { this->_M_setstate(ios_base::badbit); }
-	  if (__err)
-	    this->setstate(__err);
-	}
-      return *this;
-    }
-
-  template<typename _CharT, typename _Traits>
-    basic_ostream<_CharT, _Traits>&
-    basic_ostream<_CharT, _Traits>::
-    operator<<(unsigned long __n)
-    {
-      sentry __cerb(*this);
-      if (__cerb)
-	{
-	  ios_base::iostate __err = ios_base::iostate(ios_base::goodbit);
-	  try
-	    {
-	      const __num_put_type& __np = __check_facet(this->_M_num_put);
-	      if (__np.put(*this, *this, this->fill(), __n).failed())
-		__err |= ios_base::badbit;
-	    }
-	  catch(...)
-	    { this->_M_setstate(ios_base::badbit); }
-	  if (__err)
-	    this->setstate(__err);
-	}
-      return *this;
-    }
+    template<typename _ValueT>
+      basic_ostream<_CharT, _Traits>&
+      basic_ostream<_CharT, _Traits>::
+      _M_insert(_ValueT __v)
+      {
+	sentry __cerb(*this);
+	if (__cerb)
+	  {
+	    ios_base::iostate __err = ios_base::iostate(ios_base::goodbit);
+	    try
+	      {
+		const __num_put_type& __np = __check_facet(this->_M_num_put);
+		if (!__num_classic<_CharT, _Traits>::_S_put(*this, __np, __v,
+							     __err)
+		    && __np.put(*this, *this, this->fill(), __v).failed())
+		  __err |= ios_base::badbit;
+	      }
+	    catch(...)
+	      { this->_M_setstate(ios_base::badbit); }
+	    if (__err)
+	      this->setstate(__err);
+	  }
+	return *this;
+      }
 
 #ifdef _GLIBCXX_USE_LONG_LONG
   template<typename _CharT, typename _Traits>
@@ -231,29 +201,6 @@ namespace std
     }
 #endif
 
-  template<typename _CharT, typename _Traits>
-    basic_ostream<_CharT, _Traits>&
-    basic_ostream<_CharT, _Traits>::
-    operator<<(double __n)
-    {
-      sentry __cerb(*this);
-      if (__cerb)
-	{
-	  ios_base::iostate __err = ios_base::iostate(ios_base::goodbit);
-	  try
-	    {
-	      const __num_put_type& __np = __check_facet(this->_M_num_put);
-	      if (__np.put(*this, *this, this->fill(), __n).failed())
-		__err |= ios_base::badbit;
-	    }
-	  catch(...)
-	    { this->_M_setstate(ios_base::badbit); }
-	  if (__err)
-	    this->setstate(__err);
-	}
-      return *this;
-    }
-
   template<typename _CharT, typename _Traits>
     basic_ostream<_CharT, _Traits>&
     basic_ostream<_CharT, _Traits>::
@@ -291,8 +291,9 @@ namespace std
     {
       typedef typename iterator_traits<_InputIterator>::value_type
 	_ValueType;
-      typedef typename __type_traits<
-	_ValueType>::has_trivial_assignment_operator _Trivial;
+      typedef typename __type_or<typename __type_traits<
+	_ValueType>::has_trivial_assignment_operator,
+	typename __bitwise_copyable<_ValueType>::_Type>::_Type _Trivial;
       return _OutputIterator(std::__copy_aux2(__first, __last, __result.base(),
 					      _Trivial()));
     }
@@ -303,8 +304,9 @@ namespace std
 	       _OutputIterator __result, __false_type)
     {
       typedef typename iterator_traits<_InputIterator>::value_type _ValueType;
-      typedef typename __type_traits<
-	_ValueType>::has_trivial_assignment_operator _Trivial;
+      typedef typename __type_or<typename __type_traits<
+	_ValueType>::has_trivial_assignment_operator,
+	typename __bitwise_copyable<_ValueType>::_Type>::_Type _Trivial;
       return std::__copy_aux2(__first, __last, __result, _Trivial());
     }
 
@@ -424,8 +426,10 @@ namespace std
     inline _BI2
     __copy_backward_aux(_BI1 __first, _BI1 __last, _BI2 __result)
     {
-      typedef typename __type_traits<typename iterator_traits<_BI2>::value_type>
-			    ::has_trivial_assignment_operator _Trivial;
+      typedef typename iterator_traits<_BI2>::value_type _ValueType;
+      typedef typename __type_or<typename __type_traits<
+	_ValueType>::has_trivial_assignment_operator,
+	typename __bitwise_copyable<_ValueType>::_Type>::_Type _Trivial;
       return
 	std::__copy_backward_dispatch<_BI1, _BI2, _Trivial>::copy(__first,
 								  __last,
@@ -344,6 +344,231 @@ namespace _GLIBCXX_STD
   operator+(ptrdiff_t __n, const _Bit_const_iterator& __x)
   { return __x + __n; }
 
+  // Word-at-a-time versions of the algorithms most used on vector<bool>.
+  // The generic ones go through _Bit_reference one bit at a time.
+
+  // The __k bits (0 < __k <= _S_word_bit) starting at bit __off of
+  // *__p, in the low bits of the result.  __p[1] is only read if the
+  // bits spill into it.
+  inline _Bit_type
+  __bvector_get(const _Bit_type* __p, unsigned int __off, unsigned int __k)
+  {
+    _Bit_type __w = __p[0] >> __off;
+    if (__off + __k > _S_word_bit)
+      __w |= __p[1] << (_S_word_bit - __off);
+    return __k == _S_word_bit ? __w : __w & ((_Bit_type(1) << __k) - 1);
+  }
+
+  // Stores __w into the __k bits starting at bit __off of *__p, which
+  // must all lie in that word.
+  inline void
+  __bvector_put(_Bit_type* __p, unsigned int __off, unsigned int __k,
+		_Bit_type __w)
+  {
+    if (__k == _S_word_bit)
+      *__p = __w;
+    else
+      {
+	const _Bit_type __mask = ((_Bit_type(1) << __k) - 1) << __off;
+	*__p = (*__p & ~__mask) | ((__w << __off) & __mask);
+      }
+  }
+
+  inline void
+  __bvector_advance(_Bit_type*& __p, unsigned int& __off, unsigned int __k)
+  {
+    __off += __k;
+    if (__off >= _S_word_bit)
+      {
+	__off -= _S_word_bit;
+	++__p;
+      }
+  }
+
+  inline ptrdiff_t
+  __bvector_count(const _Bit_iterator_base& __first,
+		  const _Bit_iterator_base& __last, bool __x)
+  {
+    const ptrdiff_t __n = __last - __first;
+    if (__n <= 0)
+      return 0;
+    ptrdiff_t __ones;
+    const _Bit_type* __p = __first._M_p;
+    if (__p == __last._M_p)
+      __ones = __builtin_popcountl(__bvector_get(__p, __first._M_offset,
+						 __n));
+    else
+      {
+	__ones = __builtin_popcountl(*__p++ >> __first._M_offset);
+	for (; __p != __last._M_p; ++__p)
+	  __ones += __builtin_popcountl(*__p);
+	if (__last._M_offset)
+	  __ones += __builtin_popcountl(__bvector_get(__p, 0,
+						      __last._M_offset));
+      }
+    return __x ? __ones : __n - __ones;
+  }
+
+  inline ptrdiff_t
+  count(_Bit_iterator __first, _Bit_iterator __last, const bool& __x)
+  { return __bvector_count(__first, __last, __x); }
+
+  inline ptrdiff_t
+  count(_Bit_const_iterator __first, _Bit_const_iterator __last,
+	const bool& __x)
+  { return __bvector_count(__first, __last, __x); }
+
+  // Returns the position of the first bit equal to __x, or __last.
+  inline _Bit_iterator
+  __bvector_find(const _Bit_iterator_base& __first,
+		 const _Bit_iterator_base& __last, bool __x)
+  {
+    if (!(__first < __last))
+      return _Bit_iterator(__last._M_p, __last._M_offset);
+    const _Bit_type __flip = __x ? _Bit_type(0) : ~_Bit_type(0);
+    _Bit_type* __p = __first._M_p;
+    _Bit_type __mask = ~_Bit_type(0) << __first._M_offset;
+    for (; __p != __last._M_p; ++__p)
+      {
+	const _Bit_type __w = (*__p ^ __flip) & __mask;
+	if (__w)
+	  return _Bit_iterator(__p, __builtin_ctzl(__w));
+	__mask = ~_Bit_type(0);
+      }
+    if (__last._M_offset)
+      {
+	__mask &= ~_Bit_type(0) >> (_S_word_bit - __last._M_offset);
+	const _Bit_type __w = (*__p ^ __flip) & __mask;
+	if (__w)
+	  return _Bit_iterator(__p, __builtin_ctzl(__w));
+      }
+    return _Bit_iterator(__last._M_p, __last._M_offset);
+  }
+
+  inline _Bit_iterator
+  find(_Bit_iterator __first, _Bit_iterator __last, const bool& __x)
+  { return __bvector_find(__first, __last, __x); }
+
+  inline _Bit_const_iterator
+  find(_Bit_const_iterator __first, _Bit_const_iterator __last,
+       const bool& __x)
+  { return __bvector_find(__first, __last, __x); }
+
+  inline void
+  fill(_Bit_iterator __first, _Bit_iterator __last, const bool& __x)
+  {
+    if (!(__first < __last))
+      return;
+    const _Bit_type __w = __x ? ~_Bit_type(0) : _Bit_type(0);
+    if (__first._M_p == __last._M_p)
+      {
+	__bvector_put(__first._M_p, __first._M_offset,
+			   __last._M_offset - __first._M_offset, __w);
+	return;
+      }
+    __bvector_put(__first._M_p, __first._M_offset,
+		       _S_word_bit - __first._M_offset, __w);
+    std::memset(__first._M_p + 1, __x ? 0xff : 0,
+		(__last._M_p - __first._M_p - 1) * sizeof(_Bit_type));
+    if (__last._M_offset)
+      __bvector_put(__last._M_p, 0, __last._M_offset, __w);
+  }
+
+  // Like the generic copy, safe for overlapping ranges as long as
+  // __result is not inside [__first, __last).
+  inline _Bit_iterator
+  __bvector_copy(const _Bit_iterator_base& __first,
+		 const _Bit_iterator_base& __last, _Bit_iterator __result)
+  {
+    ptrdiff_t __n = __last - __first;
+    if (__n <= 0)
+      return __result;
+    _Bit_type* __sp = __first._M_p;
+    unsigned int __so = __first._M_offset;
+    _Bit_type* __dp = __result._M_p;
+    unsigned int __do = __result._M_offset;
+
+    // Bring the destination to a word boundary...
+    if (__do)
+      {
+	const unsigned int __k = std::min(__n, ptrdiff_t(_S_word_bit - __do));
+	__bvector_put(__dp, __do, __k, __bvector_get(__sp, __so, __k));
+	__bvector_advance(__sp, __so, __k);
+	__bvector_advance(__dp, __do, __k);
+	__n -= __k;
+      }
+    // ...then store whole words.
+    const ptrdiff_t __words = __n / _S_word_bit;
+    if (__so == 0)
+      {
+	std::memmove(__dp, __sp, __words * sizeof(_Bit_type));
+	__sp += __words;
+	__dp += __words;
+      }
+    else
+      for (ptrdiff_t __i = 0; __i < __words; ++__i, ++__sp)
+	*__dp++ = (__sp[0] >> __so) | (__sp[1] << (_S_word_bit - __so));
+    __n -= __words * _S_word_bit;
+    if (__n)
+      {
+	__bvector_put(__dp, 0, __n, __bvector_get(__sp, __so, __n));
+	__do = __n;
+      }
+    return _Bit_iterator(__dp, __do);
+  }
+
+  inline _Bit_iterator
+  copy(_Bit_iterator __first, _Bit_iterator __last, _Bit_iterator __result)
+  { return __bvector_copy(__first, __last, __result); }
+
+  inline _Bit_iterator
+  copy(_Bit_const_iterator __first, _Bit_const_iterator __last,
+       _Bit_iterator __result)
+  { return __bvector_copy(__first, __last, __result); }
+
+  inline bool
+  __bvector_equal(const _Bit_iterator_base& __first1,
+		  const _Bit_iterator_base& __last1,
+		  const _Bit_iterator_base& __first2)
+  {
+    ptrdiff_t __n = __last1 - __first1;
+    _Bit_type* __p1 = __first1._M_p;
+    unsigned int __o1 = __first1._M_offset;
+    _Bit_type* __p2 = __first2._M_p;
+    unsigned int __o2 = __first2._M_offset;
+    while (__n > 0)
+      {
+	const unsigned int __k = std::min(__n, ptrdiff_t(_S_word_bit));
+	if (__bvector_get(__p1, __o1, __k)
+	    != __bvector_get(__p2, __o2, __k))
+	  return false;
+	__bvector_advance(__p1, __o1, __k);
+	__bvector_advance(__p2, __o2, __k);
+	__n -= __k;
+      }
+    return true;
+  }
+
+  inline bool
+  equal(_Bit_iterator __first1, _Bit_iterator __last1,
+	_Bit_iterator __first2)
+  { return __bvector_equal(__first1, __last1, __first2); }
+
+  inline bool
+  equal(_Bit_iterator __first1, _Bit_iterator __last1,
+	_Bit_const_iterator __first2)
+  { return __bvector_equal(__first1, __last1, __first2); }
+
+  inline bool
+  equal(_Bit_const_iterator __first1, _Bit_const_iterator __last1,
+	_Bit_iterator __first2)
+  { return __bvector_equal(__first1, __last1, __first2); }
+
+  inline bool
+  equal(_Bit_const_iterator __first1, _Bit_const_iterator __last1,
+	_Bit_const_iterator __first2)
+  { return __bvector_equal(__first1, __last1, __first2); }
+
   template<class _Alloc>
     class _Bvector_base
     {
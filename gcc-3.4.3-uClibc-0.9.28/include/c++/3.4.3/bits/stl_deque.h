@@ -65,6 +65,55 @@
 #include <bits/stl_iterator_base_types.h>
 #include <bits/stl_iterator_base_funcs.h>
 
+// Target size in bytes of a deque node.
+#ifndef _GLIBCXX_DEQUE_BUF_SIZE
+# define _GLIBCXX_DEQUE_BUF_SIZE 512
+#endif
+
+// Minimum number of elements in a deque node, however large they are.
+#ifndef _GLIBCXX_DEQUE_BUF_MIN
+# define _GLIBCXX_DEQUE_BUF_MIN 8
+#endif
+
+namespace std
+{
+  /**
+   *  @brief  Node size policy for std::deque.
+   *
+   *  _S_buffer_size() is the number of elements in each node that a
+   *  deque<_Tp> allocates: _GLIBCXX_DEQUE_BUF_SIZE bytes' worth, but
+   *  never fewer than _GLIBCXX_DEQUE_BUF_MIN elements.  Both macros
+   *  may be defined before the first include of <deque>; a single
+   *  element type can be tuned by specializing this template:
+   *
+   *  @code
+   *    namespace std
+   *    {
+   *      template<>
+   *        struct __deque_buf_traits<frame_desc>
+   *        {
+   *          static size_t
+   *          _S_buffer_size() { return 16; }
+   *        };
+   *    }
+   *  @endcode
+   *
+   *  All translation units that share a deque must agree on its node
+   *  size.
+  */
+  template<typename _Tp>
+    struct __deque_buf_traits
+    {
+      static size_t
+      _S_buffer_size()
+      {
+	return sizeof(_Tp) < _GLIBCXX_DEQUE_BUF_SIZE / _GLIBCXX_DEQUE_BUF_MIN
+	       ? size_t(_GLIBCXX_DEQUE_BUF_SIZE / sizeof(_Tp))
+	       : size_t(_GLIBCXX_DEQUE_BUF_MIN);
+      }
+    };
+} // namespace std
+
 namespace _GLIBCXX_STD
 {
   /**
@@ -73,15 +122,18 @@ namespace _GLIBCXX_STD
    *  @param  size  The size of an element.
    *  @return   The number (not byte size) of elements per node.
    *
-   *  This function started off as a compiler kludge from SGI, but seems to
-   *  be a useful wrapper around a repeated constant expression.  The '512' is
-   *  tuneable (and no other code needs to change), but no investigation has
-   *  been done since inheriting the SGI code.
+   *  The default policy of __deque_buf_traits, for callers that only
+   *  have a size.  deque itself goes through __deque_buf_traits so
+   *  that the size can be specialized per type.
    *  @endif
   */
   inline size_t
   __deque_buf_size(size_t __size)
-  { return __size < 512 ? size_t(512 / __size) : size_t(1); }
+  {
+    return __size < _GLIBCXX_DEQUE_BUF_SIZE / _GLIBCXX_DEQUE_BUF_MIN
+           ? size_t(_GLIBCXX_DEQUE_BUF_SIZE / __size)
+           : size_t(_GLIBCXX_DEQUE_BUF_MIN);
+  }
 
 
   /**
@@ -103,7 +155,7 @@ namespace _GLIBCXX_STD
       typedef _Deque_iterator<_Tp, const _Tp&, const _Tp*> const_iterator;
 
       static size_t _S_buffer_size()
-      { return __deque_buf_size(sizeof(_Tp)); }
+      { return std::__deque_buf_traits<_Tp>::_S_buffer_size(); }
 
       typedef random_access_iterator_tag iterator_category;
       typedef _Tp                        value_type;
@@ -337,6 +389,41 @@ namespace _GLIBCXX_STD
     operator+(ptrdiff_t __n, const _Deque_iterator<_Tp, _Ref, _Ptr>& __x)
     { return __x + __n; }
 
+  // copy and copy_backward between deque iterators work a node-sized
+  // segment at a time, so each segment goes through the pointer
+  // overloads and is moved with memmove when the elements allow it.
+  template<typename _Tp>
+    _Deque_iterator<_Tp, _Tp&, _Tp*>
+    copy(_Deque_iterator<_Tp, const _Tp&, const _Tp*>,
+	 _Deque_iterator<_Tp, const _Tp&, const _Tp*>,
+	 _Deque_iterator<_Tp, _Tp&, _Tp*>);
+
+  template<typename _Tp>
+    inline _Deque_iterator<_Tp, _Tp&, _Tp*>
+    copy(_Deque_iterator<_Tp, _Tp&, _Tp*> __first,
+	 _Deque_iterator<_Tp, _Tp&, _Tp*> __last,
+	 _Deque_iterator<_Tp, _Tp&, _Tp*> __result)
+    { return std::copy(_Deque_iterator<_Tp, const _Tp&, const _Tp*>(__first),
+		       _Deque_iterator<_Tp, const _Tp&, const _Tp*>(__last),
+		       __result); }
+
+  template<typename _Tp>
+    _Deque_iterator<_Tp, _Tp&, _Tp*>
+    copy_backward(_Deque_iterator<_Tp, const _Tp&, const _Tp*>,
+		  _Deque_iterator<_Tp, const _Tp&, const _Tp*>,
+		  _Deque_iterator<_Tp, _Tp&, _Tp*>);
+
+  template<typename _Tp>
+    inline _Deque_iterator<_Tp, _Tp&, _Tp*>
+    copy_backward(_Deque_iterator<_Tp, _Tp&, _Tp*> __first,
+		  _Deque_iterator<_Tp, _Tp&, _Tp*> __last,
+		  _Deque_iterator<_Tp, _Tp&, _Tp*> __result)
+    { return std::copy_backward(_Deque_iterator<_Tp,
+				const _Tp&, const _Tp*>(__first),
+				_Deque_iterator<_Tp,
+				const _Tp&, const _Tp*>(__last),
+				__result); }
+
   /**
    *  @if maint
    *  Deque base class.  This class provides the unified face for %deque's
@@ -394,11 +481,17 @@ namespace _GLIBCXX_STD
 
       _Tp*
       _M_allocate_node()
-      { return _M_impl._Alloc::allocate(__deque_buf_size(sizeof(_Tp))); }
+      {
+	return _M_impl._Alloc::allocate(std::__deque_buf_traits<_Tp>::
+					_S_buffer_size());
+      }
 
       void
       _M_deallocate_node(_Tp* __p)
-      { _M_impl._Alloc::deallocate(__p, __deque_buf_size(sizeof(_Tp))); }
+      {
+	_M_impl._Alloc::deallocate(__p, std::__deque_buf_traits<_Tp>::
+				   _S_buffer_size());
+      }
 
       _Tp**
       _M_allocate_map(size_t __n)
@@ -441,7 +534,8 @@ namespace _GLIBCXX_STD
     void
     _Deque_base<_Tp,_Alloc>::_M_initialize_map(size_t __num_elements)
     {
-      size_t __num_nodes = __num_elements / __deque_buf_size(sizeof(_Tp)) + 1;
+      const size_t __buf_size = std::__deque_buf_traits<_Tp>::_S_buffer_size();
+      size_t __num_nodes = __num_elements / __buf_size + 1;
 
       this->_M_impl._M_map_size = std::max((size_t) _S_initial_map_size,
 				   __num_nodes + 2);
@@ -469,7 +563,7 @@ namespace _GLIBCXX_STD
       this->_M_impl._M_finish._M_set_node(__nfinish - 1);
       this->_M_impl._M_start._M_cur = _M_impl._M_start._M_first;
       this->_M_impl._M_finish._M_cur = this->_M_impl._M_finish._M_first + __num_elements
-	                 % __deque_buf_size(sizeof(_Tp));
+	                 % __buf_size;
     }
 
   template<typename _Tp, typename _Alloc>
@@ -607,7 +701,7 @@ namespace _GLIBCXX_STD
       typedef pointer*                           _Map_pointer;
 
       static size_t _S_buffer_size()
-      { return __deque_buf_size(sizeof(_Tp)); }
+      { return std::__deque_buf_traits<_Tp>::_S_buffer_size(); }
 
       // Functions controlling memory layout, and nothing else.
       using _Base::_M_initialize_map;
@@ -396,6 +396,23 @@ namespace _GLIBCXX_STD
         insert(_InputIterator __first, _InputIterator __last)
         { _M_t.insert_unique(__first, __last); }
 
+      /**
+       *  @brief Replaces the contents of the %map with a range.
+       *  @param  first  Iterator pointing to the start of the range.
+       *  @param  last  Iterator pointing to the end of the range.
+       *
+       *  A GNU extension.  While the range is sorted, its elements go
+       *  into the nodes the %map already has and the tree is built in
+       *  linear time, with only the difference in size allocated or
+       *  freed.  Any unsorted tail is inserted one element at a time.
+       *  Of equal keys, only the first is kept.
+       *  The range must not point into the %map itself.
+       */
+      template <typename _InputIterator>
+        void
+        assign(_InputIterator __first, _InputIterator __last)
+        { _M_t._M_assign_unique(__first, __last); }
+
       /**
        *  @brief Erases an element from a %map.
        *  @param  position  An iterator pointing to the element to be erased.
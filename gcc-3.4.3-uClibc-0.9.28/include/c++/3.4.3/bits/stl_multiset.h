@@ -345,6 +345,23 @@ namespace _GLIBCXX_STD
         insert(_InputIterator __first, _InputIterator __last)
         { _M_t.insert_equal(__first, __last); }
 
+      /**
+       *  @brief Replaces the contents of the %multiset with a range.
+       *  @param  first  Iterator pointing to the start of the range.
+       *  @param  last  Iterator pointing to the end of the range.
+       *
+       *  A GNU extension.  While the range is sorted, its elements go
+       *  into the nodes the %multiset already has and the tree is built in
+       *  linear time, with only the difference in size allocated or
+       *  freed.  Any unsorted tail is inserted one element at a time.
+       *  Equal keys keep their order in the range.
+       *  The range must not point into the %multiset itself.
+       */
+      template <class _InputIterator>
+        void
+        assign(_InputIterator __first, _InputIterator __last)
+        { _M_t._M_assign_equal(__first, __last); }
+
       /**
        *  @brief Erases an element from a %multiset.
        *  @param  position  An iterator pointing to the element to be erased.
@@ -388,6 +388,49 @@ namespace std
 	_M_put_node(__p);
       }
 
+      // Recycled nodes are kept on a list linked through _M_right, with
+      // their old values still constructed.  Take one from __free if
+      // there is one, otherwise allocate.
+      _Link_type
+      _M_reuse_or_create_node(_Link_type& __free, const value_type& __x)
+      {
+	if (__free == 0)
+	  return _M_create_node(__x);
+	_Link_type __tmp = __free;
+	__free = static_cast<_Link_type>(__tmp->_M_right);
+	std::_Destroy(&__tmp->_M_value_field);
+	try
+	  { std::_Construct(&__tmp->_M_value_field, __x); }
+	catch(...)
+	  {
+	    _M_put_node(__tmp);
+	    __throw_exception_again;
+	  }
+	return __tmp;
+      }
+
+      _Link_type
+      _M_clone_node(_Const_Link_type __x, _Link_type& __free)
+      {
+	_Link_type __tmp = _M_reuse_or_create_node(__free,
+						   __x->_M_value_field);
+	__tmp->_M_color = __x->_M_color;
+	__tmp->_M_left = 0;
+	__tmp->_M_right = 0;
+	return __tmp;
+      }
+
+      void
+      _M_put_nodes(_Link_type __free)
+      {
+	while (__free != 0)
+	  {
+	    _Link_type __next = static_cast<_Link_type>(__free->_M_right);
+	    destroy_node(__free);
+	    __free = __next;
+	  }
+      }
+
     protected:
       template<typename _Key_compare, 
 	       bool _Is_pod_comparator = std::__is_pod<_Key_compare>::_M_type>
@@ -531,11 +574,32 @@ namespace std
       _M_insert(_Base_ptr __x, _Base_ptr __y, const value_type& __v);
 
       _Link_type
-      _M_copy(_Const_Link_type __x, _Link_type __p);
+      _M_copy(_Const_Link_type __x, _Link_type __p)
+      {
+	_Link_type __free = 0;
+	return _M_copy(__x, __p, __free);
+      }
+
+      _Link_type
+      _M_copy(_Const_Link_type __x, _Link_type __p, _Link_type& __free);
 
       void
       _M_erase(_Link_type __x);
 
+      // Empties the tree without freeing anything and returns its nodes
+      // as a recycling list for _M_reuse_or_create_node.
+      _Link_type
+      _M_detach_nodes();
+
+      _Link_type
+      _M_build_balanced(_Link_type& __list, size_type __n,
+			size_type __depth, size_type __red_depth);
+
+      template<typename _InputIterator>
+        void
+        _M_assign_sorted(_InputIterator __first, _InputIterator __last,
+			 bool __unique);
+
     public:
       // allocation/deallocation
       _Rb_tree()
@@ -640,6 +704,20 @@ namespace std
       void
       insert_equal(_InputIterator __first, _InputIterator __last);
 
+      // Replace the contents with [first,last), reusing the existing
+      // nodes.  A sorted range is built into a balanced tree in linear
+      // time without any rebalancing; an unsorted tail falls back to
+      // ordinary insertion.
+      template<typename _InputIterator>
+        void
+        _M_assign_unique(_InputIterator __first, _InputIterator __last)
+        { _M_assign_sorted(__first, __last, true); }
+
+      template<typename _InputIterator>
+        void
+        _M_assign_equal(_InputIterator __first, _InputIterator __last)
+        { _M_assign_sorted(__first, __last, false); }
+
       void
       erase(iterator __position);
 
@@ -758,16 +836,24 @@ namespace std
     {
       if (this != &__x)
 	{
-	  // Note that _Key may be a constant type.
-	  clear();
+	  // Note that _Key may be a constant type, so nodes are recycled
+	  // by destroying and reconstructing their values, not assigning.
+	  _Link_type __free = _M_detach_nodes();
 	  _M_impl._M_key_compare = __x._M_impl._M_key_compare;
 	  if (__x._M_root() != 0)
 	    {
-	      _M_root() = _M_copy(__x._M_begin(), _M_end());
+	      try
+		{ _M_root() = _M_copy(__x._M_begin(), _M_end(), __free); }
+	      catch(...)
+		{
+		  _M_put_nodes(__free);
+		  __throw_exception_again;
+		}
 	      _M_leftmost() = _S_minimum(_M_root());
 	      _M_rightmost() = _S_maximum(_M_root());
 	      _M_impl._M_node_count = __x._M_impl._M_node_count;
 	    }
+	  _M_put_nodes(__free);
 	}
       return *this;
     }
@@ -979,8 +1065,11 @@ namespace std
       _Rb_tree<_Key,_Val,_KoV,_Cmp,_Alloc>::
       insert_equal(_II __first, _II __last)
       {
-	for ( ; __first != __last; ++__first)
-	  insert_equal(*__first);
+	if (_M_impl._M_node_count == 0)
+	  _M_assign_sorted(__first, __last, false);
+	else
+	  for ( ; __first != __last; ++__first)
+	    insert_equal(end(), *__first);
       }
 
   template<typename _Key, typename _Val, typename _KoV,
@@ -990,8 +1079,11 @@ namespace std
     _Rb_tree<_Key,_Val,_KoV,_Cmp,_Alloc>::
     insert_unique(_II __first, _II __last)
     {
-      for ( ; __first != __last; ++__first)
-	insert_unique(*__first);
+      if (_M_impl._M_node_count == 0)
+	_M_assign_sorted(__first, __last, true);
+      else
+	for ( ; __first != __last; ++__first)
+	  insert_unique(end(), *__first);
     }
 
   template<typename _Key, typename _Val, typename _KeyOfValue,
@@ -1021,26 +1113,26 @@ namespace std
            typename _Compare, typename _Alloc>
     typename _Rb_tree<_Key, _Val, _KoV, _Compare, _Alloc>::_Link_type
     _Rb_tree<_Key,_Val,_KoV,_Compare,_Alloc>::
-    _M_copy(_Const_Link_type __x, _Link_type __p)
+    _M_copy(_Const_Link_type __x, _Link_type __p, _Link_type& __free)
     {
       // Structural copy.  __x and __p must be non-null.
-      _Link_type __top = _M_clone_node(__x);
+      _Link_type __top = _M_clone_node(__x, __free);
       __top->_M_parent = __p;
 
       try
 	{
 	  if (__x->_M_right)
-	    __top->_M_right = _M_copy(_S_right(__x), __top);
+	    __top->_M_right = _M_copy(_S_right(__x), __top, __free);
 	  __p = __top;
 	  __x = _S_left(__x);
 
 	  while (__x != 0)
 	    {
-	      _Link_type __y = _M_clone_node(__x);
+	      _Link_type __y = _M_clone_node(__x, __free);
 	      __p->_M_left = __y;
 	      __y->_M_parent = __p;
 	      if (__x->_M_right)
-		__y->_M_right = _M_copy(_S_right(__x), __y);
+		__y->_M_right = _M_copy(_S_right(__x), __y, __free);
 	      __p = __y;
 	      __x = _S_left(__x);
 	    }
@@ -1068,6 +1160,140 @@ namespace std
 	}
     }
 
+  template<typename _Key, typename _Val, typename _KeyOfValue,
+           typename _Compare, typename _Alloc>
+    typename _Rb_tree<_Key,_Val,_KeyOfValue,_Compare,_Alloc>::_Link_type
+    _Rb_tree<_Key,_Val,_KeyOfValue,_Compare,_Alloc>::_M_detach_nodes()
+    {
+      _Link_type __free = 0;
+      _Link_type __x = _M_begin();
+      while (__x != 0)
+	{
+	  // Flatten by rotating left children up; no stack needed.
+	  if (__x->_M_left != 0)
+	    {
+	      _Link_type __l = _S_left(__x);
+	      __x->_M_left = __l->_M_right;
+	      __l->_M_right = __x;
+	      __x = __l;
+	    }
+	  else
+	    {
+	      _Link_type __next = _S_right(__x);
+	      __x->_M_right = __free;
+	      __free = __x;
+	      __x = __next;
+	    }
+	}
+      _M_leftmost() = _M_end();
+      _M_root() = 0;
+      _M_rightmost() = _M_end();
+      _M_impl._M_node_count = 0;
+      return __free;
+    }
+
+  template<typename _Key, typename _Val, typename _KeyOfValue,
+           typename _Compare, typename _Alloc>
+    typename _Rb_tree<_Key,_Val,_KeyOfValue,_Compare,_Alloc>::_Link_type
+    _Rb_tree<_Key,_Val,_KeyOfValue,_Compare,_Alloc>::
+    _M_build_balanced(_Link_type& __list, size_type __n,
+		      size_type __depth, size_type __red_depth)
+    {
+      // Takes the first __n nodes of the in-order __list.  Halving at
+      // the middle leaves every null link on the last two levels, so
+      // colouring just the deepest level red (when it is not full)
+      // gives a valid red-black tree.
+      if (__n == 0)
+	return 0;
+      const size_type __nl = (__n - 1) / 2;
+      _Link_type __left = _M_build_balanced(__list, __nl, __depth + 1,
+					    __red_depth);
+      _Link_type __top = __list;
+      __list = _S_right(__list);
+      __top->_M_left = __left;
+      if (__left)
+	__left->_M_parent = __top;
+      _Link_type __right = _M_build_balanced(__list, __n - 1 - __nl,
+					     __depth + 1, __red_depth);
+      __top->_M_right = __right;
+      if (__right)
+	__right->_M_parent = __top;
+      __top->_M_color = __depth == __red_depth ? _S_red : _S_black;
+      return __top;
+    }
+
+  template<typename _Key, typename _Val, typename _KeyOfValue,
+           typename _Compare, typename _Alloc>
+    template<typename _InputIterator>
+      void
+      _Rb_tree<_Key,_Val,_KeyOfValue,_Compare,_Alloc>::
+      _M_assign_sorted(_InputIterator __first, _InputIterator __last,
+		       bool __unique)
+      {
+	_Link_type __free = _M_detach_nodes();
+	_Link_type __head = 0;
+	_Link_type __tail = 0;
+	size_type __n = 0;
+
+	// Collect the leading sorted run as an in-order list.
+	try
+	  {
+	    for (; __first != __last; ++__first)
+	      {
+		// The key is taken from the node, since *__first may only
+		// convert to value_type.  The node waits on the free list
+		// until it is known to extend the run.
+		_Link_type __z = _M_reuse_or_create_node(__free, *__first);
+		__z->_M_right = __free;
+		__free = __z;
+		if (__tail)
+		  {
+		    if (_M_impl._M_key_compare(_S_key(__z), _S_key(__tail)))
+		      break;
+		    if (__unique
+			&& !_M_impl._M_key_compare(_S_key(__tail), _S_key(__z)))
+		      continue;
+		  }
+		__free = static_cast<_Link_type>(__z->_M_right);
+		__z->_M_right = 0;
+		if (__tail)
+		  __tail->_M_right = __z;
+		else
+		  __head = __z;
+		__tail = __z;
+		++__n;
+	      }
+	  }
+	catch(...)
+	  {
+	    _M_put_nodes(__head);
+	    _M_put_nodes(__free);
+	    __throw_exception_again;
+	  }
+	_M_put_nodes(__free);
+
+	if (__n != 0)
+	  {
+	    size_type __h = 0;
+	    for (size_type __m = __n; __m > 1; __m >>= 1)
+	      ++__h;
+	    // A perfect tree (n == 2^k - 1) is all black.
+	    const size_type __red = (__n & (__n + 1)) ? __h : size_type(-1);
+	    _Link_type __list = __head;
+	    _M_root() = _M_build_balanced(__list, __n, 0, __red);
+	    _M_root()->_M_parent = _M_end();
+	    _M_leftmost() = __head;
+	    _M_rightmost() = __tail;
+	    _M_impl._M_node_count = __n;
+	  }
+
+	for (; __first != __last; ++__first)
+	  if (__unique)
+	    insert_unique(*__first);
+	  else
+	    insert_equal(*__first);
+      }
+
   template<typename _Key, typename _Val, typename _KeyOfValue,
            typename _Compare, typename _Alloc>
     void
@@ -108,7 +108,7 @@ namespace std
 		       _ForwardIterator __result)
     {
       typedef typename iterator_traits<_ForwardIterator>::value_type _ValueType;
-      typedef typename __type_traits<_ValueType>::is_POD_type _Is_POD;
+      typedef typename __bitwise_copyable<_ValueType>::_Type _Is_POD;
       return std::__uninitialized_copy_aux(__first, __last, __result,
 					   _Is_POD());
     }
@@ -129,7 +129,7 @@ namespace std
   }
 
   // Valid if copy construction is equivalent to assignment, and if the
-  // destructor is trivial.
+  // destructor is trivial, i.e. for __bitwise_copyable types.
   template<typename _ForwardIterator, typename _Tp>
     inline void
     __uninitialized_fill_aux(_ForwardIterator __first,
@@ -170,7 +170,7 @@ namespace std
 		       const _Tp& __x)
     {
       typedef typename iterator_traits<_ForwardIterator>::value_type _ValueType;
-      typedef typename __type_traits<_ValueType>::is_POD_type _Is_POD;
+      typedef typename __bitwise_copyable<_ValueType>::_Type _Is_POD;
       std::__uninitialized_fill_aux(__first, __last, __x, _Is_POD());
     }
 
@@ -215,7 +215,7 @@ namespace std
     uninitialized_fill_n(_ForwardIterator __first, _Size __n, const _Tp& __x)
     {
       typedef typename iterator_traits<_ForwardIterator>::value_type _ValueType;
-      typedef typename __type_traits<_ValueType>::is_POD_type _Is_POD;
+      typedef typename __bitwise_copyable<_ValueType>::_Type _Is_POD;
       return std::__uninitialized_fill_n_aux(__first, __n, __x, _Is_POD());
     }
 
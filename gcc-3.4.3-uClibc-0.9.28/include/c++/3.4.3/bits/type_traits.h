@@ -291,6 +291,39 @@ template <class _Tp>
     typedef __true_type    is_POD_type;
   };
 
+// __bitwise_copyable<_Tp>::_Type is __true_type when objects of type
+// _Tp can be copy constructed, assigned and relocated by copying their
+// bytes, and need no destruction.  uninitialized_copy, uninitialized_fill,
+// copy and copy_backward use it to decide whether a pointer range can be
+// handled with memmove, which is what vector and deque growth end up in.
+// It defaults to is_POD_type, so only scalars qualify unless told
+// otherwise; specialize it (at global scope) for trivially copyable
+// structs:
+//
+//   struct packet_desc { unsigned addr; unsigned short len, flags; };
+//   _GLIBCXX_BITWISE_COPYABLE(packet_desc);
+
+template<typename _Tp>
+  struct __bitwise_copyable
+  {
+    typedef typename __type_traits<_Tp>::is_POD_type _Type;
+  };
+
+#define _GLIBCXX_BITWISE_COPYABLE(_Tp) \
+  template<> struct __bitwise_copyable<_Tp> { typedef __true_type _Type; }
+
+template<typename _Tp1, typename _Tp2>
+  struct __type_or
+  {
+    typedef __true_type _Type;
+  };
+
+template<>
+  struct __type_or<__false_type, __false_type>
+  {
+    typedef __false_type _Type;
+  };
+
 // The following could be written in terms of numeric_limits.
 // We're doing it separately to reduce the number of dependencies.
 
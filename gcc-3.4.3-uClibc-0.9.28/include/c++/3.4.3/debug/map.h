@@ -167,6 +167,15 @@ namespace __gnu_debug_def
 	  _Base::insert(__first, __last);
 	}
 
+      template<typename _InputIterator>
+        void
+        assign(_InputIterator __first, _InputIterator __last)
+        {
+	  __glibcxx_check_valid_range(__first, __last);
+	  _Base::assign(__first, __last);
+	  this->_M_invalidate_all();
+	}
+
       void
       erase(iterator __position)
       {
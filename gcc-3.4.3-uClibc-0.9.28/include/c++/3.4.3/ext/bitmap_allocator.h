@@ -43,9 +43,9 @@
 //size of the vector should be  not more than the number of bits in an
 //integer or an unsigned integer.
 #include <functional>
-//For greater_equal, and less_equal.
+//For greater_equal, less_equal, and less.
 #include <new>
-//For operator new.
+//For operator new, and nothrow.
 #include <bits/gthr.h>
 //For __gthread_mutex_t, __gthread_mutex_lock and __gthread_mutex_unlock.
 #include <ext/new_allocator.h>
@@ -162,6 +162,22 @@ namespace __gnu_cxx
       }
     };
   
+    //Orders an address before the blocks that start above it. Used
+    //to binary search the address-ordered vector of blocks, so that
+    //upper_bound() minus one is the only block that can hold the
+    //address.
+    template <typename _Tp>
+    class _Block_start_less {
+      typedef _Tp pointer;
+      typedef typename std::pair<_Tp, _Tp> _Block_pair;
+
+    public:
+      bool operator () (pointer __ptr, _Block_pair const& __bp) const throw ()
+      {
+	return std::less<pointer> ()(__ptr, __bp.first);
+      }
+    };
+
     //Used to pass a Functor to functions by reference.
     template <typename _Functor>
     class _Functor_Ref : 
@@ -547,12 +563,15 @@ namespace __gnu_cxx
 #endif
 
 
-    //Complexity: O(1), but internally depends upon the complexity of
-    //the function _BA_free_list_store::_S_get_free_list. The part
-    //where the bitmap headers are written is of worst case complexity:
-    //O(X),where X is the number of blocks of size sizeof(value_type)
-    //within the newly acquired block. Having a tight bound.
-    static void _S_refill_pool() throw (std::bad_alloc)
+    //Complexity: O(lg(N)) to find the place of the new block in the
+    //address-ordered vector (plus the vector insert), and internally
+    //depends upon the complexity of the function
+    //_BA_free_list_store::_S_get_free_list. The part where the bitmap
+    //headers are written is of worst case complexity: O(X),where X is
+    //the number of blocks of size sizeof(value_type) within the newly
+    //acquired block. Having a tight bound. Returns the index of the
+    //new block in _S_mem_blocks.
+    static typename _BPVector::size_type _S_refill_pool() throw (std::bad_alloc)
     {
 #if defined CHECK_FOR_ERRORS
       _S_check_for_free_blocks();
@@ -572,8 +591,17 @@ namespace __gnu_cxx
 				       reinterpret_cast<pointer>(__temp + __num_bit_maps) 
 					+ _S_block_size - 1);
 
-      //Fill the Vector with this information.
-      _S_mem_blocks.push_back(__bp);
+      //Fill the Vector with this information, keeping it sorted by
+      //address so that deallocation can binary search it. The index
+      //of the last deallocation moves up if the block goes before it.
+      typename _BPVector::iterator __iter = 
+	std::upper_bound(_S_mem_blocks.begin(), _S_mem_blocks.end(), __bp.first, 
+			 __gnu_cxx::__aux_balloc::_Block_start_less<pointer>());
+      typename _BPVector::size_type __index = __iter - _S_mem_blocks.begin();
+      _S_mem_blocks.insert(__iter, __bp);
+      if (_S_mem_blocks.size() > 1 && __index <= _S_last_dealloc_index)
+	++_S_last_dealloc_index;
+      _S_free_count += _S_block_size;
 
       unsigned int __bit_mask = 0; //0 Indicates all Allocated.
       __bit_mask = ~__bit_mask; //1 Indicates all Free.
@@ -585,12 +613,29 @@ namespace __gnu_cxx
       //malloc might fail if the size passed is too large, therefore, we
       //limit the size passed to malloc or operator new.
       _S_block_size *= 2;
+      return __index;
+    }
+
+    //Complexity: O(lg(N)), where N is the number of blocks in
+    //_S_mem_blocks. Returns the index of the block holding __p.
+    static typename _BPVector::size_type _S_find_block(pointer __p) throw()
+    {
+      typedef typename _BPVector::iterator _Iterator;
+      _Iterator __iter = 
+	std::upper_bound(_S_mem_blocks.begin(), _S_mem_blocks.end(), __p, 
+			 __gnu_cxx::__aux_balloc::_Block_start_less<pointer>());
+      assert(__iter != _S_mem_blocks.begin());
+      --__iter;
+      assert(__gnu_cxx::__aux_balloc::_Inclusive_between<pointer>(__p)(*__iter));
+      return __iter - _S_mem_blocks.begin();
     }
 
     static _BPVector _S_mem_blocks;
     static unsigned int _S_block_size;
     static __gnu_cxx::__aux_balloc::_Bit_map_counter<pointer, _BPVec_allocator_type> _S_last_request;
     static typename _BPVector::size_type _S_last_dealloc_index;
+    //Number of free objects in all the blocks of _S_mem_blocks.
+    static size_type _S_free_count;
 #if defined __GTHREADS
     static _Mutex _S_mut;
 #endif
@@ -600,13 +645,11 @@ namespace __gnu_cxx
     //cases are guaranteed to have a worst case complexity of O(1)!
     //That's why this function performs very well on the average. you
     //can consider this function to be having a complexity refrred to
-    //commonly as: Amortized Constant time.
-    static pointer _S_allocate_single_object()
+    //commonly as: Amortized Constant time. When no block has a free
+    //object at all, the First Fit search is skipped altogether.
+    //The caller must hold _S_mut.
+    static pointer _S_allocate_from_pool()
     {
-#if defined __GTHREADS
-      _Lock __bit_lock(&_S_mut);
-#endif
-
       //The algorithm is something like this: The last_requst variable
       //points to the last accessed Bit Map. When such a condition
       //occurs, we try to find a free block in the current bitmap, or
@@ -630,8 +673,10 @@ namespace __gnu_cxx
 	  typedef typename __gnu_cxx::__aux_balloc::_Ffit_finder<pointer, _BPVec_allocator_type> _FFF;
 	  _FFF __fff;
 	  typedef typename _BPVector::iterator _BPiter;
-	  _BPiter __bpi = std::find_if(_S_mem_blocks.begin(), _S_mem_blocks.end(), 
-				      __gnu_cxx::__aux_balloc::_Functor_Ref<_FFF>(__fff));
+	  _BPiter __bpi = _S_mem_blocks.end();
+	  if (_S_free_count)
+	    __bpi = std::find_if(_S_mem_blocks.begin(), _S_mem_blocks.end(), 
+				 __gnu_cxx::__aux_balloc::_Functor_Ref<_FFF>(__fff));
 
 	  if (__bpi != _S_mem_blocks.end())
 	    {
@@ -648,17 +693,16 @@ namespace __gnu_cxx
 	      unsigned int *__puse_count = reinterpret_cast<unsigned int*>(__bpi->first) - 
 		(__gnu_cxx::__aux_balloc::__balloc_num_bit_maps(*__bpi) + 1);
 	      ++(*__puse_count);
+	      --_S_free_count;
 	      return __ret_val;
 	    }
 	  else
 	    {
 	      //Search was unsuccessful. We Add more memory to the pool
 	      //by calling _S_refill_pool().
-	      _S_refill_pool();
-
 	      //_M_Reset the _S_last_request structure to the first free
 	      //block's bit map.
-	      _S_last_request._M_reset(_S_mem_blocks.size() - 1);
+	      _S_last_request._M_reset(_S_refill_pool());
 
 	      //Now, mark that bit as allocated.
 	    }
@@ -674,18 +718,16 @@ namespace __gnu_cxx
 	(_S_mem_blocks[_S_last_request._M_where()].first) - 
 	(__gnu_cxx::__aux_balloc::__balloc_num_bit_maps(_S_mem_blocks[_S_last_request._M_where()]) + 1);
       ++(*__puse_count);
+      --_S_free_count;
       return __ret_val;
     }
 
-    //Complexity: O(lg(N)), but the worst case is hit quite often! I
-    //need to do something about this. I'll be able to work on it, only
-    //when I have some solid figures from a few real apps.
-    static void _S_deallocate_single_object(pointer __p) throw()
+    //Complexity: O(1) if __p is in the same block as the previous
+    //deallocation, otherwise O(lg(N)): _S_mem_blocks is kept sorted
+    //by address, so the block is found by binary search. The caller
+    //must hold _S_mut.
+    static void _S_deallocate_to_pool(pointer __p) throw()
     {
-#if defined __GTHREADS
-      _Lock __bit_lock(&_S_mut);
-#endif
-
       typedef typename _BPVector::iterator _Iterator;
       typedef typename _BPVector::difference_type _Difference_type;
 
@@ -704,11 +746,7 @@ namespace __gnu_cxx
 	}
       else
 	{
-	  _Iterator _iter = (std::find_if(_S_mem_blocks.begin(), _S_mem_blocks.end(), 
-					  __gnu_cxx::__aux_balloc::_Inclusive_between<pointer>(__p)));
-	  assert(_iter != _S_mem_blocks.end());
-
-	  __diff = _iter - _S_mem_blocks.begin();
+	  __diff = _S_find_block(__p);
 	  __displacement = __p - _S_mem_blocks[__diff].first;
 	  _S_last_dealloc_index = __diff;
 	}
@@ -726,6 +764,7 @@ namespace __gnu_cxx
       assert(*__puse_count != 0);
 
       --(*__puse_count);
+      ++_S_free_count;
 
       if (__builtin_expect(*__puse_count == 0, false))
 	{
@@ -733,6 +772,7 @@ namespace __gnu_cxx
 	  
 	  //We may safely remove this block.
 	  _Block_pair __bp = _S_mem_blocks[__diff];
+	  _S_free_count -= __gnu_cxx::__aux_balloc::__balloc_num_blocks(__bp);
 	  _S_insert_free_list(__puse_count);
 	  _S_mem_blocks.erase(_S_mem_blocks.begin() + __diff);
 
@@ -761,6 +801,145 @@ namespace __gnu_cxx
 	}
     }
 
+#if defined __GTHREADS
+    //Each thread keeps a small stack of the objects it freed, chained
+    //through the objects themselves, and serves its allocations from
+    //it without taking _S_mut. The stack is refilled from, and
+    //drained to, the pool _S_cache_batch objects at a time under a
+    //single lock, and returned to the pool when the thread exits.
+    //Objects too small, or too unaligned, to hold the link pointer
+    //are not cached.
+    struct _Thread_cache {
+      void* _M_head;
+      unsigned int _M_count;
+    };
+
+    static const unsigned int _S_cache_max = 64;
+    static const unsigned int _S_cache_batch = 16;
+
+    static __gthread_once_t _S_once;
+    static __gthread_key_t _S_cache_key;
+    static bool _S_cache_init;
+
+    static void _S_initialize()
+    {
+      _S_cache_init = __gthread_key_create(&_S_cache_key, _S_destroy_thread_key) == 0;
+    }
+
+    static void _S_destroy_thread_key(void* __vtc)
+    {
+      _Thread_cache* __tc = static_cast<_Thread_cache*>(__vtc);
+      _Lock __bit_lock(&_S_mut);
+      while (__tc->_M_head)
+	{
+	  void* __next = *static_cast<void**>(__tc->_M_head);
+	  _S_deallocate_to_pool(static_cast<pointer>(__tc->_M_head));
+	  __tc->_M_head = __next;
+	}
+      __bit_lock._M_unlock();
+      operator delete(__tc);
+    }
+
+    static _Thread_cache* _S_get_thread_cache() throw()
+    {
+      if (sizeof(value_type) < sizeof(void*) || sizeof(value_type) % sizeof(void*))
+	return 0;
+
+      __gthread_once(&_S_once, _S_initialize);
+      if (!_S_cache_init)
+	return 0;
+
+      _Thread_cache* __tc = 
+	static_cast<_Thread_cache*>(__gthread_getspecific(_S_cache_key));
+      if (!__tc)
+	{
+	  __tc = static_cast<_Thread_cache*>
+	    (operator new(sizeof(_Thread_cache), std::nothrow));
+	  if (!__tc)
+	    return 0;
+	  __tc->_M_head = 0;
+	  __tc->_M_count = 0;
+	  if (__gthread_setspecific(_S_cache_key, __tc) != 0)
+	    {
+	      operator delete(__tc);
+	      return 0;
+	    }
+	}
+      return __tc;
+    }
+
+    static void _S_cache_push(_Thread_cache* __tc, pointer __p) throw()
+    {
+      *reinterpret_cast<void**>(__p) = __tc->_M_head;
+      __tc->_M_head = __p;
+      ++__tc->_M_count;
+    }
+
+    static pointer _S_cache_pop(_Thread_cache* __tc) throw()
+    {
+      pointer __ret_val = static_cast<pointer>(__tc->_M_head);
+      __tc->_M_head = *reinterpret_cast<void**>(__ret_val);
+      --__tc->_M_count;
+      return __ret_val;
+    }
+#endif
+
+    //Complexity: O(1) from the thread's cache, otherwise that of
+    //_S_allocate_from_pool.
+    static pointer _S_allocate_single_object()
+    {
+#if defined __GTHREADS
+      if (__threads_enabled)
+	{
+	  _Thread_cache* __tc = _S_get_thread_cache();
+	  if (__tc)
+	    {
+	      if (__tc->_M_head)
+		return _S_cache_pop(__tc);
+
+	      //Take a batch while we hold the lock, but only of objects
+	      //that are already free: never grow the pool to fill the
+	      //cache.
+	      _Lock __bit_lock(&_S_mut);
+	      pointer __ret_val = _S_allocate_from_pool();
+	      while (_S_free_count && __tc->_M_count < _S_cache_batch)
+		_S_cache_push(__tc, _S_allocate_from_pool());
+	      return __ret_val;
+	    }
+	}
+      _Lock __bit_lock(&_S_mut);
+#endif
+      return _S_allocate_from_pool();
+    }
+
+    //Complexity: O(1) into the thread's cache, otherwise that of
+    //_S_deallocate_to_pool.
+    static void _S_deallocate_single_object(pointer __p) throw()
+    {
+#if defined __GTHREADS
+      if (__threads_enabled)
+	{
+	  _Thread_cache* __tc = _S_get_thread_cache();
+	  if (__tc)
+	    {
+	      if (__tc->_M_count < _S_cache_max)
+		{
+		  _S_cache_push(__tc, __p);
+		  return;
+		}
+
+	      _Lock __bit_lock(&_S_mut);
+	      _S_deallocate_to_pool(__p);
+	      for (unsigned int __i = 0; __i < _S_cache_batch; ++__i)
+		_S_deallocate_to_pool(_S_cache_pop(__tc));
+	      return;
+	    }
+	}
+      _Lock __bit_lock(&_S_mut);
+#endif
+      _S_deallocate_to_pool(__p);
+    }
+
   public:
     bitmap_allocator() throw()
     { }
@@ -836,10 +1015,26 @@ namespace __gnu_cxx
   <typename bitmap_allocator<_Tp>::pointer, typename bitmap_allocator<_Tp>::_BPVec_allocator_type> 
   bitmap_allocator<_Tp>::_S_last_request(_S_mem_blocks);
 
+  template <typename _Tp>
+  typename bitmap_allocator<_Tp>::size_type
+  bitmap_allocator<_Tp>::_S_free_count = 0;
+
 #if defined __GTHREADS
   template <typename _Tp>
   __gnu_cxx::_Mutex
   bitmap_allocator<_Tp>::_S_mut;
+
+  template <typename _Tp>
+  __gthread_once_t
+  bitmap_allocator<_Tp>::_S_once = __GTHREAD_ONCE_INIT;
+
+  template <typename _Tp>
+  __gthread_key_t
+  bitmap_allocator<_Tp>::_S_cache_key;
+
+  template <typename _Tp>
+  bool
+  bitmap_allocator<_Tp>::_S_cache_init = false;
 #endif
 
   template <typename _Tp1, typename _Tp2>
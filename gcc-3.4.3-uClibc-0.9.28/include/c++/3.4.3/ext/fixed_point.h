@@ -0,0 +1,1042 @@
+// Saturating fixed-point types -*- C++ -*-
+
+// Copyright (C) 2004 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 2, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING.  If not, write to the Free
+// Software Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+// USA.
+
+// As a special exception, you may use this file as part of a free software
+// library without restriction.  Specifically, if other files instantiate
+// templates or use macros or inline functions from this file, or you compile
+// this file and link it with other files to produce an executable, this
+// file does not by itself cause the resulting executable to be covered by
+// the GNU General Public License.  This exception does not however
+// invalidate any other reasons why the executable file might be covered by
+// the GNU General Public License.
+
+/** @file ext/fixed_point.h
+ *  This file is a GNU extension to the Standard C++ Library.
+ */
+
+#ifndef _FIXED_POINT_H
+#define _FIXED_POINT_H 1
+
+#pragma GCC system_header
+
+#include <cstddef>
+#include <climits>
+
+// ARMv5TE added the saturating QADD/QSUB/QDADD/QDSUB and the 16-bit
+// SMULxy/SMLAxy/SMULWy multiplies.  They exist in ARM state only.
+#if (defined(__ARM_ARCH_5TE__) || defined(__ARM_ARCH_5TEJ__) \
+     || defined(__ARM_ARCH_6__) || defined(__ARM_ARCH_6J__) \
+     || defined(__ARM_ARCH_6K__) || defined(__ARM_ARCH_6Z__) \
+     || defined(__ARM_ARCH_6ZK__)) && !defined(__thumb__)
+# define _GLIBCXX_ARM_DSP 1
+#endif
+
+namespace __gnu_cxx
+{
+  // Saturating primitives on raw 32-bit values.  With _GLIBCXX_ARM_DSP
+  // each is a single instruction; otherwise the C versions compute the
+  // same results.
+
+  // Saturates a 64-bit value to 32 bits.
+  inline int
+  __sat32(long long __x)
+  {
+    if (__x > INT_MAX)
+      return INT_MAX;
+    if (__x < INT_MIN)
+      return INT_MIN;
+    return int(__x);
+  }
+
+  // __a + __b, saturated.
+  inline int
+  __qadd(int __a, int __b)
+  {
+#ifdef _GLIBCXX_ARM_DSP
+    int __r;
+    __asm__ ("qadd %0, %1, %2" : "=r" (__r) : "r" (__a), "r" (__b));
+    return __r;
+#else
+    return __sat32((long long)__a + __b);
+#endif
+  }
+
+  // __a - __b, saturated.
+  inline int
+  __qsub(int __a, int __b)
+  {
+#ifdef _GLIBCXX_ARM_DSP
+    int __r;
+    __asm__ ("qsub %0, %1, %2" : "=r" (__r) : "r" (__a), "r" (__b));
+    return __r;
+#else
+    return __sat32((long long)__a - __b);
+#endif
+  }
+
+  // __a + 2 * __b, each step saturated.
+  inline int
+  __qdadd(int __a, int __b)
+  {
+#ifdef _GLIBCXX_ARM_DSP
+    int __r;
+    __asm__ ("qdadd %0, %1, %2" : "=r" (__r) : "r" (__a), "r" (__b));
+    return __r;
+#else
+    return __qadd(__a, __qadd(__b, __b));
+#endif
+  }
+
+  // __a - 2 * __b, each step saturated.
+  inline int
+  __qdsub(int __a, int __b)
+  {
+#ifdef _GLIBCXX_ARM_DSP
+    int __r;
+    __asm__ ("qdsub %0, %1, %2" : "=r" (__r) : "r" (__a), "r" (__b));
+    return __r;
+#else
+    return __qsub(__a, __qadd(__b, __b));
+#endif
+  }
+
+  // Product of the low halfwords of __a and __b.
+  inline int
+  __smulbb(int __a, int __b)
+  {
+#ifdef _GLIBCXX_ARM_DSP
+    int __r;
+    __asm__ ("smulbb %0, %1, %2" : "=r" (__r) : "r" (__a), "r" (__b));
+    return __r;
+#else
+    return int(short(__a)) * int(short(__b));
+#endif
+  }
+
+  // __acc + the product of the low halfwords of __a and __b.  Like
+  // the instruction, the addition wraps.
+  inline int
+  __smlabb(int __a, int __b, int __acc)
+  {
+#ifdef _GLIBCXX_ARM_DSP
+    int __r;
+    __asm__ ("smlabb %0, %1, %2, %3"
+	     : "=r" (__r) : "r" (__a), "r" (__b), "r" (__acc));
+    return __r;
+#else
+    return int((unsigned int)__acc + (unsigned int)__smulbb(__a, __b));
+#endif
+  }
+
+  // Top 32 bits of the 48-bit product of __a and the low halfword of
+  // __b.
+  inline int
+  __smulwb(int __a, int __b)
+  {
+#ifdef _GLIBCXX_ARM_DSP
+    int __r;
+    __asm__ ("smulwb %0, %1, %2" : "=r" (__r) : "r" (__a), "r" (__b));
+    return __r;
+#else
+    return int(((long long)__a * short(__b)) >> 16);
+#endif
+  }
+
+  // __a * 2^__n / __b, truncated toward zero, saturated.  Division by
+  // zero gives the limit with the sign of __a, and 0 for 0 / 0.
+  inline int
+  __qdiv(int __a, int __b, int __n)
+  {
+    if (__b == 0)
+      return __a > 0 ? INT_MAX : __a < 0 ? INT_MIN : 0;
+    return __sat32(((long long)__a << __n) / __b);
+  }
+
+  class q31;
+  class q16_16;
+
+  /**
+   *  @brief  Signed Q15 fraction: 16 bits, range [-1, 1).
+   *
+   *  Addition, subtraction, multiplication and negation saturate
+   *  instead of wrapping; multiplication truncates toward minus
+   *  infinity.  The type is as small and as cheap to copy as a short,
+   *  so it can be used as a std::valarray element type, with
+   *  std::transform and std::plus/std::multiplies, and so on.
+   *  Conversions from double are for constants; on soft-float
+   *  targets they are slow.
+  */
+  class q15
+  {
+  public:
+    typedef short rep_type;
+
+    q15() : _M_v(0) { }
+
+    explicit
+    q15(double __d) : _M_v(_S_from_double(__d)) { }
+
+    inline explicit
+    q15(q31 __x);
+
+    /// A q15 with raw value @a r, i.e. r / 32768.
+    static q15
+    from_raw(rep_type __r)
+    {
+      q15 __q;
+      __q._M_v = __r;
+      return __q;
+    }
+
+    rep_type
+    raw() const { return _M_v; }
+
+    double
+    to_double() const { return _M_v / 32768.0; }
+
+    q15&
+    operator+=(q15 __x)
+    {
+      _M_v = __qadd(_M_v << 16, __x._M_v << 16) >> 16;
+      return *this;
+    }
+
+    q15&
+    operator-=(q15 __x)
+    {
+      _M_v = __qsub(_M_v << 16, __x._M_v << 16) >> 16;
+      return *this;
+    }
+
+    q15&
+    operator*=(q15 __x)
+    {
+      // 2 * a * b as Q31 saturates only for -1 * -1.
+      const int __p = __smulbb(_M_v, __x._M_v);
+      _M_v = __qadd(__p, __p) >> 16;
+      return *this;
+    }
+
+    q15
+    operator-() const
+    { return from_raw(__qsub(0, _M_v << 16) >> 16); }
+
+    q15
+    operator+() const { return *this; }
+
+  private:
+    static rep_type
+    _S_from_double(double __d)
+    {
+      __d *= 32768.0;
+      if (__d >= 32767.0)
+	return 32767;
+      if (__d <= -32768.0)
+	return -32768;
+      return rep_type(__d);
+    }
+
+    rep_type _M_v;
+  };
+
+  /**
+   *  @brief  Signed Q31 fraction: 32 bits, range [-1, 1).
+   *
+   *  The same saturating semantics as q15.  A q31 also serves as the
+   *  accumulator for q15 multiply-accumulate: see mac().
+  */
+  class q31
+  {
+  public:
+    typedef int rep_type;
+
+    q31() : _M_v(0) { }
+
+    explicit
+    q31(double __d) : _M_v(_S_from_double(__d)) { }
+
+    /// Exact widening of a q15.
+    q31(q15 __x) : _M_v(int(__x.raw()) << 16) { }
+
+    inline explicit
+    q31(q16_16 __x);
+
+    /// A q31 with raw value @a r, i.e. r / 2^31.
+    static q31
+    from_raw(rep_type __r)
+    {
+      q31 __q;
+      __q._M_v = __r;
+      return __q;
+    }
+
+    rep_type
+    raw() const { return _M_v; }
+
+    double
+    to_double() const { return _M_v / 2147483648.0; }
+
+    q31&
+    operator+=(q31 __x)
+    {
+      _M_v = __qadd(_M_v, __x._M_v);
+      return *this;
+    }
+
+    q31&
+    operator-=(q31 __x)
+    {
+      _M_v = __qsub(_M_v, __x._M_v);
+      return *this;
+    }
+
+    q31&
+    operator*=(q31 __x)
+    {
+      _M_v = __sat32(((long long)_M_v * __x._M_v) >> 31);
+      return *this;
+    }
+
+    // Gain: a Q31 signal scaled by a Q15 coefficient, in one SMULWB and
+    // one doubling add.  The product is truncated to Q30, so its
+    // lowest bit is always clear.
+    q31&
+    operator*=(q15 __x)
+    {
+      const int __p = __smulwb(_M_v, __x.raw());
+      _M_v = __qadd(__p, __p);
+      return *this;
+    }
+
+    q31&
+    operator/=(q31 __x)
+    {
+      _M_v = __qdiv(_M_v, __x._M_v, 31);
+      return *this;
+    }
+
+    q31
+    operator-() const { return from_raw(__qsub(0, _M_v)); }
+
+    q31
+    operator+() const { return *this; }
+
+  private:
+    static rep_type
+    _S_from_double(double __d)
+    {
+      __d *= 2147483648.0;
+      if (__d >= 2147483647.0)
+	return INT_MAX;
+      if (__d <= -2147483648.0)
+	return INT_MIN;
+      return rep_type(__d);
+    }
+
+    rep_type _M_v;
+  };
+
+  /**
+   *  @brief  Signed Q16.16 number: 32 bits, range [-32768, 32768) in
+   *  steps of 2^-16.
+   *
+   *  For coordinates, lengths and angles, where q15 and q31 have no
+   *  integer part.  Arithmetic saturates as it does for them;
+   *  multiplication truncates toward minus infinity, division toward
+   *  zero, and division by zero saturates.  The math functions below
+   *  (sqrt, sin, atan2, log2, exp2, pow, ...) take and return q16_16,
+   *  so std::complex<q16_16> and std::valarray<q16_16> find them.
+  */
+  class q16_16
+  {
+  public:
+    typedef int rep_type;
+
+    q16_16() : _M_v(0) { }
+
+    explicit
+    q16_16(double __d) : _M_v(_S_from_double(__d)) { }
+
+    /// @a n, saturated to the range.
+    explicit
+    q16_16(int __n) : _M_v(__sat32((long long)__n << 16)) { }
+
+    /// Exact.
+    explicit
+    q16_16(q15 __x) : _M_v(int(__x.raw()) << 1) { }
+
+    /// Truncating.
+    explicit
+    q16_16(q31 __x) : _M_v(__x.raw() >> 15) { }
+
+    /// A q16_16 with raw value @a r, i.e. r / 65536.
+    static q16_16
+    from_raw(rep_type __r)
+    {
+      q16_16 __q;
+      __q._M_v = __r;
+      return __q;
+    }
+
+    rep_type
+    raw() const { return _M_v; }
+
+    double
+    to_double() const { return _M_v / 65536.0; }
+
+    /// The integer part, rounded toward minus infinity.
+    int
+    to_int() const { return _M_v >> 16; }
+
+    q16_16&
+    operator+=(q16_16 __x)
+    {
+      _M_v = __qadd(_M_v, __x._M_v);
+      return *this;
+    }
+
+    q16_16&
+    operator-=(q16_16 __x)
+    {
+      _M_v = __qsub(_M_v, __x._M_v);
+      return *this;
+    }
+
+    q16_16&
+    operator*=(q16_16 __x)
+    {
+      _M_v = __sat32(((long long)_M_v * __x._M_v) >> 16);
+      return *this;
+    }
+
+    q16_16&
+    operator/=(q16_16 __x)
+    {
+      _M_v = __qdiv(_M_v, __x._M_v, 16);
+      return *this;
+    }
+
+    q16_16&
+    operator*=(int __n)
+    {
+      _M_v = __sat32((long long)_M_v * __n);
+      return *this;
+    }
+
+    q16_16&
+    operator/=(int __n)
+    {
+      _M_v = __qdiv(_M_v, __n, 0);
+      return *this;
+    }
+
+    q16_16
+    operator-() const { return from_raw(__qsub(0, _M_v)); }
+
+    q16_16
+    operator+() const { return *this; }
+
+  private:
+    static rep_type
+    _S_from_double(double __d)
+    {
+      __d *= 65536.0;
+      if (__d >= 2147483647.0)
+	return INT_MAX;
+      if (__d <= -2147483648.0)
+	return INT_MIN;
+      return rep_type(__d);
+    }
+
+    rep_type _M_v;
+  };
+
+  /// Narrows a q31 to q15, truncating.
+  inline
+  q15::q15(q31 __x) : _M_v(rep_type(__x.raw() >> 16)) { }
+
+  /// Saturating.
+  inline
+  q31::q31(q16_16 __x) : _M_v(__sat32((long long)__x.raw() << 15)) { }
+
+  /**
+   *  @brief  Multiply-accumulate for FIR filters and mixing.
+   *  @return  @a acc + @a a * @a b, saturated.
+   *
+   *  This is one SMULBB and one QDADD.  The product of two Q15s is
+   *  exact in Q31, except -1 * -1: that product saturates to the
+   *  largest q31 before it is added, so mac(-1, -1, -1) gives -2^-31
+   *  rather than 0.
+  */
+  inline q31
+  mac(q31 __acc, q15 __a, q15 __b)
+  { return q31::from_raw(__qdadd(__acc.raw(), __smulbb(__a.raw(), __b.raw()))); }
+
+  /// @return  @a acc - @a a * @a b, saturated.
+  inline q31
+  msub(q31 __acc, q15 __a, q15 __b)
+  { return q31::from_raw(__qdsub(__acc.raw(), __smulbb(__a.raw(), __b.raw()))); }
+
+  inline q15
+  operator+(q15 __x, q15 __y) { return __x += __y; }
+
+  inline q15
+  operator-(q15 __x, q15 __y) { return __x -= __y; }
+
+  inline q15
+  operator*(q15 __x, q15 __y) { return __x *= __y; }
+
+  inline q31
+  operator+(q31 __x, q31 __y) { return __x += __y; }
+
+  inline q31
+  operator-(q31 __x, q31 __y) { return __x -= __y; }
+
+  inline q31
+  operator*(q31 __x, q31 __y) { return __x *= __y; }
+
+  inline q31
+  operator*(q31 __x, q15 __y) { return __x *= __y; }
+
+  inline q31
+  operator*(q15 __x, q31 __y) { return __y *= __x; }
+
+  inline q31
+  operator/(q31 __x, q31 __y) { return __x /= __y; }
+
+  inline q16_16
+  operator+(q16_16 __x, q16_16 __y) { return __x += __y; }
+
+  inline q16_16
+  operator-(q16_16 __x, q16_16 __y) { return __x -= __y; }
+
+  inline q16_16
+  operator*(q16_16 __x, q16_16 __y) { return __x *= __y; }
+
+  inline q16_16
+  operator/(q16_16 __x, q16_16 __y) { return __x /= __y; }
+
+  inline q16_16
+  operator*(q16_16 __x, int __n) { return __x *= __n; }
+
+  inline q16_16
+  operator*(int __n, q16_16 __x) { return __x *= __n; }
+
+  inline q16_16
+  operator/(q16_16 __x, int __n) { return __x /= __n; }
+
+#define _GLIBCXX_FIXED_COMPARE(_Tp)					\
+  inline bool								\
+  operator==(_Tp __x, _Tp __y) { return __x.raw() == __y.raw(); }	\
+									\
+  inline bool								\
+  operator!=(_Tp __x, _Tp __y) { return __x.raw() != __y.raw(); }	\
+									\
+  inline bool								\
+  operator<(_Tp __x, _Tp __y) { return __x.raw() < __y.raw(); }	\
+									\
+  inline bool								\
+  operator>(_Tp __x, _Tp __y) { return __x.raw() > __y.raw(); }	\
+									\
+  inline bool								\
+  operator<=(_Tp __x, _Tp __y) { return __x.raw() <= __y.raw(); }	\
+									\
+  inline bool								\
+  operator>=(_Tp __x, _Tp __y) { return __x.raw() >= __y.raw(); }
+
+  _GLIBCXX_FIXED_COMPARE(q15)
+  _GLIBCXX_FIXED_COMPARE(q31)
+  _GLIBCXX_FIXED_COMPARE(q16_16)
+
+#undef _GLIBCXX_FIXED_COMPARE
+
+  /// Saturating absolute value: abs(-1) is the largest q15.
+  inline q15
+  abs(q15 __x) { return __x.raw() < 0 ? -__x : __x; }
+
+  /// Saturating absolute value: abs(-1) is the largest q31.
+  inline q31
+  abs(q31 __x) { return __x.raw() < 0 ? -__x : __x; }
+
+  /// Saturating absolute value.
+  inline q16_16
+  abs(q16_16 __x) { return __x.raw() < 0 ? -__x : __x; }
+
+  /// The largest integer not greater than @a x.
+  inline q16_16
+  floor(q16_16 __x) { return q16_16::from_raw(__x.raw() & ~0xffff); }
+
+  /// The smallest integer not less than @a x, saturated.
+  inline q16_16
+  ceil(q16_16 __x)
+  {
+    return q16_16::from_raw(__qadd(__x.raw() & ~0xffff,
+				   __x.raw() & 0xffff ? 0x10000 : 0));
+  }
+
+  // Math functions.  Like the <cmath> ones they take and return the
+  // argument's type, and std::complex and std::valarray reach them by
+  // argument-dependent lookup.  They use 32-bit integer operations and
+  // 32x32->64-bit multiplies, the ones ARM has instructions for; none
+  // converts to float or double.  Results are rounded to nearest, and
+  // the errors given are in units of the last place (lsb) of the
+  // result.
+
+  // __a * __b for Q2.30 values.
+  inline int
+  __mul30(int __a, int __b)
+  { return int(((long long)__a * __b) >> 30); }
+
+  // sqrt(__x * 2^__n), rounded, for even __n up to 30: the
+  // digit-by-digit method, one bit of the root per step.
+  inline unsigned int
+  __fixed_isqrt(unsigned int __x, int __n)
+  {
+    unsigned long long __rem = 0;
+    unsigned int __root = 0;
+
+    for (int __i = (32 + __n) / 2; __i > 0; --__i)
+      {
+	__rem = (__rem << 2) | (__x >> 30);
+	__x <<= 2;
+	__root <<= 1;
+	const unsigned long long __d = (unsigned long long)__root * 2 + 1;
+	if (__rem >= __d)
+	  {
+	    __rem -= __d;
+	    ++__root;
+	  }
+      }
+    // (root + 1/2)^2 <= x exactly when the remainder exceeds root.
+    return __root + (__rem > __root);
+  }
+
+  // The sine and cosine of __t / 2^32 turns, in Q2.30, within 2^-29.
+  inline void
+  __fixed_sincos(unsigned int __t, int& __s, int& __c)
+  {
+    // Folded to [0, pi/4] within the quadrant, where the Taylor
+    // series to x^11 and x^10 are exact to 2^-32.
+    const unsigned int __f = __t & 0x3fffffff;
+    const unsigned int __g = __f < 0x20000000 ? __f : 0x40000000 - __f;
+    const int __a = int(((unsigned long long)__g * 0x6487ed51
+			 + 0x20000000) >> 30);
+    const int __z = __mul30(__a, __a);
+
+    int __p = 2959 + __mul30(__z, -27);
+    __p = -213044 + __mul30(__z, __p);
+    __p = 8947849 + __mul30(__z, __p);
+    __p = -178956971 + __mul30(__z, __p);
+    const int __sa = __a + __mul30(__mul30(__a, __z), __p);
+
+    __p = 26631 + __mul30(__z, -296);
+    __p = -1491308 + __mul30(__z, __p);
+    __p = 44739243 + __mul30(__z, __p);
+    __p = -536870912 + __mul30(__z, __p);
+    const int __ca = 0x40000000 + __mul30(__z, __p);
+
+    const int __s0 = __f < 0x20000000 ? __sa : __ca;
+    const int __c0 = __f < 0x20000000 ? __ca : __sa;
+    switch (__t >> 30)
+      {
+      case 0:
+	__s = __s0;
+	__c = __c0;
+	break;
+      case 1:
+	__s = __c0;
+	__c = -__s0;
+	break;
+      case 2:
+	__s = -__s0;
+	__c = -__c0;
+	break;
+      default:
+	__s = -__c0;
+	__c = __s0;
+	break;
+      }
+  }
+
+  // __x radians in 2^-32 turns, modulo one turn.
+  inline unsigned int
+  __fixed_turn(q16_16 __x)
+  {
+    // __x * 2^48 / (2 pi), with the constant 2^64 / (2 pi) in two
+    // halves.
+    const long long __hi = (long long)__x.raw() * 0x28be60db;
+    const long long __lo = (long long)__x.raw() * 0x9391054a;
+    return (unsigned int)((__hi + (__lo >> 32) + 0x8000) >> 16);
+  }
+
+  inline unsigned int
+  __fixed_turn(q31 __x)
+  { return (unsigned int)(((long long)__x.raw() * 0x517cc1b7
+			   + 0x80000000LL) >> 32); }
+
+  // atan2(__y, __x) in Q3.29 radians by CORDIC: rotations by
+  // +-atan(2^-i) drive __y to zero and add up to the angle.
+  inline int
+  __fixed_atan2(int __y, int __x)
+  {
+    // atan(2^-i) in Q3.29.
+    static const int __atan[30] =
+      {
+	421657428, 248918915, 131521918, 66762579, 33510843, 16771758,
+	8387925, 4194219, 2097141, 1048575, 524288, 262144, 131072,
+	65536, 32768, 16384, 8192, 4096, 2048, 1024, 512, 256, 128, 64,
+	32, 16, 8, 4, 2, 1
+      };
+    const int __pi = 1686629713;
+
+    if (__x == 0 && __y == 0)
+      return 0;
+
+    // Scaled so that the larger magnitude is in [2^28, 2^29): the
+    // CORDIC gain of 1.65 then cannot overflow.
+    const unsigned int __m = (__x < 0 ? -(unsigned int)__x : __x)
+			     | (__y < 0 ? -(unsigned int)__y : __y);
+    const int __n = __builtin_clz(__m) - 3;
+    if (__n >= 0)
+      {
+	__x <<= __n;
+	__y <<= __n;
+      }
+    else
+      {
+	__x >>= -__n;
+	__y >>= -__n;
+      }
+
+    // The left half-plane is first rotated by pi.
+    int __z = 0;
+    if (__x < 0)
+      {
+	__z = __y < 0 ? -__pi : __pi;
+	__x = -__x;
+	__y = -__y;
+      }
+    for (int __i = 0; __i < 30; ++__i)
+      {
+	const int __xi = __x >> __i;
+	if (__y > 0)
+	  {
+	    __x += __y >> __i;
+	    __y -= __xi;
+	    __z += __atan[__i];
+	  }
+	else
+	  {
+	    __x -= __y >> __i;
+	    __y += __xi;
+	    __z -= __atan[__i];
+	  }
+      }
+    return __z;
+  }
+
+  // log2(__x / 2^16) in Q.32, for __x > 0, within 2^-30.
+  inline long long
+  __fixed_log2(int __x)
+  {
+    // 2^32 / c and log2(c) in Q.32, for c = 1 + (i + 1/2) / 16.
+    static const unsigned int __inv[16] =
+      {
+	0xf83e0f84, 0xea0ea0ea, 0xdd67c8a6, 0xd20d20d2,
+	0xc7ce0c7d, 0xbe82fa0c, 0xb60b60b6, 0xae4c415d,
+	0xa72f0539, 0xa0a0a0a1, 0x9a90e7d9, 0x94f2094f,
+	0x8fb823ee, 0x8ad8f2fc, 0x864b8a7e, 0x82082082
+      };
+    static const unsigned int __logc[16] =
+      {
+	0x0b5d69bb, 0x2118b11a, 0x359ebc5b, 0x49101eac,
+	0x5b888736, 0x6d1fafdd, 0x7dea15a3, 0x8df988f5,
+	0x9d5d9fd5, 0xac241135, 0xba58feb2, 0xc80730b0,
+	0xd53847ac, 0xe1f4e517, 0xee44cd5a, 0xfa2f045e
+      };
+
+    // __x / 2^16 = m * 2^(15 - n), m in [1, 2) in Q1.31.
+    const int __n = __builtin_clz(__x);
+    const unsigned int __m = (unsigned int)__x << __n;
+    const int __i = (__m >> 27) & 15;
+
+    // r = m / c - 1, |r| < 1/32, in Q.31; ln(1 + r) by its series to
+    // r^5.
+    const int __r = int((unsigned int)(((unsigned long long)__m
+					* __inv[__i]) >> 32) - 0x80000000u);
+    const int __r2 = int(((long long)__r * __r) >> 31);
+    int __p = int(((long long)__r * 0x1999999a) >> 31) - 0x20000000;
+    __p = int(((long long)__r * __p) >> 31) + 0x2aaaaaab;
+    __p = int(((long long)__r * __p) >> 31) - 0x40000000;
+    __p = __r + int(((long long)__r2 * __p) >> 31);
+
+    // Times log2(e), 0xb8aa3b29 in Q1.31.
+    return ((long long)(15 - __n) << 32) + __logc[__i]
+	   + (((long long)__p * 0xb8aa3b29u) >> 30);
+  }
+
+  // 2^(__t / 2^32) as a raw q16_16, saturated.
+  inline int
+  __fixed_exp2(long long __t)
+  {
+    // 2^(i/64) in Q1.31.
+    static const unsigned int __tab[64] =
+      {
+	0x80000000, 0x8164d1f4, 0x82cd8699, 0x843a28c4,
+	0x85aac368, 0x871f6197, 0x88980e81, 0x8a14d575,
+	0x8b95c1e4, 0x8d1adf5b, 0x8ea4398b, 0x9031dc43,
+	0x91c3d374, 0x935a2b2f, 0x94f4efa9, 0x96942d37,
+	0x9837f052, 0x99e04593, 0x9b8d39ba, 0x9d3ed9a7,
+	0x9ef53261, 0xa0b05110, 0xa2704303, 0xa43515ae,
+	0xa5fed6aa, 0xa7cd93b5, 0xa9a15ab5, 0xab7a39b6,
+	0xad583eea, 0xaf3b78ad, 0xb123f582, 0xb311c413,
+	0xb504f334, 0xb6fd91e3, 0xb8fbaf47, 0xbaff5ab2,
+	0xbd08a39f, 0xbf1799b6, 0xc12c4cca, 0xc346ccda,
+	0xc5672a11, 0xc78d74c9, 0xc9b9bd86, 0xcbec14ff,
+	0xce248c15, 0xd06333db, 0xd2a81d92, 0xd4f35aac,
+	0xd744fccb, 0xd99d15c2, 0xdbfbb798, 0xde60f482,
+	0xe0ccdeec, 0xe33f8973, 0xe5b906e7, 0xe8396a50,
+	0xeac0c6e8, 0xed4f301f, 0xefe4b99c, 0xf281773c,
+	0xf5257d15, 0xf7d0df73, 0xfa83b2db, 0xfd3e0c0d
+      };
+
+    if (__t >= (long long)15 << 32)
+      return INT_MAX;
+    if (__t < (long long)-18 << 32)
+      return 0;
+
+    // t = k + i/64 + d, 0 <= d < 2^-6; 2^d = 1 + p with
+    // p = u + u^2/2 + u^3/6 + u^4/24, u = d ln 2, to 2^-32.
+    const int __k = int(__t >> 32);
+    const unsigned int __f = (unsigned int)__t;
+    const unsigned int __u = ((unsigned long long)(__f & 0x3ffffff)
+			      * 0xb17217f8u) >> 32;
+    const unsigned int __u2 = ((unsigned long long)__u * __u) >> 32;
+    const unsigned int __u3 = ((unsigned long long)__u2 * __u) >> 32;
+    const unsigned int __u4 = ((unsigned long long)__u3 * __u) >> 32;
+    const unsigned int __p = __u + (__u2 >> 1)
+			     + (((unsigned long long)__u3 * 0x2aaaaaab) >> 32)
+			     + (((unsigned long long)__u4 * 0x0aaaaaab) >> 32);
+    const unsigned int __c = __tab[__f >> 26];
+    const unsigned long long __m = __c
+				   + (((unsigned long long)__c * __p) >> 32);
+
+    // m * 2^k in Q1.31, to Q16.16.
+    const int __sh = 15 - __k;
+    const unsigned long long __r = (__m + ((unsigned long long)1
+					   << (__sh - 1))) >> __sh;
+    return __r > INT_MAX ? INT_MAX : int(__r);
+  }
+
+  /// Within 0.5 lsb; negative arguments give 0.
+  inline q16_16
+  sqrt(q16_16 __x)
+  {
+    if (__x.raw() <= 0)
+      return q16_16();
+    return q16_16::from_raw(int(__fixed_isqrt(__x.raw(), 16)));
+  }
+
+  /**
+   *  @brief  1 / sqrt(@a x), for normalizing vectors.
+   *
+   *  Newton's iteration from a 16-entry table, within 1 lsb; arguments
+   *  not greater than 0 give the largest q16_16.
+  */
+  inline q16_16
+  rsqrt(q16_16 __x)
+  {
+    // 1 / sqrt(c) in Q2.30, for c = k/16 + 1/32, k = 4, ..., 15.
+    static const unsigned int __seed[12] =
+      {
+	0x78adf778, 0x6d28a4f0, 0x64695585, 0x5d7a5d1b,
+	0x57cea99d, 0x530eafa5, 0x4f00d944, 0x4b7d8317,
+	0x48686148, 0x45aca3d5, 0x433a98c6, 0x41062920
+      };
+
+    if (__x.raw() <= 0)
+      return q16_16::from_raw(INT_MAX);
+
+    // __x / 2^16 = a * 2^(16 - s), a in [1/4, 1) in Q.32, s even.
+    const int __s = __builtin_clz(__x.raw()) & ~1;
+    const unsigned int __a = (unsigned int)__x.raw() << __s;
+    unsigned int __y = __seed[(__a >> 28) - 4];
+    for (int __i = 0; __i < 3; ++__i)
+      {
+	// y = y * (3 - a * y^2) / 2
+	const unsigned int __ay = ((unsigned long long)__a * __y) >> 32;
+	const unsigned int __ayy = ((unsigned long long)__ay * __y) >> 30;
+	__y = ((unsigned long long)__y * (0xc0000000u - __ayy)) >> 31;
+      }
+    const int __sh = 22 - __s / 2;
+    return q16_16::from_raw(int((__y + (1u << (__sh - 1))) >> __sh));
+  }
+
+  /// Within 1 lsb, for any argument.
+  inline q16_16
+  sin(q16_16 __x)
+  {
+    int __s, __c;
+    __fixed_sincos(__fixed_turn(__x), __s, __c);
+    return q16_16::from_raw((__s + 0x2000) >> 14);
+  }
+
+  /// Within 1 lsb, for any argument.
+  inline q16_16
+  cos(q16_16 __x)
+  {
+    int __s, __c;
+    __fixed_sincos(__fixed_turn(__x), __s, __c);
+    return q16_16::from_raw((__c + 0x2000) >> 14);
+  }
+
+  /// Saturated near the poles.
+  inline q16_16
+  tan(q16_16 __x)
+  {
+    int __s, __c;
+    __fixed_sincos(__fixed_turn(__x), __s, __c);
+    return q16_16::from_raw(__qdiv(__s, __c, 16));
+  }
+
+  /// Within 1 lsb, in [-pi, pi]; atan2(0, 0) is 0.
+  inline q16_16
+  atan2(q16_16 __y, q16_16 __x)
+  {
+    return q16_16::from_raw((__fixed_atan2(__y.raw(), __x.raw())
+			     + 0x1000) >> 13);
+  }
+
+  /// Within 1 lsb.
+  inline q16_16
+  atan(q16_16 __x)
+  { return q16_16::from_raw((__fixed_atan2(__x.raw(), 0x10000)
+			     + 0x1000) >> 13); }
+
+  /// Within 1 lsb; arguments not greater than 0 give the smallest
+  /// q16_16.
+  inline q16_16
+  log2(q16_16 __x)
+  {
+    if (__x.raw() <= 0)
+      return q16_16::from_raw(INT_MIN);
+    return q16_16::from_raw(int((__fixed_log2(__x.raw()) + 0x8000) >> 16));
+  }
+
+  /// Within 1 lsb; arguments not greater than 0 give the smallest
+  /// q16_16.
+  inline q16_16
+  log(q16_16 __x)
+  {
+    if (__x.raw() <= 0)
+      return q16_16::from_raw(INT_MIN);
+    // Times ln 2, 0xb17217f8 in Q.32.
+    return q16_16::from_raw(int(((__fixed_log2(__x.raw()) >> 8)
+				 * 0xb17217f8u + ((long long)1 << 39)) >> 40));
+  }
+
+  /// Within 1 lsb; arguments not greater than 0 give the smallest
+  /// q16_16.
+  inline q16_16
+  log10(q16_16 __x)
+  {
+    if (__x.raw() <= 0)
+      return q16_16::from_raw(INT_MIN);
+    // Times log10(2), 0x4d104d42 in Q.32.
+    return q16_16::from_raw(int(((__fixed_log2(__x.raw()) >> 8)
+				 * 0x4d104d42 + ((long long)1 << 39)) >> 40));
+  }
+
+  /// Within 2.5 lsb, saturated.  The error grows with the result and
+  /// passes 2 lsb only near the top of the range.
+  inline q16_16
+  exp2(q16_16 __x)
+  { return q16_16::from_raw(__fixed_exp2((long long)__x.raw() << 16)); }
+
+  /// Within 2.5 lsb, saturated, as exp2.
+  inline q16_16
+  exp(q16_16 __x)
+  {
+    // Times log2(e), 0xb8aa3b29 5c17f0bc in Q1.63: the result has up
+    // to 31 significant bits, so the constant needs more than 32.
+    const long long __hi = (long long)__x.raw() * 0xb8aa3b29u;
+    const long long __lo = (long long)__x.raw() * 0x5c17f0bc;
+    return q16_16::from_raw(__fixed_exp2((__hi + (__lo >> 32)) >> 15));
+  }
+
+  /**
+   *  @brief  @a x raised to the power @a y, saturated.
+   *
+   *  Within 1 lsb plus 2^-29 (|y| + 1) times the result, so within 1
+   *  lsb for results below 16.  A negative @a x gives a result for
+   *  integral @a y only, and 0 otherwise.
+  */
+  inline q16_16
+  pow(q16_16 __x, q16_16 __y)
+  {
+    if (__y.raw() == 0)
+      return q16_16(1);
+    if (__x.raw() == 0)
+      return q16_16::from_raw(__y.raw() > 0 ? 0 : INT_MAX);
+    if (__x.raw() < 0)
+      {
+	if (__y.raw() & 0xffff)
+	  return q16_16();
+	const q16_16 __r = pow(-__x, __y);
+	return __y.raw() & 0x10000 ? -__r : __r;
+      }
+
+    // y * log2(x) in Q.32, from the Q.48 product in two parts.
+    const long long __l = __fixed_log2(__x.raw());
+    const long long __t = (__l >> 16) * __y.raw()
+			  + (((__l & 0xffff) * __y.raw()) >> 16);
+    return q16_16::from_raw(__fixed_exp2(__t));
+  }
+
+  /// Within 0.5 lsb; negative arguments give 0.
+  inline q31
+  sqrt(q31 __x)
+  {
+    if (__x.raw() <= 0)
+      return q31();
+    const unsigned int __r = __fixed_isqrt((unsigned int)__x.raw() << 1, 30);
+    return q31::from_raw(__r > INT_MAX ? INT_MAX : int(__r));
+  }
+
+  /// The sine of @a x radians, within 6 lsb.
+  inline q31
+  sin(q31 __x)
+  {
+    int __s, __c;
+    __fixed_sincos(__fixed_turn(__x), __s, __c);
+    return q31::from_raw(__qadd(__s, __s));
+  }
+
+  /// The cosine of @a x radians, within 6 lsb; cos(0) saturates.
+  inline q31
+  cos(q31 __x)
+  {
+    int __s, __c;
+    __fixed_sincos(__fixed_turn(__x), __s, __c);
+    return q31::from_raw(__qadd(__c, __c));
+  }
+} // namespace __gnu_cxx
+
+#endif
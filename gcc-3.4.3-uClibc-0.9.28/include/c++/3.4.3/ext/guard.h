@@ -0,0 +1,129 @@
+// Locking guarded initialization -*- C++ -*-
+
+// Copyright (C) 2004 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 2, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING.  If not, write to the Free
+// Software Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+// USA.
+
+// As a special exception, you may use this file as part of a free software
+// library without restriction.  Specifically, if other files instantiate
+// templates or use macros or inline functions from this file, or you compile
+// this file and link it with other files to produce an executable, this
+// file does not by itself cause the resulting executable to be covered by
+// the GNU General Public License.  This exception does not however
+// invalidate any other reasons why the executable file might be covered by
+// the GNU General Public License.
+
+/** @file ext/guard.h
+ *  This file is a GNU extension to the Standard C++ Library.
+ */
+
+#ifndef _EXT_GUARD_H
+#define _EXT_GUARD_H 1
+
+#pragma GCC system_header
+
+#include <cxxabi.h>
+#include <climits>
+#include <pthread.h>
+
+namespace __gnu_cxx
+{
+  // Thread-safe guarded initialization.  The compiler's own guard for
+  // a function-local static only tests and sets the initialized flag,
+  // which is not safe if two threads get there at once, and it never
+  // calls these functions.  Code that initializes an object from
+  // several threads calls them itself, with a guard variable of the
+  // ABI's type.  They lock, one guard at a time, only while the object
+  // is being initialized; an object that is already initialized costs
+  // one load of the guard:
+  //
+  //   static __cxxabiv1::__guard __g;
+  //   static table* __t;
+  //   if (__gnu_cxx::__guard_test_and_acquire(&__g))
+  //     {
+  //       try
+  //         { __t = new table; }
+  //       catch(...)
+  //         {
+  //           __gnu_cxx::__guard_abort(&__g);
+  //           throw;
+  //         }
+  //       __gnu_cxx::__guard_release(&__g);
+  //     }
+  //
+  // Threads that arrive during the initialization sleep on the guard
+  // word with FUTEX_WAIT.
+
+  // Returns true if the caller must initialize the object and then
+  // call __guard_release or __guard_abort.
+  inline bool
+  __guard_test_and_acquire(__cxxabiv1::__guard* __g)
+  {
+    if (__builtin_expect(_GLIBCXX_GUARD_TEST(__g), 1))
+      return false;
+
+    volatile int* __w = reinterpret_cast<volatile int*>(__g);
+    for (;;)
+      {
+	const int __v = *__w;
+	if (__v & _GLIBCXX_GUARD_BIT)
+	  return false;
+	if (!(__v & _GLIBCXX_GUARD_PENDING_BIT))
+	  {
+	    if (__pthread_atomic_cas(__w, __v,
+				     __v | _GLIBCXX_GUARD_PENDING_BIT))
+	      return true;
+	    continue;
+	  }
+	const int __wait = __v | _GLIBCXX_GUARD_WAITING_BIT;
+	if (__v == __wait || __pthread_atomic_cas(__w, __v, __wait))
+	  __pthread_futex_wait(__w, __wait);
+      }
+  }
+
+  // Clears the pending and waiting bits, sets __done, and wakes any
+  // waiters.
+  inline void
+  __guard_finish(__cxxabiv1::__guard* __g, int __done)
+  {
+    volatile int* __w = reinterpret_cast<volatile int*>(__g);
+    int __v;
+    do
+      __v = *__w;
+    while (!__pthread_atomic_cas(__w, __v,
+				 (__v & ~(_GLIBCXX_GUARD_PENDING_BIT
+					  | _GLIBCXX_GUARD_WAITING_BIT))
+				 | __done));
+    if (__v & _GLIBCXX_GUARD_WAITING_BIT)
+      __pthread_futex_wake(__w, INT_MAX);
+  }
+
+  // Marks the object initialized.
+  inline void
+  __guard_release(__cxxabiv1::__guard* __g)
+  {
+    __asm__ __volatile__ ("" : : : "memory");
+    __guard_finish(__g, _GLIBCXX_GUARD_BIT);
+  }
+
+  // Gives up after a failed initialization; the next caller retries.
+  inline void
+  __guard_abort(__cxxabiv1::__guard* __g)
+  { __guard_finish(__g, 0); }
+} // namespace __gnu_cxx
+
+#endif
@@ -0,0 +1,166 @@
+// Cached local-time stamps for log streams -*- C++ -*-
+
+// Copyright (C) 2004 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 2, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING.  If not, write to the Free
+// Software Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+// USA.
+
+// As a special exception, you may use this file as part of a free software
+// library without restriction.  Specifically, if other files instantiate
+// templates or use macros or inline functions from this file, or you compile
+// this file and link it with other files to produce an executable, this
+// file does not by itself cause the resulting executable to be covered by
+// the GNU General Public License.  This exception does not however
+// invalidate any other reasons why the executable file might be covered by
+// the GNU General Public License.
+
+/** @file ext/log_timestamp.h
+ *  This file is a GNU extension to the Standard C++ Library.
+ */
+
+#ifndef _LOG_TIMESTAMP_H
+#define _LOG_TIMESTAMP_H 1
+
+#pragma GCC system_header
+
+#include <ostream>
+#include <bits/functexcept.h>
+#include <ctime>
+#include <sys/time.h>
+
+namespace __gnu_cxx
+{
+  /**
+   *  @class log_timestamp ext/log_timestamp.h <ext/log_timestamp.h>
+   *  @brief  The current local time, formatted once a second.
+   *
+   *  Wraps the strftime_cached interface of <time.h>: the format is
+   *  parsed once, localtime_r and strftime run only when the second
+   *  changes, and every other stamp copies the text of that second
+   *  and writes its %N digits.  As localtime_r rereads TZ and
+   *  /etc/TZ then, a change of time zone shows from the next second.
+   *
+   *  A log_timestamp is not locked; give each thread its own.
+   *
+   *  @code
+   *    __gnu_cxx::log_timestamp __ts("%Y-%m-%d %H:%M:%S.%3N ");
+   *    std::clog << __ts << "started\n";
+   *  @endcode
+  */
+  class log_timestamp
+  {
+  public:
+    typedef std::size_t	size_t;
+
+    /**
+     *  @param  format  A strftime format, which may also use %N for
+     *  nanoseconds and %3N, %6N and so on for their first digits.
+     *  @throw  std::invalid_argument  If @a format has more than
+     *  eight %N fields or is too long to keep.
+    */
+    explicit
+    log_timestamp(const char* __format)
+    : _M_len(0)
+    {
+      if (strftime_parse(&_M_format, __format) != 0)
+	std::__throw_invalid_argument("log_timestamp::log_timestamp");
+      strftime_cache_init(&_M_cache, &_M_format);
+      _M_text[0] = '\0';
+    }
+
+    log_timestamp(const log_timestamp& __ts)
+    : _M_format(__ts._M_format), _M_len(0)
+    {
+      strftime_cache_init(&_M_cache, &_M_format);
+      _M_text[0] = '\0';
+    }
+
+    log_timestamp&
+    operator=(const log_timestamp& __ts)
+    {
+      _M_format = __ts._M_format;
+      strftime_cache_init(&_M_cache, &_M_format);
+      _M_len = 0;
+      _M_text[0] = '\0';
+      return *this;
+    }
+
+    /**
+     *  @brief  Formats the current time.
+     *  @return  The stamp, empty if it does not fit.
+    */
+    const char*
+    stamp()
+    {
+      struct timeval __tv;
+      gettimeofday(&__tv, 0);
+      return stamp(__tv.tv_sec, __tv.tv_usec * 1000L);
+    }
+
+    /**
+     *  @brief  Formats a given time.
+     *  @param  sec  Seconds since the Epoch.
+     *  @param  nsec  Nanoseconds into that second.
+     *  @return  The stamp, empty if it does not fit.
+    */
+    const char*
+    stamp(time_t __sec, long __nsec)
+    {
+      _M_len = strftime_cached(_M_text, sizeof(_M_text), &_M_cache,
+			       __sec, __nsec);
+      if (_M_len == 0)
+	_M_text[0] = '\0';
+      return _M_text;
+    }
+
+    /// The last stamp.
+    const char*
+    c_str() const
+    { return _M_text; }
+
+    /// The length of the last stamp.
+    size_t
+    size() const
+    { return _M_len; }
+
+    /**
+     *  @brief  The local time of the last stamp's second.
+     *  @return  A pointer to the held time, or NULL before any stamp.
+    */
+    const std::tm*
+    local_time() const
+    { return _M_cache.valid ? &_M_cache.tm : 0; }
+
+  private:
+    strftime_format	_M_format;
+    strftime_cache	_M_cache;
+    size_t		_M_len;
+    char		_M_text[sizeof(static_cast<strftime_cache*>(0)->text)];
+  };
+
+  /**
+   *  @brief  Writes the current time, stamped by @a ts.
+  */
+  template<typename _Traits>
+    inline std::basic_ostream<char, _Traits>&
+    operator<<(std::basic_ostream<char, _Traits>& __os, log_timestamp& __ts)
+    {
+      const char* __s = __ts.stamp();
+      return __os.write(__s, __ts.size());
+    }
+} // namespace __gnu_cxx
+
+#endif
@@ -0,0 +1,275 @@
+// Memory-mapped input layer for filebuf -*- C++ -*-
+
+// Copyright (C) 2004 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 2, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING.  If not, write to the Free
+// Software Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+// USA.
+
+// As a special exception, you may use this file as part of a free software
+// library without restriction.  Specifically, if other files instantiate
+// templates or use macros or inline functions from this file, or you compile
+// this file and link it with other files to produce an executable, this
+// file does not by itself cause the resulting executable to be covered by
+// the GNU General Public License.  This exception does not however
+// invalidate any other reasons why the executable file might be covered by
+// the GNU General Public License.
+
+/** @file ext/mmap_filebuf.h
+ *  This file is a GNU extension to the Standard C++ Library.
+ */
+
+#ifndef _MMAP_FILEBUF_H
+#define _MMAP_FILEBUF_H 1
+
+#pragma GCC system_header
+
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace __gnu_cxx
+{
+  /**
+   *  @class mmap_filebuf ext/mmap_filebuf.h <ext/mmap_filebuf.h>
+   *  @brief  A filebuf that reads regular files through mmap.
+   *
+   *  When opened with a mode of @c ios_base::in (optionally with
+   *  @c binary) on a regular, non-empty file, and no character
+   *  conversion is needed, the whole file is mapped read-only and the
+   *  get area is set directly onto the mapping: reads, seeks and
+   *  @c sgetn never copy through an intermediate buffer or make a
+   *  system call.  The mapping is advised as sequential so the kernel
+   *  reads ahead aggressively.
+   *
+   *  In every other case (output modes, pipes, files too large to
+   *  map, converting codecvts) it behaves exactly like
+   *  std::basic_filebuf.  Use it in place of the filebuf of an
+   *  ifstream:
+   *
+   *  @code
+   *    __gnu_cxx::mmap_filebuf<char> __buf;
+   *    __buf.open("index.dat", std::ios_base::in);
+   *    std::istream __is(&__buf);
+   *  @endcode
+  */
+  template<typename _CharT, typename _Traits = std::char_traits<_CharT> >
+    class mmap_filebuf : public std::basic_filebuf<_CharT, _Traits>
+    {
+    public:
+      // Types:
+      typedef _CharT				        char_type;
+      typedef _Traits				        traits_type;
+      typedef typename traits_type::int_type		int_type;
+      typedef typename traits_type::pos_type		pos_type;
+      typedef typename traits_type::off_type		off_type;
+      typedef std::size_t                               size_t;
+
+      typedef std::basic_streambuf<_CharT, _Traits>	__streambuf_type;
+      typedef std::basic_filebuf<_CharT, _Traits>	__filebuf_type;
+
+    protected:
+      // Start and length of the mapping, or 0 if not mapped.
+      char_type*		_M_map;
+      size_t			_M_map_size;
+
+    public:
+      mmap_filebuf() : __filebuf_type(), _M_map(0), _M_map_size(0) { }
+
+      /**
+       *  Unmaps the file; the base destructor then closes it.
+      */
+      virtual
+      ~mmap_filebuf()
+      { _M_unmap(); }
+
+      /**
+       *  @brief  Opens an external file, mapping it when possible.
+       *  @param  s  The name of the file.
+       *  @param  mode  The open mode flags.
+       *  @return  @c this on success, NULL on failure
+      */
+      mmap_filebuf*
+      open(const char* __s, std::ios_base::openmode __mode)
+      {
+	if (!__filebuf_type::open(__s, __mode))
+	  return 0;
+	if ((__mode & ~std::ios_base::binary) == std::ios_base::in)
+	  _M_try_map();
+	return this;
+      }
+
+      /**
+       *  @brief  Closes the currently associated file.
+       *  @return  @c this on success, NULL on failure
+      */
+      mmap_filebuf*
+      close() throw()
+      {
+	_M_unmap();
+	return __filebuf_type::close() ? this : 0;
+      }
+
+      /**
+       *  @return  True if the get area is the file mapping.
+      */
+      bool
+      is_mapped() const { return _M_map != 0; }
+
+    protected:
+      void
+      _M_try_map();
+
+      void
+      _M_unmap() throw();
+
+      // [documentation is inherited]
+      virtual std::streamsize
+      showmanyc()
+      {
+	if (_M_map)
+	  return this->egptr() - this->gptr();
+	return __filebuf_type::showmanyc();
+      }
+
+      // [documentation is inherited]
+      virtual int_type
+      underflow()
+      {
+	if (_M_map)
+	  return this->gptr() < this->egptr()
+	    ? traits_type::to_int_type(*this->gptr()) : traits_type::eof();
+	return __filebuf_type::underflow();
+      }
+
+      // The mapping is read-only, so only a putback of the character
+      // already there (handled by sputbackc itself) can succeed.
+      // [documentation is inherited]
+      virtual int_type
+      pbackfail(int_type __c = _Traits::eof())
+      {
+	if (_M_map)
+	  return traits_type::eof();
+	return __filebuf_type::pbackfail(__c);
+      }
+
+      // [documentation is inherited]
+      virtual __streambuf_type*
+      setbuf(char_type* __s, std::streamsize __n)
+      {
+	if (_M_map)
+	  return this;
+	return __filebuf_type::setbuf(__s, __n);
+      }
+
+      // [documentation is inherited]
+      virtual pos_type
+      seekoff(off_type __off, std::ios_base::seekdir __way,
+	      std::ios_base::openmode __mode = std::ios_base::in
+						| std::ios_base::out)
+      {
+	if (!_M_map)
+	  return __filebuf_type::seekoff(__off, __way, __mode);
+
+	off_type __pos = __off;
+	if (__way == std::ios_base::cur)
+	  __pos += this->gptr() - this->eback();
+	else if (__way == std::ios_base::end)
+	  __pos += _M_map_size;
+	if (__pos < 0 || __pos > off_type(_M_map_size))
+	  return pos_type(off_type(-1));
+	this->setg(_M_map, _M_map + __pos, _M_map + _M_map_size);
+	return pos_type(__pos);
+      }
+
+      // [documentation is inherited]
+      virtual pos_type
+      seekpos(pos_type __pos,
+	      std::ios_base::openmode __mode = std::ios_base::in
+					       | std::ios_base::out)
+      {
+	if (!_M_map)
+	  return __filebuf_type::seekpos(__pos, __mode);
+	return this->seekoff(off_type(__pos), std::ios_base::beg, __mode);
+      }
+
+      // [documentation is inherited]
+      virtual int
+      sync()
+      {
+	if (_M_map)
+	  return 0;
+	return __filebuf_type::sync();
+      }
+
+      // basic_filebuf::xsgetn reads large requests straight from the
+      // file descriptor, bypassing the get area; with a mapping the
+      // generic copy out of the get area is what we want.
+      // [documentation is inherited]
+      virtual std::streamsize
+      xsgetn(char_type* __s, std::streamsize __n)
+      {
+	if (_M_map)
+	  return __streambuf_type::xsgetn(__s, __n);
+	return __filebuf_type::xsgetn(__s, __n);
+      }
+    };
+
+  template<typename _CharT, typename _Traits>
+    void
+    mmap_filebuf<_CharT, _Traits>::
+    _M_try_map()
+    {
+      if (sizeof(char_type) != 1
+	  || !this->_M_codecvt || !this->_M_codecvt->always_noconv())
+	return;
+
+      const int __fd = this->_M_file.fd();
+      struct stat __st;
+      if (fstat(__fd, &__st) != 0 || !S_ISREG(__st.st_mode)
+	  || __st.st_size <= 0)
+	return;
+
+      const size_t __len = __st.st_size;
+      void* __p = mmap(0, __len, PROT_READ, MAP_SHARED, __fd, 0);
+      if (__p == MAP_FAILED)
+	return;
+      // uClibc has no posix_fadvise; on a mapping madvise gives the
+      // same read-ahead hint.
+      madvise(__p, __len, MADV_SEQUENTIAL);
+
+      _M_map = static_cast<char_type*>(__p);
+      _M_map_size = __len;
+      this->_M_reading = true;
+      this->setg(_M_map, _M_map, _M_map + _M_map_size);
+    }
+
+  template<typename _CharT, typename _Traits>
+    void
+    mmap_filebuf<_CharT, _Traits>::
+    _M_unmap() throw()
+    {
+      if (_M_map)
+	{
+	  munmap(_M_map, _M_map_size);
+	  _M_map = 0;
+	  _M_map_size = 0;
+	  this->_M_reading = false;
+	  this->_M_set_buffer(-1);
+	}
+    }
+} // namespace __gnu_cxx
+
+#endif
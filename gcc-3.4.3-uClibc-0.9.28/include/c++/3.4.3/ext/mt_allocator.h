@@ -37,12 +37,107 @@
 
 #include <new>
 #include <cstdlib>
+#include <cstring>
 #include <bits/functexcept.h>
 #include <bits/gthr.h>
 #include <bits/atomicity.h>
 
+// write(2), declared here so that <ext/mt_allocator.h> does not bring
+// in all of <unistd.h>.
+extern "C" ssize_t write(int, const void*, size_t) __THROW;
+
 namespace __gnu_cxx
 {
+  /**
+   *  Usage counts of one bin of a __mt_alloc, for one thread id (0
+   *  being the global pool).  Filled in by __mt_alloc::_S_get_stats.
+   */
+  struct __mt_alloc_stats
+  {
+    // Size in bytes of the blocks of this bin.
+    size_t	_M_bin_bytes;
+
+    // Thread id, as assigned by the allocator; 0 is the global pool.
+    size_t	_M_thread_id;
+
+    // Calls to allocate() and deallocate() made by this thread.
+    size_t	_M_allocated;
+    size_t	_M_deallocated;
+
+    // Blocks now on this thread's freelist, and blocks owned by this
+    // thread now in use, with the highest value the latter reached.
+    size_t	_M_free;
+    size_t	_M_used;
+    size_t	_M_peak_used;
+
+    // Times the thread's freelist was found empty and refilled, from
+    // the global pool or a new chunk.
+    size_t	_M_refills;
+
+    // Blocks handed back to the global pool because the freelist
+    // exceeded _M_freelist_headroom.
+    size_t	_M_returned;
+
+    // Chunks of _M_chunk_size bytes obtained from operator new.
+    // Chunks are never released, so this is also the peak footprint.
+    size_t	_M_chunks;
+  };
+
+  // Formats a line of statistics without stdio or malloc, so that
+  // __mt_alloc can print them from a signal handler.
+  class __mt_alloc_stats_line
+  {
+    char	_M_buf[192];
+    char*	_M_p;
+
+  public:
+    __mt_alloc_stats_line() : _M_p(_M_buf) { }
+
+    __mt_alloc_stats_line&
+    operator<<(const char* __s)
+    {
+      while (*__s && _M_p < _M_buf + sizeof(_M_buf))
+	*_M_p++ = *__s++;
+      return *this;
+    }
+
+    __mt_alloc_stats_line&
+    operator<<(size_t __n)
+    {
+      char __digits[3 * sizeof(size_t)];
+      char* __d = __digits + sizeof(__digits);
+      *--__d = '\0';
+      do
+	{
+	  *--__d = '0' + __n % 10;
+	  __n /= 10;
+	}
+      while (__n);
+      return *this << static_cast<const char*>(__d);
+    }
+
+    void
+    _M_write(int __fd)
+    {
+      const char* __s = _M_buf;
+      while (__s < _M_p)
+	{
+	  const ssize_t __n = ::write(__fd, __s, _M_p - __s);
+	  if (__n <= 0)
+	    break;
+	  __s += __n;
+	}
+      _M_p = _M_buf;
+    }
+  };
+
+  // Defined in the one source file that defines
+  // _GLIBCXX_MT_ALLOC_STATS_DEFINE; see <bits/mt_alloc_stats.h>.
+  // Each instantiation with statistics registers _S_print_stats here,
+  // if it is linked in.
+  extern void
+  __mt_alloc_stats_register(void (*)(int)) __attribute__((__weak__));
+
   /**
    *  This is a fixed size (power of 2) allocator which - when
    *  compiled with thread support - will maintain one freelist per
@@ -52,6 +147,55 @@ namespace __gnu_cxx
    *
    *  Further details:
    *  http://gcc.gnu.org/onlinedocs/libstdc++/ext/mt_allocator.html
+   *
+   *  @par Statistics
+   *  When GLIBCXX_MT_ALLOC_STATS is set in the environment at the
+   *  first allocation (or _Tune::_M_stats is set), every
+   *  instantiation counts, per bin and per thread, the allocations,
+   *  frees, blocks free and in use, peak blocks in use, freelist
+   *  refills, blocks returned to the global pool and chunks taken
+   *  from operator new, plus the requests too large for the bins.
+   *  _S_get_stats returns them as __mt_alloc_stats records and
+   *  _S_print_stats writes them as text.  Without the variable the
+   *  counters cost nothing but a test of the flag.
+   *
+   *  The text of every instantiation can also be written at exit, or
+   *  when a signal arrives, without changing the program: define
+   *  _GLIBCXX_MT_ALLOC_STATS_DEFINE in exactly one source file before
+   *  including <ext/mt_allocator.h>.  GLIBCXX_MT_ALLOC_STATS then
+   *  names where the text goes at exit: "1" or "stderr" for standard
+   *  error, anything else is a file name appended to.  If
+   *  GLIBCXX_MT_ALLOC_STATS_SIGNAL holds a signal number, the text is
+   *  also written each time that signal arrives.
+   *
+   *  @par Tuning
+   *  Each rebinding of the allocator (one per container node type)
+   *  has its own bins, and chunks are never given back, so the memory
+   *  held is the sum of "chunks * _M_chunk_size" over every bin of
+   *  every instantiation in the dump.  On a device with little RAM:
+   *
+   *  - Run the real workload with statistics on, and read the
+   *    "oversize" count of each instantiation: requests above
+   *    _M_max_bytes bypass the bins.  Raise _M_max_bytes only to the
+   *    bin that catches most of them; each extra bin costs at least
+   *    one chunk per thread that touches it.
+   *  - Compare each bin's peak blocks in use with its chunks times
+   *    the blocks per chunk (_M_chunk_size / (bin bytes + _M_align)).
+   *    Bins whose peak is a small fraction of one chunk waste most of
+   *    that chunk: lower _M_chunk_size, or leave small, rarely used
+   *    types on std::allocator.  Bins with many chunks and frequent
+   *    refills want a larger _M_chunk_size instead.
+   *  - Many blocks returned to the global pool, with refills on the
+   *    same threads, mean blocks ping-pong between threads: raise
+   *    _M_freelist_headroom.  Large free counts on threads that have
+   *    gone idle mean it is too high.
+   *  - _M_max_threads sizes arrays in every bin of every
+   *    instantiation (three words per thread, plus the statistics
+   *    when enabled); set it to the real thread count plus a margin
+   *    rather than the default 4096.
+   *
+   *  Options are set once, before the first allocation, through
+   *  _S_set_options.
    */
   template<typename _Tp>
     class __mt_alloc
@@ -153,25 +297,54 @@ namespace __gnu_cxx
 
 	// Set to true forces all allocations to use new().
 	bool 	_M_force_new; 
+
+	// Set to true collects usage statistics, see _S_get_stats.
+	bool 	_M_stats; 
      
 	explicit
 	_Tune()
 	: _M_align(8), _M_max_bytes(128), _M_min_bin(8),
 	  _M_chunk_size(4096 - 4 * sizeof(void*)), 
 	  _M_max_threads(4096), _M_freelist_headroom(10), 
-	  _M_force_new(getenv("GLIBCXX_FORCE_NEW") ? true : false)
+	  _M_force_new(getenv("GLIBCXX_FORCE_NEW") ? true : false),
+	  _M_stats(getenv("GLIBCXX_MT_ALLOC_STATS") ? true : false)
 	{ }
 
 	explicit
 	_Tune(size_t __align, size_t __maxb, size_t __minbin,
 	      size_t __chunk, size_t __maxthreads, size_t __headroom,
-	      bool __force) 
+	      bool __force, bool __stats = false) 
 	: _M_align(__align), _M_max_bytes(__maxb), _M_min_bin(__minbin),
 	  _M_chunk_size(__chunk), _M_max_threads(__maxthreads),
-	  _M_freelist_headroom(__headroom), _M_force_new(__force)
+	  _M_freelist_headroom(__headroom), _M_force_new(__force),
+	  _M_stats(__stats)
 	{ }
       };
 
+      /**
+       *  @brief  Usage statistics of this instantiation.
+       *  @param  buf  Array to receive the records.
+       *  @param  n  Size of @a buf.
+       *  @return  The number of records available, which may exceed
+       *           @a n.
+       *
+       *  One record is produced for each bin and thread id that has
+       *  seen any activity.  Returns 0 unless statistics are enabled.
+       *  The counters of other threads are read without locking, so
+       *  they may be slightly stale.
+      */
+      static size_t
+      _S_get_stats(__mt_alloc_stats* __buf, size_t __n);
+
+      /**
+       *  @brief  Writes the usage statistics as text.
+       *  @param  fd  File descriptor to write to.
+       *
+       *  Uses only write(2), so it may be called from a signal handler.
+      */
+      static void
+      _S_print_stats(int __fd);
+
     private:
       // We need to create the initial lists and set up some variables
       // before we can answer to the first request for memory.
@@ -197,6 +370,14 @@ namespace __gnu_cxx
 	  _S_options = __t;
       }
 
+      // Requests above _M_max_bytes, when statistics are enabled: how
+      // many, and the largest.
+      static _Atomic_word		_S_oversize;
+      static size_t			_S_oversize_max;
+
+      static bool
+      _S_get_bin_stats(size_t __which, size_t __id, __mt_alloc_stats& __st);
+
       // Using short int as type for the binmap implies we are never
       // caching blocks larger than 65535 with this allocator
       typedef unsigned short int        _Binmap_type;
@@ -263,6 +444,11 @@ namespace __gnu_cxx
 	// is initialized in _S_initialize().
         __gthread_mutex_t*              _M_mutex;
 #endif
+
+	// An "array" of counters for each thread id, allocated in
+	// _S_initialize() only when _M_stats is set; each is written
+	// by its own thread only.
+	__mt_alloc_stats*		_M_stats;
       };
 
       // An "array" of bin_records each of which represents a specific
@@ -299,6 +485,13 @@ namespace __gnu_cxx
       const size_t __bytes = __n * sizeof(_Tp);
       if (__bytes > _S_options._M_max_bytes || _S_options._M_force_new)
 	{
+	  if (__builtin_expect(_S_options._M_stats, false)
+	      && !_S_options._M_force_new)
+	    {
+	      __atomic_add(&_S_oversize, 1);
+	      if (__bytes > _S_oversize_max)
+		_S_oversize_max = __bytes;
+	    }
 	  void* __ret = ::operator new(__bytes);
 	  return static_cast<_Tp*>(__ret);
 	}
@@ -311,8 +504,14 @@ namespace __gnu_cxx
       // and use them directly without having to lock anything.
       const _Bin_record& __bin = _S_bin[__which];
       _Block_record* __block = NULL;
+      __mt_alloc_stats* __stats = NULL;
+      if (__builtin_expect(_S_options._M_stats, false))
+	__stats = &__bin._M_stats[__thread_id];
       if (__bin._M_first[__thread_id] == NULL)
 	{
+	  if (__stats)
+	    ++__stats->_M_refills;
+
 	  // NB: For alignment reasons, we can't use the first _M_align
 	  // bytes, even when sizeof(_Block_record) < _M_align.
 	  const size_t __bin_size = ((_S_options._M_min_bin << __which)
@@ -342,6 +541,8 @@ namespace __gnu_cxx
 		  void* __v = ::operator new(_S_options._M_chunk_size);
 		  __bin._M_first[__thread_id] = static_cast<_Block_record*>(__v);
 		  __bin._M_free[__thread_id] = __block_count;
+		  if (__stats)
+		    ++__stats->_M_chunks;
 
 		  --__block_count;
 		  __block = __bin._M_first[__thread_id];
@@ -384,6 +585,8 @@ namespace __gnu_cxx
 	    {
 	      void* __v = ::operator new(_S_options._M_chunk_size);
 	      __bin._M_first[0] = static_cast<_Block_record*>(__v);
+	      if (__stats)
+		++__stats->_M_chunks;
 	      
 	      --__block_count;
 	      __block = __bin._M_first[0];
@@ -408,6 +611,22 @@ namespace __gnu_cxx
 	}
 #endif
 
+      if (__stats)
+	{
+	  const size_t __used = ++__stats->_M_allocated
+	                        - __stats->_M_deallocated;
+#ifdef __GTHREADS
+	  if (__gthread_active_p())
+	    {
+	      if (__bin._M_used[__thread_id] > __stats->_M_peak_used)
+		__stats->_M_peak_used = __bin._M_used[__thread_id];
+	    }
+	  else
+#endif
+	  if (__used > __stats->_M_peak_used)
+	    __stats->_M_peak_used = __used;
+	}
+
       char* __c = reinterpret_cast<char*>(__block) + _S_options._M_align;
       return static_cast<_Tp*>(static_cast<void*>(__c));
     }
@@ -440,6 +659,12 @@ namespace __gnu_cxx
 	  // in order to avoid too much contention we wait until the
 	  // number of records is "high enough".
 	  const size_t __thread_id = _S_get_thread_id();
+	  __mt_alloc_stats* __stats = NULL;
+	  if (__builtin_expect(_S_options._M_stats, false))
+	    {
+	      __stats = &__bin._M_stats[__thread_id];
+	      ++__stats->_M_deallocated;
+	    }
 
 	  long __remove = ((__bin._M_free[__thread_id]
 			    * _S_options._M_freelist_headroom)
@@ -457,6 +682,8 @@ namespace __gnu_cxx
 		__tmp = __tmp->_M_next;
 	      __bin._M_first[__thread_id] = __tmp->_M_next;
 	      __bin._M_free[__thread_id] -= __removed;
+	      if (__stats)
+		__stats->_M_returned += __removed;
 
 	      __gthread_mutex_lock(__bin._M_mutex);
 	      __tmp->_M_next = __bin._M_first[0];
@@ -480,6 +707,8 @@ namespace __gnu_cxx
 	  // Single threaded application - return to global pool.
 	  __block->_M_next = __bin._M_first[0];
 	  __bin._M_first[0] = __block;
+	  if (__builtin_expect(_S_options._M_stats, false))
+	    ++__bin._M_stats[0]._M_deallocated;
 	}
     }
   
@@ -615,7 +844,179 @@ namespace __gnu_cxx
 	    __bin._M_first[0] = NULL;
 	  }
 
+      // One record per thread id and the global pool, or just the
+      // global pool without threads.
+      size_t __stats_count = 1;
+#ifdef __GTHREADS
+      if (__gthread_active_p())
+	__stats_count += _S_options._M_max_threads;
+#endif
+      for (size_t __n = 0; __n < _S_bin_size; ++__n)
+	{
+	  _Bin_record& __bin = _S_bin[__n];
+	  __bin._M_stats = NULL;
+	  if (_S_options._M_stats)
+	    {
+	      const size_t __k = sizeof(__mt_alloc_stats) * __stats_count;
+	      __v = ::operator new(__k);
+	      __bin._M_stats = static_cast<__mt_alloc_stats*>(__v);
+	      std::memset(__v, 0, __k);
+	    }
+	}
+
       _S_init = true;
+
+      if (_S_options._M_stats && __mt_alloc_stats_register)
+	__mt_alloc_stats_register(_S_print_stats);
+    }
+
+  template<typename _Tp>
+    bool
+    __mt_alloc<_Tp>::
+    _S_get_bin_stats(size_t __which, size_t __id, __mt_alloc_stats& __st)
+    {
+      const _Bin_record& __bin = _S_bin[__which];
+      __st = __bin._M_stats[__id];
+      __st._M_bin_bytes = _S_options._M_min_bin << __which;
+      __st._M_thread_id = __id;
+#ifdef __GTHREADS
+      if (__gthread_active_p())
+	{
+	  __st._M_free = __bin._M_free[__id];
+	  __st._M_used = __bin._M_used[__id];
+	}
+      else
+#endif
+	{
+	  const size_t __per_chunk = (_S_options._M_chunk_size
+				      / (__st._M_bin_bytes
+					 + _S_options._M_align));
+	  __st._M_used = __st._M_allocated - __st._M_deallocated;
+	  __st._M_free = __st._M_chunks * __per_chunk - __st._M_used;
+	}
+      return (__st._M_allocated || __st._M_deallocated
+	      || __st._M_free || __st._M_used);
+    }
+
+  template<typename _Tp>
+    size_t
+    __mt_alloc<_Tp>::
+    _S_get_stats(__mt_alloc_stats* __buf, size_t __n)
+    {
+      if (!_S_init || !_S_options._M_stats || _S_options._M_force_new)
+	return 0;
+
+      size_t __max_threads = 1;
+#ifdef __GTHREADS
+      if (__gthread_active_p())
+	__max_threads += _S_options._M_max_threads;
+#endif
+
+      size_t __count = 0;
+      for (size_t __which = 0; __which < _S_bin_size; ++__which)
+	for (size_t __id = 0; __id < __max_threads; ++__id)
+	  {
+	    __mt_alloc_stats __st;
+	    if (!_S_get_bin_stats(__which, __id, __st))
+	      continue;
+	    if (__count < __n)
+	      __buf[__count] = __st;
+	    ++__count;
+	  }
+      return __count;
+    }
+
+  template<typename _Tp>
+    void
+    __mt_alloc<_Tp>::
+    _S_print_stats(int __fd)
+    {
+      // Name the instantiation after _Tp, as the compiler spells it.
+      const char* __name = __PRETTY_FUNCTION__;
+      const char* __with = std::strstr(__name, "_Tp = ");
+      const char* __end;
+      if (__with)
+	{
+	  __name = __with + 6;
+	  __end = __name + std::strlen(__name);
+	  if (__end > __name && __end[-1] == ']')
+	    --__end;
+	}
+      else
+	{
+	  __name = "?";
+	  __end = __name + 1;
+	}
+
+      __mt_alloc_stats_line __line;
+      __line << "__mt_alloc<";
+      __line._M_write(__fd);
+      ::write(__fd, __name, __end - __name);
+      __line << ">: ";
+      if (!_S_init || !_S_options._M_stats || _S_options._M_force_new)
+	{
+	  __line << "no statistics\n";
+	  __line._M_write(__fd);
+	  return;
+	}
+      __line << "max_bytes " << _S_options._M_max_bytes
+	     << " chunk_size " << _S_options._M_chunk_size
+	     << " oversize " << static_cast<size_t>(_S_oversize)
+	     << " (largest " << _S_oversize_max << ")\n";
+      __line._M_write(__fd);
+
+      size_t __max_threads = 1;
+#ifdef __GTHREADS
+      if (__gthread_active_p())
+	__max_threads += _S_options._M_max_threads;
+#endif
+
+      // A summary line per bin, then one per thread using it.
+      for (size_t __which = 0; __which < _S_bin_size; ++__which)
+	{
+	  __mt_alloc_stats __total;
+	  std::memset(&__total, 0, sizeof(__total));
+	  for (size_t __id = 0; __id < __max_threads; ++__id)
+	    {
+	      __mt_alloc_stats __st;
+	      if (!_S_get_bin_stats(__which, __id, __st))
+		continue;
+	      __total._M_allocated += __st._M_allocated;
+	      __total._M_deallocated += __st._M_deallocated;
+	      __total._M_free += __st._M_free;
+	      __total._M_used += __st._M_used;
+	      __total._M_peak_used += __st._M_peak_used;
+	      __total._M_refills += __st._M_refills;
+	      __total._M_returned += __st._M_returned;
+	      __total._M_chunks += __st._M_chunks;
+	    }
+	  if (!__total._M_chunks)
+	    continue;
+
+	  __line << "  bin " << (_S_options._M_min_bin << __which)
+		 << ": chunks " << __total._M_chunks
+		 << " (" << __total._M_chunks * _S_options._M_chunk_size
+		 << " bytes) in use " << __total._M_used
+		 << " free " << __total._M_free << "\n";
+	  __line._M_write(__fd);
+
+	  for (size_t __id = 0; __id < __max_threads; ++__id)
+	    {
+	      __mt_alloc_stats __st;
+	      if (!_S_get_bin_stats(__which, __id, __st))
+		continue;
+	      __line << "    thread " << __id
+		     << ": alloc " << __st._M_allocated
+		     << " dealloc " << __st._M_deallocated
+		     << " in use " << __st._M_used
+		     << " (peak " << __st._M_peak_used
+		     << ") free " << __st._M_free
+		     << " refills " << __st._M_refills
+		     << " returned " << __st._M_returned
+		     << " chunks " << __st._M_chunks << "\n";
+	      __line._M_write(__fd);
+	    }
+	}
     }
 
   template<typename _Tp>
@@ -693,6 +1094,12 @@ namespace __gnu_cxx
   template<typename _Tp> 
     size_t __mt_alloc<_Tp>::_S_bin_size = 1;
 
+  template<typename _Tp> 
+    _Atomic_word __mt_alloc<_Tp>::_S_oversize = 0;
+
+  template<typename _Tp> 
+    size_t __mt_alloc<_Tp>::_S_oversize_max = 0;
+
   // Actual initialization in _S_initialize().
 #ifdef __GTHREADS
   template<typename _Tp> 
@@ -715,4 +1122,8 @@ namespace __gnu_cxx
 #endif
 } // namespace __gnu_cxx
 
+#ifdef _GLIBCXX_MT_ALLOC_STATS_DEFINE
+# include <bits/mt_alloc_stats.h>
+#endif
+
 #endif
@@ -0,0 +1,368 @@
+// Rope-backed scatter/gather output buffer -*- C++ -*-
+
+// Copyright (C) 2004 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 2, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING.  If not, write to the Free
+// Software Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+// USA.
+
+// As a special exception, you may use this file as part of a free software
+// library without restriction.  Specifically, if other files instantiate
+// templates or use macros or inline functions from this file, or you compile
+// this file and link it with other files to produce an executable, this
+// file does not by itself cause the resulting executable to be covered by
+// the GNU General Public License.  This exception does not however
+// invalidate any other reasons why the executable file might be covered by
+// the GNU General Public License.
+
+/** @file ext/rope_streambuf.h
+ *  This file is a GNU extension to the Standard C++ Library.
+ */
+
+#ifndef _ROPE_STREAMBUF_H
+#define _ROPE_STREAMBUF_H 1
+
+#pragma GCC system_header
+
+#include <streambuf>
+#include <ext/rope>
+#include <cerrno>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace __gnu_cxx
+{
+  // A char_producer for a buffer the rope does not own.  The rope
+  // refers to the characters instead of copying them, and
+  // rope_ostreambuf hands them to writev directly.
+  template<typename _CharT>
+    class __rope_extern_buffer : public char_producer<_CharT>
+    {
+    public:
+      explicit
+      __rope_extern_buffer(const _CharT* __s) : _M_s(__s) { }
+
+      virtual void
+      operator()(size_t __start, size_t __len, _CharT* __buffer)
+      { std::copy(_M_s + __start, _M_s + __start + __len, __buffer); }
+
+      const _CharT*	_M_s;
+    };
+
+  /**
+   *  @class rope_ostreambuf ext/rope_streambuf.h <ext/rope_streambuf.h>
+   *  @brief  An output buffer that assembles a rope and writes it with
+   *  writev.
+   *
+   *  Formatted output and @c sputn copy into a small put area that is
+   *  appended to a rope as a leaf whenever it fills up.  append_ref()
+   *  and append() add external buffers and whole ropes by reference,
+   *  so static templates, cached fragments and payloads are never
+   *  copied or linearized.
+   *
+   *  sync() (and so @c flush) gathers the leaves and referenced
+   *  buffers into iovecs and writes them to the file descriptor with
+   *  writev, then releases the rope.  If a write fails, sync()
+   *  returns -1 and keeps only the characters not yet written, so a
+   *  later sync() resumes where it stopped.  A buffer passed to
+   *  append_ref() must stay valid and unchanged until it has been
+   *  written.  The destructor syncs, as basic_filebuf does.
+   *
+   *  @code
+   *    __gnu_cxx::rope_ostreambuf<char> __buf(__sock);
+   *    std::ostream __os(&__buf);
+   *    __buf.append_ref(__hdr, __hdr_len);
+   *    __os << "Content-Length: " << __len << "\r\n\r\n";
+   *    __buf.append_ref(__payload, __len);
+   *    __os.flush();
+   *  @endcode
+  */
+  template<typename _CharT, typename _Traits = std::char_traits<_CharT>,
+	   typename _Alloc = std::allocator<_CharT> >
+    class rope_ostreambuf : public std::basic_streambuf<_CharT, _Traits>
+    {
+    public:
+      // Types:
+      typedef _CharT				        char_type;
+      typedef _Traits				        traits_type;
+      typedef typename traits_type::int_type		int_type;
+      typedef typename traits_type::pos_type		pos_type;
+      typedef typename traits_type::off_type		off_type;
+      typedef std::size_t                               size_t;
+      typedef __gnu_cxx::rope<_CharT, _Alloc>		rope_type;
+
+    protected:
+      typedef _Rope_RopeRep<_CharT, _Alloc>		_RopeRep;
+      typedef _Rope_RopeLeaf<_CharT, _Alloc>		_RopeLeaf;
+      typedef _Rope_RopeConcatenation<_CharT, _Alloc>	_RopeConcatenation;
+      typedef _Rope_RopeFunction<_CharT, _Alloc>	_RopeFunction;
+
+      // Size of the put area, and of the scratch buffer used to write
+      // out function nodes that do not refer to memory.
+      enum { _S_buf_size = 256 };
+      // iovecs gathered per writev call.
+      enum { _S_iov_max = 64 };
+
+      rope_type		_M_rope;
+      int		_M_fd;
+      // Bytes written so far by the sync in progress.
+      size_t		_M_written;
+      char_type		_M_buf[_S_buf_size];
+
+    public:
+      /**
+       *  @param  fd  Descriptor sync() writes to, or -1 to only
+       *              assemble the rope.
+      */
+      explicit
+      rope_ostreambuf(int __fd = -1)
+      : _M_rope(), _M_fd(__fd), _M_written(0)
+      { this->setp(_M_buf, _M_buf + _S_buf_size); }
+
+      virtual
+      ~rope_ostreambuf()
+      {
+	if (_M_fd >= 0)
+	  this->sync();
+      }
+
+      int
+      fd() const { return _M_fd; }
+
+      void
+      fd(int __fd) { _M_fd = __fd; }
+
+      /**
+       *  @brief  Appends [s, s + n) without copying it.
+      */
+      void
+      append_ref(const char_type* __s, size_t __n)
+      {
+	if (__n == 0)
+	  return;
+	_M_fold();
+	_M_rope.append(rope_type(new __rope_extern_buffer<_CharT>(__s),
+				 __n, true));
+      }
+
+      /**
+       *  @brief  Appends a rope; its tree is shared, not copied.
+      */
+      void
+      append(const rope_type& __r)
+      {
+	_M_fold();
+	_M_rope.append(__r);
+      }
+
+      /**
+       *  @return  The characters written since the last sync.
+      */
+      rope_type
+      str()
+      {
+	_M_fold();
+	return _M_rope;
+      }
+
+      /**
+       *  @return  The number of characters written since the last sync.
+      */
+      size_t
+      size() const
+      { return _M_rope.size() + (this->pptr() - this->pbase()); }
+
+      /**
+       *  @brief  Discards everything written since the last sync.
+      */
+      void
+      clear()
+      {
+	_M_rope = rope_type();
+	this->setp(_M_buf, _M_buf + _S_buf_size);
+      }
+
+    protected:
+      // [documentation is inherited]
+      virtual int_type
+      overflow(int_type __c = _Traits::eof())
+      {
+	_M_fold();
+	if (!traits_type::eq_int_type(__c, traits_type::eof()))
+	  {
+	    *this->pptr() = traits_type::to_char_type(__c);
+	    this->pbump(1);
+	    return __c;
+	  }
+	return traits_type::not_eof(__c);
+      }
+
+      // Anything that would not fit in the put area goes into the rope
+      // as its own leaf, in one copy.
+      // [documentation is inherited]
+      virtual std::streamsize
+      xsputn(const char_type* __s, std::streamsize __n)
+      {
+	if (__n <= this->epptr() - this->pptr())
+	  {
+	    traits_type::copy(this->pptr(), __s, __n);
+	    this->pbump(__n);
+	  }
+	else
+	  {
+	    _M_fold();
+	    if (__n < _S_buf_size)
+	      {
+		traits_type::copy(this->pptr(), __s, __n);
+		this->pbump(__n);
+	      }
+	    else
+	      _M_rope.append(__s, __n);
+	  }
+	return __n;
+      }
+
+      // [documentation is inherited]
+      virtual int
+      sync()
+      {
+	_M_fold();
+	if (_M_fd < 0 || _M_rope.empty())
+	  return 0;
+
+	struct iovec __iov[_S_iov_max];
+	int __cnt = 0;
+	_M_written = 0;
+	if (!_M_gather(_M_rope._M_tree_ptr, __iov, __cnt)
+	    || !_M_writev(__iov, __cnt))
+	  {
+	    // Full batches may already have gone out: keep only what
+	    // was not written, so the next sync does not repeat it.
+	    const size_t __done = _M_written / sizeof(char_type);
+	    _M_rope = _M_rope.substr(__done, _M_rope.size() - __done);
+	    return -1;
+	  }
+	_M_rope = rope_type();
+	return 0;
+      }
+
+      // Moves the put area into the rope.
+      void
+      _M_fold()
+      {
+	const size_t __n = this->pptr() - this->pbase();
+	if (__n)
+	  _M_rope.append(this->pbase(), __n);
+	this->setp(_M_buf, _M_buf + _S_buf_size);
+      }
+
+      bool
+      _M_push(struct iovec* __iov, int& __cnt, const char_type* __s,
+	      size_t __n)
+      {
+	if (__cnt == _S_iov_max && !_M_writev(__iov, __cnt))
+	  return false;
+	__iov[__cnt].iov_base = const_cast<char_type*>(__s);
+	__iov[__cnt].iov_len = __n * sizeof(char_type);
+	++__cnt;
+	return true;
+      }
+
+      // In-order walk of the tree: leaves and external buffers become
+      // iovecs; other function nodes are produced into a scratch
+      // buffer and written out on the spot.
+      bool
+      _M_gather(const _RopeRep* __r, struct iovec* __iov, int& __cnt)
+      {
+	switch (__r->_M_tag)
+	  {
+	  case _Rope_constants::_S_leaf:
+	    return _M_push(__iov, __cnt,
+			   static_cast<const _RopeLeaf*>(__r)->_M_data,
+			   __r->_M_size);
+	  case _Rope_constants::_S_concat:
+	    {
+	      const _RopeConcatenation* __c =
+		static_cast<const _RopeConcatenation*>(__r);
+	      return _M_gather(__c->_M_left, __iov, __cnt)
+		&& _M_gather(__c->_M_right, __iov, __cnt);
+	    }
+	  default:
+	    {
+	      char_producer<_CharT>* __fn =
+		static_cast<const _RopeFunction*>(__r)->_M_fn;
+	      if (__r->_M_tag == _Rope_constants::_S_function)
+		{
+		  __rope_extern_buffer<_CharT>* __ext =
+		    dynamic_cast<__rope_extern_buffer<_CharT>*>(__fn);
+		  if (__ext)
+		    return _M_push(__iov, __cnt, __ext->_M_s, __r->_M_size);
+		}
+	      if (!_M_writev(__iov, __cnt))
+		return false;
+	      char_type __scratch[_S_buf_size];
+	      for (size_t __pos = 0; __pos < __r->_M_size; )
+		{
+		  const size_t __len = std::min(size_t(_S_buf_size),
+						__r->_M_size - __pos);
+		  (*__fn)(__pos, __len, __scratch);
+		  __iov[0].iov_base = __scratch;
+		  __iov[0].iov_len = __len * sizeof(char_type);
+		  __cnt = 1;
+		  if (!_M_writev(__iov, __cnt))
+		    return false;
+		  __pos += __len;
+		}
+	      return true;
+	    }
+	  }
+      }
+
+      // Writes out and empties __iov, coping with short writes.
+      bool
+      _M_writev(struct iovec* __iov, int& __cnt)
+      {
+	struct iovec* __p = __iov;
+	int __left = __cnt;
+	__cnt = 0;
+	while (__left > 0)
+	  {
+	    ssize_t __ret = ::writev(_M_fd, __p, __left);
+	    if (__ret < 0)
+	      {
+		if (errno == EINTR)
+		  continue;
+		return false;
+	      }
+	    size_t __done = __ret;
+	    _M_written += __done;
+	    while (__left > 0 && __done >= __p->iov_len)
+	      {
+		__done -= __p->iov_len;
+		++__p;
+		--__left;
+	      }
+	    if (__left > 0)
+	      {
+		__p->iov_base = static_cast<char*>(__p->iov_base) + __done;
+		__p->iov_len -= __done;
+	      }
+	  }
+	return true;
+      }
+    };
+} // namespace __gnu_cxx
+
+#endif
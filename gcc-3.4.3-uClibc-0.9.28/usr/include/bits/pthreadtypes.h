@@ -117,15 +117,21 @@ typedef struct
 #endif
 
 #ifdef __USE_XOPEN2K
-/* POSIX spinlock data type.  */
-typedef volatile int pthread_spinlock_t;
+/* POSIX spinlock data type.  A ticket lock: the high half of
+   __sl_ticket is the next ticket to hand out, the low half the ticket
+   currently being served.  */
+typedef struct {
+  volatile unsigned int __sl_ticket;      /* Next ticket / now serving */
+  struct pthread_lock_stats *__sl_stats;  /* Contention counters, or NULL */
+} pthread_spinlock_t;
 
-/* POSIX barrier. */
+/* POSIX barrier.  A sense-reversing barrier; waiters sleep on the
+   futex word __ba_sense until the last arrival flips it. */
 typedef struct {
-  struct _pthread_fastlock __ba_lock; /* Lock to guarantee mutual exclusion */
-  int __ba_required;                  /* Threads needed for completion */
-  int __ba_present;                   /* Threads waiting */
-  _pthread_descr __ba_waiting;        /* Queue of waiting threads */
+  volatile int __ba_left;                 /* Threads still to arrive */
+  volatile int __ba_sense;                /* Flipped on each completion */
+  unsigned int __ba_required;             /* Threads needed for completion */
+  struct pthread_lock_stats *__ba_stats;  /* Contention counters, or NULL */
 } pthread_barrier_t;
 
 /* barrier attribute */
@@ -135,6 +141,17 @@ typedef struct {
 
 #endif
 
+#ifdef __USE_GNU
+/* Writer-preferring read-write lock built directly on futexes. */
+typedef struct {
+  volatile int __rw_state;                /* Readers holding, -1 if a writer */
+  volatile int __rw_writers;              /* Writers waiting to acquire */
+  volatile int __rw_sleepers;             /* Threads blocked in the kernel */
+  volatile int __rw_seq;                  /* Futex word, bumped on release */
+  struct pthread_lock_stats *__rw_stats;  /* Contention counters, or NULL */
+} pthread_fastrwlock_t;
+#endif
+
 
 /* Thread identifiers */
 typedef unsigned long int pthread_t;
@@ -0,0 +1,26 @@
+/* FNV-1a string hashing, shared by the uClibc table headers.
+ *
+ * GNU Library General Public License (LGPL) version 2 or later.
+ */
+
+#ifndef _BITS_UCLIBC_FNV_H
+#define _BITS_UCLIBC_FNV_H	1
+
+#define __UCLIBC_FNV_BASIS	2166136261U
+#define __UCLIBC_FNV_PRIME	16777619U
+
+/* The hash H extended by the byte C. */
+#define __uclibc_fnv1a_step(__h, __c) \
+  (((__h) ^ (unsigned char) (__c)) * __UCLIBC_FNV_PRIME)
+
+/* The hash H extended by the bytes of the string S.  Start from
+   __UCLIBC_FNV_BASIS for the plain FNV-1a hash of S. */
+static __inline unsigned int
+__uclibc_fnv1a (unsigned int __h, const char *__s)
+{
+  while (*__s != '\0')
+    __h = __uclibc_fnv1a_step (__h, *__s++);
+  return __h;
+}
+
+#endif /* _BITS_UCLIBC_FNV_H */
@@ -0,0 +1,1455 @@
+/* Thread-caching, size-class malloc for uClibc.
+ *
+ * GNU Library General Public License (LGPL) version 2 or later.
+ *
+ * An alternative to the __MALLOC_STANDARD__ allocator built into libc,
+ * whose single lock and boundary-tag heap suffer under many threads
+ * churning small C++ objects.  Define _MALLOC_TC_DEFINE in exactly one
+ * source file of the program before including <malloc.h>; that file
+ * then defines malloc, free, calloc, realloc, memalign, valloc,
+ * posix_memalign, mallinfo, mallopt, malloc_trim and malloc_stats,
+ * which take the place of the libc versions for the whole process.
+ * (Compilers newer than this one turn malloc plus memset into calloc;
+ * with those, build that file with -fno-builtin.)
+ *
+ * Memory comes from the kernel in 64 KiB spans aligned to their size,
+ * so the span owning any block is found by masking its address.
+ *
+ *  - Requests up to 8 KiB are rounded to one of 33 size classes (at
+ *    most 25% internal waste above 32 bytes).  Each span serves one
+ *    class; the first allocations from a fresh span bump a pointer, so
+ *    pages are only touched when used.
+ *  - Each thread keeps a short free list per class, bounded in length
+ *    and in total bytes (M_THREAD_CACHE_MAX), so the common malloc and
+ *    free take no lock at all.  Lists are refilled from and returned to
+ *    the per-class central lists in batches, under a per-class lock.
+ *  - Larger requests take a whole span from the pool, or above
+ *    M_MMAP_THRESHOLD (never more than a span) a mapping of their own.
+ *  - A span whose objects are all free goes back to the pool, which
+ *    keeps up to M_TRIM_THRESHOLD bytes of them resident, releases the
+ *    pages of up to M_TOP_PAD more with madvise(MADV_DONTNEED), and
+ *    unmaps the rest.  Spans that fill up and then free an object are
+ *    queued behind the partially used ones, so allocation keeps packing
+ *    the same few spans and lets the others drain empty.
+ *
+ * The thread caches are keyed with pthread_getspecific.  They are used
+ * only when the program is linked with libpthread (the references are
+ * weak, as in libstdc++'s gthr-posix.h); otherwise, and while a thread
+ * sets up its cache, everything goes through the central lists.
+ *
+ * malloc_profile_start() turns on a sampling heap profiler: about once
+ * every N bytes allocated by a thread, the allocation's call stack is
+ * taken by walking the frame pointer chain and the block is tracked
+ * until it is freed.  malloc_profile_dump() writes the estimated live
+ * and total bytes per call stack, a histogram by size class and the
+ * process mappings (to symbolize the addresses offline).  The walk
+ * needs the file defining _MALLOC_TC_DEFINE and the code to be profiled
+ * built with -fno-omit-frame-pointer (on ARM, in ARM state, which lays
+ * out APCS frames); it stops at the first frame without one.  Thumb
+ * code is not walked.  The DWARF unwinder is not used, as this
+ * toolchain's libgcc is built for setjmp/longjmp exceptions and has no
+ * _Unwind_Backtrace that can walk frames.  While the profiler is off,
+ * malloc pays one test of a global and free one test of the span
+ * header.
+ */
+
+#ifndef _MALLOC_H
+#error Always include <malloc.h> rather than <bits/uClibc_malloc_tc.h>
+#endif
+
+#ifndef _BITS_UCLIBC_MALLOC_TC_H
+#define _BITS_UCLIBC_MALLOC_TC_H	1
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma weak pthread_key_create
+#pragma weak pthread_getspecific
+#pragma weak pthread_setspecific
+#pragma weak pthread_self
+
+/* madvise and the values below are only exposed by <sys/mman.h> with
+   the BSD and misc extensions; spell them out so that a file compiled
+   in a strict ISO mode can still carry the allocator. */
+extern int madvise (void *__addr, size_t __len, int __advice) __THROW;
+#define __MALLOC_TC_MAP_ANON		0x20
+#define __MALLOC_TC_DONTNEED		4
+
+#define __MALLOC_TC_PAGE		4096
+#define __MALLOC_TC_SPAN		65536
+#define __MALLOC_TC_SPAN_MASK		(~(unsigned long) (__MALLOC_TC_SPAN - 1))
+/* Spans mapped at a time when the pool runs dry. */
+#define __MALLOC_TC_CHUNK		8
+#define __MALLOC_TC_NCLASS		33
+#define __MALLOC_TC_MAX_SMALL		8192
+/* Values of __class for spans that hold one large block. */
+#define __MALLOC_TC_POOLED		__MALLOC_TC_NCLASS
+#define __MALLOC_TC_MAPPED		(__MALLOC_TC_NCLASS + 1)
+/* pthread_getspecific value of a thread whose cache is gone. */
+#define __MALLOC_TC_DEAD		((struct __malloc_tc_cache *) -1)
+/* Threads that may be setting up a cache at the same time. */
+#define __MALLOC_TC_NBOOT		8
+/* Profiler: frames kept per stack, and hash table sizes. */
+#define __MALLOC_TC_DEPTH		16
+#define __MALLOC_TC_NBUCKET		256
+#define __MALLOC_TC_NSAMPLE		1024
+
+/**********************************************************************/
+/* Size classes. */
+
+/* 8, then 16 to 128 in steps of 16, then four classes per power of
+   two up to 8192. */
+static __inline unsigned int
+__malloc_tc_class (size_t __n)
+{
+  unsigned int __b;
+
+  if (__n <= 8)
+    return 0;
+  if (__n <= 128)
+    return (__n + 15) >> 4;
+  --__n;
+  __b = 31 - __builtin_clz (__n);
+  return 9 + (__b - 7) * 4 + ((__n >> (__b - 2)) & 3);
+}
+
+static __inline size_t
+__malloc_tc_class_size (unsigned int __c)
+{
+  unsigned int __b;
+
+  if (__c < 9)
+    return __c == 0 ? 8 : __c << 4;
+  __b = 7 + ((__c - 9) >> 2);
+  return ((size_t) 1 << __b) + ((size_t) (((__c - 9) & 3) + 1) << (__b - 2));
+}
+
+/* Objects moved between a thread cache and the central lists at once:
+   32 up to 256 bytes, then half as many for each power of two, but at
+   least 2.  A thread cache holds at most twice that many of a class. */
+static __inline unsigned int
+__malloc_tc_batch (unsigned int __c)
+{
+  if (__c < 13)
+    return 32;
+  if (__c >= 29)
+    return 2;
+  return 32 >> ((__c - 9) >> 2);
+}
+
+/**********************************************************************/
+/* Locks. */
+
+/* Taken with __pthread_futex_lock. */
+typedef volatile int __malloc_tc_lock_t;
+
+/**********************************************************************/
+/* State. */
+
+/* Header at the start of every span. */
+struct __malloc_tc_span
+{
+  struct __malloc_tc_span *__next;	/* Partial list or pool; NULL if full */
+  struct __malloc_tc_span *__prev;
+  void *__free;				/* Freed objects */
+  char *__bump;				/* Start of the never-used tail */
+  unsigned short int __class;
+  unsigned short int __used;		/* Objects out of this span */
+  size_t __size;			/* Object size, or span length */
+  unsigned int __recip;			/* 2^32 / __size, rounded up */
+  unsigned int __sampled;		/* Profiled blocks in this span */
+};
+
+#define __MALLOC_TC_HDR \
+  ((sizeof (struct __malloc_tc_span) + 7) & ~(size_t) 7)
+
+#define __malloc_tc_span_of(__p) \
+  ((struct __malloc_tc_span *) ((unsigned long) (__p) & __MALLOC_TC_SPAN_MASK))
+
+struct __malloc_tc_central
+{
+  __malloc_tc_lock_t __lock;
+  struct __malloc_tc_span __partial;	/* Sentinel of the partial spans */
+  unsigned long int __spans;		/* Spans serving this class */
+  unsigned long int __out;		/* Objects out of those spans */
+};
+
+struct __malloc_tc_bin
+{
+  void *__head;
+  unsigned int __count;
+};
+
+struct __malloc_tc_cache
+{
+  struct __malloc_tc_bin __bin[__MALLOC_TC_NCLASS];
+  size_t __bytes;			/* Total size of the cached objects */
+  struct __malloc_tc_cache *__next;	/* All caches, for mallinfo */
+  long int __sample_left;		/* Bytes to go until the next sample */
+  unsigned int __sample_seed;
+};
+
+static struct __malloc_tc_central __malloc_tc_central[__MALLOC_TC_NCLASS];
+
+static struct
+{
+  __malloc_tc_lock_t __lock;
+  struct __malloc_tc_span *__dirty;	/* Free spans, still resident */
+  struct __malloc_tc_span *__clean;	/* Free spans without pages */
+  unsigned long int __ndirty;
+  unsigned long int __nclean;
+  unsigned long int __mapped;		/* Spans mapped, in all */
+  unsigned long int __max_mapped;
+  unsigned long int __pooled;		/* Spans holding a large block */
+  unsigned long int __large;		/* Dedicated mappings */
+  unsigned long int __large_bytes;
+} __malloc_tc_pool;
+
+/* Tunables, see mallopt. */
+static size_t __malloc_tc_trim_threshold = 256 * 1024;
+static size_t __malloc_tc_top_pad = 1024 * 1024;
+static size_t __malloc_tc_mmap_threshold = __MALLOC_TC_SPAN;
+static size_t __malloc_tc_cache_max = 64 * 1024;
+
+/* 0 before the first call, 1 if thread caches are in use, -1 if not. */
+static volatile int __malloc_tc_key_state;
+static pthread_key_t __malloc_tc_key;
+static volatile pthread_t __malloc_tc_booting[__MALLOC_TC_NBOOT];
+static __malloc_tc_lock_t __malloc_tc_caches_lock;
+static struct __malloc_tc_cache *__malloc_tc_caches;
+
+/**********************************************************************/
+/* Span pool. */
+
+/* Maps LEN bytes at a span-aligned address. */
+static void *
+__malloc_tc_map (size_t __len)
+{
+  char *__p;
+  char *__a;
+
+  __p = (char *) mmap (NULL, __len + __MALLOC_TC_SPAN, PROT_READ | PROT_WRITE,
+		       MAP_PRIVATE | __MALLOC_TC_MAP_ANON, -1, 0);
+  if (__p == (char *) MAP_FAILED)
+    return NULL;
+  __a = (char *) (((unsigned long) __p + __MALLOC_TC_SPAN - 1)
+		  & __MALLOC_TC_SPAN_MASK);
+  if (__a != __p)
+    munmap (__p, __a - __p);
+  munmap (__a + __len, __p + __MALLOC_TC_SPAN - __a);
+  return __a;
+}
+
+static struct __malloc_tc_span *
+__malloc_tc_span_get (void)
+{
+  struct __malloc_tc_span *__s;
+  char *__p;
+  int __n;
+  int __i;
+
+  __pthread_futex_lock (&__malloc_tc_pool.__lock);
+  if ((__s = __malloc_tc_pool.__dirty) != NULL)
+    {
+      __malloc_tc_pool.__dirty = __s->__next;
+      --__malloc_tc_pool.__ndirty;
+    }
+  else if ((__s = __malloc_tc_pool.__clean) != NULL)
+    {
+      __malloc_tc_pool.__clean = __s->__next;
+      --__malloc_tc_pool.__nclean;
+    }
+  __pthread_futex_unlock (&__malloc_tc_pool.__lock);
+  if (__s != NULL)
+    return __s;
+
+  __n = __MALLOC_TC_CHUNK;
+  __p = (char *) __malloc_tc_map (__n * __MALLOC_TC_SPAN);
+  if (__p == NULL)
+    {
+      __n = 1;
+      __p = (char *) __malloc_tc_map (__MALLOC_TC_SPAN);
+      if (__p == NULL)
+	return NULL;
+    }
+
+  __pthread_futex_lock (&__malloc_tc_pool.__lock);
+  __malloc_tc_pool.__mapped += __n;
+  if (__malloc_tc_pool.__mapped > __malloc_tc_pool.__max_mapped)
+    __malloc_tc_pool.__max_mapped = __malloc_tc_pool.__mapped;
+  for (__i = 1; __i < __n; ++__i)
+    {
+      __s = (struct __malloc_tc_span *) (__p + __i * __MALLOC_TC_SPAN);
+      __s->__next = __malloc_tc_pool.__clean;
+      __malloc_tc_pool.__clean = __s;
+      ++__malloc_tc_pool.__nclean;
+    }
+  __pthread_futex_unlock (&__malloc_tc_pool.__lock);
+  return (struct __malloc_tc_span *) __p;
+}
+
+static void
+__malloc_tc_span_put (struct __malloc_tc_span *__s)
+{
+  __pthread_futex_lock (&__malloc_tc_pool.__lock);
+  if ((__malloc_tc_pool.__ndirty + 1) * __MALLOC_TC_SPAN
+      <= __malloc_tc_trim_threshold)
+    {
+      __s->__next = __malloc_tc_pool.__dirty;
+      __malloc_tc_pool.__dirty = __s;
+      ++__malloc_tc_pool.__ndirty;
+      __pthread_futex_unlock (&__malloc_tc_pool.__lock);
+      return;
+    }
+  if ((__malloc_tc_pool.__nclean + 1) * __MALLOC_TC_SPAN
+      <= __malloc_tc_top_pad)
+    {
+      /* Count it now so that concurrent puts respect the limit. */
+      ++__malloc_tc_pool.__nclean;
+      __pthread_futex_unlock (&__malloc_tc_pool.__lock);
+      madvise (__s, __MALLOC_TC_SPAN, __MALLOC_TC_DONTNEED);
+      __pthread_futex_lock (&__malloc_tc_pool.__lock);
+      __s->__next = __malloc_tc_pool.__clean;
+      __malloc_tc_pool.__clean = __s;
+      __pthread_futex_unlock (&__malloc_tc_pool.__lock);
+      return;
+    }
+  --__malloc_tc_pool.__mapped;
+  __pthread_futex_unlock (&__malloc_tc_pool.__lock);
+  munmap (__s, __MALLOC_TC_SPAN);
+}
+
+/**********************************************************************/
+/* Central lists. */
+
+/* Takes up to WANT objects of class C, linked through their first
+   word, into *LIST.  Returns how many it got; zero means out of
+   memory. */
+static unsigned int
+__malloc_tc_fetch (unsigned int __c, unsigned int __want, void **__list)
+{
+  struct __malloc_tc_central *__cl = &__malloc_tc_central[__c];
+  struct __malloc_tc_span *__head = &__cl->__partial;
+  struct __malloc_tc_span *__s;
+  const size_t __size = __malloc_tc_class_size (__c);
+  void *__first = NULL;
+  void *__obj;
+  unsigned int __got = 0;
+
+  __pthread_futex_lock (&__cl->__lock);
+  if (__head->__next == NULL)
+    __head->__next = __head->__prev = __head;
+  while (__got < __want)
+    {
+      __s = __head->__next;
+      if (__s == __head)
+	{
+	  /* Getting a span may have to map one; do not make the other
+	     users of this class wait for that. */
+	  __pthread_futex_unlock (&__cl->__lock);
+	  __s = __malloc_tc_span_get ();
+	  __pthread_futex_lock (&__cl->__lock);
+	  if (__s == NULL)
+	    break;
+	  __s->__free = NULL;
+	  __s->__bump = (char *) __s + __MALLOC_TC_HDR;
+	  __s->__class = __c;
+	  __s->__used = 0;
+	  __s->__size = __size;
+	  __s->__recip = 0xffffffffU / __size + 1;
+	  __s->__sampled = 0;
+	  __s->__prev = __head;
+	  __s->__next = __head->__next;
+	  __head->__next->__prev = __s;
+	  __head->__next = __s;
+	  ++__cl->__spans;
+	}
+      if (__s->__free != NULL)
+	{
+	  __obj = __s->__free;
+	  __s->__free = *(void **) __obj;
+	}
+      else
+	{
+	  __obj = __s->__bump;
+	  __s->__bump += __size;
+	}
+      ++__s->__used;
+      if (__s->__free == NULL
+	  && __s->__bump + __size > (char *) __s + __MALLOC_TC_SPAN)
+	{
+	  __s->__prev->__next = __s->__next;
+	  __s->__next->__prev = __s->__prev;
+	  __s->__next = NULL;
+	}
+      *(void **) __obj = __first;
+      __first = __obj;
+      ++__got;
+    }
+  __cl->__out += __got;
+  __pthread_futex_unlock (&__cl->__lock);
+  *__list = __first;
+  return __got;
+}
+
+/* Returns the N objects of class C in LIST to their spans. */
+static void
+__malloc_tc_release (unsigned int __c, void *__list, unsigned int __n)
+{
+  struct __malloc_tc_central *__cl = &__malloc_tc_central[__c];
+  struct __malloc_tc_span *__head = &__cl->__partial;
+  struct __malloc_tc_span *__empty = NULL;
+  struct __malloc_tc_span *__s;
+  void *__obj;
+
+  __pthread_futex_lock (&__cl->__lock);
+  while (__list != NULL)
+    {
+      __obj = __list;
+      __list = *(void **) __obj;
+      __s = __malloc_tc_span_of (__obj);
+      *(void **) __obj = __s->__free;
+      __s->__free = __obj;
+      if (--__s->__used == 0)
+	{
+	  if (__s->__next != NULL)
+	    {
+	      __s->__prev->__next = __s->__next;
+	      __s->__next->__prev = __s->__prev;
+	    }
+	  __s->__next = __empty;
+	  __empty = __s;
+	  --__cl->__spans;
+	}
+      else if (__s->__next == NULL)
+	{
+	  __s->__next = __head;
+	  __s->__prev = __head->__prev;
+	  __head->__prev->__next = __s;
+	  __head->__prev = __s;
+	}
+    }
+  __cl->__out -= __n;
+  __pthread_futex_unlock (&__cl->__lock);
+
+  while (__empty != NULL)
+    {
+      __s = __empty;
+      __empty = __s->__next;
+      __malloc_tc_span_put (__s);
+    }
+}
+
+/* Start of the object of span S that P points into.  P is not always
+   the start itself: see memalign.  The multiplication by the
+   reciprocal is exact since offsets and sizes are below 2^16. */
+static __inline void *
+__malloc_tc_object (struct __malloc_tc_span *__s, void *__p)
+{
+  char *__base = (char *) __s + __MALLOC_TC_HDR;
+  unsigned int __i;
+
+  __i = ((unsigned long long) ((char *) __p - __base) * __s->__recip) >> 32;
+  return __base + __i * __s->__size;
+}
+
+/**********************************************************************/
+/* Thread caches. */
+
+/* Returns the first N objects of bin C of TC to the central list. */
+static void
+__malloc_tc_flush (struct __malloc_tc_cache *__tc, unsigned int __c,
+		   unsigned int __n)
+{
+  struct __malloc_tc_bin *__bin = &__tc->__bin[__c];
+  void *__list = __bin->__head;
+  void *__last = __list;
+  unsigned int __i;
+
+  for (__i = 1; __i < __n; ++__i)
+    __last = *(void **) __last;
+  __bin->__head = *(void **) __last;
+  *(void **) __last = NULL;
+  __bin->__count -= __n;
+  __tc->__bytes -= __n * __malloc_tc_class_size (__c);
+  __malloc_tc_release (__c, __list, __n);
+}
+
+/* Halves every bin of TC; all of it if ALL. */
+static void
+__malloc_tc_scavenge (struct __malloc_tc_cache *__tc, int __all)
+{
+  unsigned int __c;
+
+  for (__c = 0; __c < __MALLOC_TC_NCLASS; ++__c)
+    if (__tc->__bin[__c].__count != 0)
+      __malloc_tc_flush (__tc, __c, __all ? __tc->__bin[__c].__count
+			 : (__tc->__bin[__c].__count + 1) >> 1);
+}
+
+static void
+__malloc_tc_destroy (void *__arg)
+{
+  struct __malloc_tc_cache *__tc = (struct __malloc_tc_cache *) __arg;
+  struct __malloc_tc_cache **__pp;
+
+  if (__tc == __MALLOC_TC_DEAD)
+    return;
+  /* Allocations made by destructors that run after this one go
+     straight to the central lists. */
+  pthread_setspecific (__malloc_tc_key, __MALLOC_TC_DEAD);
+  __malloc_tc_scavenge (__tc, 1);
+
+  __pthread_futex_lock (&__malloc_tc_caches_lock);
+  for (__pp = &__malloc_tc_caches; *__pp != __tc; __pp = &(*__pp)->__next)
+    ;
+  *__pp = __tc->__next;
+  __pthread_futex_unlock (&__malloc_tc_caches_lock);
+
+  *(void **) __tc = NULL;
+  __malloc_tc_release (__malloc_tc_class (sizeof (struct __malloc_tc_cache)),
+		       __tc, 1);
+}
+
+static void
+__malloc_tc_key_init (void)
+{
+  __pthread_futex_lock (&__malloc_tc_caches_lock);
+  if (__malloc_tc_key_state == 0)
+    __malloc_tc_key_state =
+      (&pthread_key_create != NULL && &pthread_getspecific != NULL
+       && &pthread_setspecific != NULL && &pthread_self != NULL
+       && pthread_key_create (&__malloc_tc_key, __malloc_tc_destroy) == 0)
+      ? 1 : -1;
+  __pthread_futex_unlock (&__malloc_tc_caches_lock);
+}
+
+/* Sets up the calling thread's cache.  pthread_setspecific may itself
+   call calloc, so a thread in the middle of this is recorded in
+   __malloc_tc_booting and served from the central lists meanwhile. */
+static struct __malloc_tc_cache *
+__malloc_tc_create (void)
+{
+  struct __malloc_tc_cache *__tc;
+  pthread_t __self;
+  void *__obj;
+  int __i;
+
+  if (__malloc_tc_key_state == 0)
+    __malloc_tc_key_init ();
+  if (__malloc_tc_key_state < 0 || __malloc_tc_cache_max == 0)
+    return NULL;
+
+  __self = pthread_self ();
+  for (__i = 0; __i < __MALLOC_TC_NBOOT; ++__i)
+    if (__malloc_tc_booting[__i] == __self)
+      return NULL;
+  for (__i = 0; __i < __MALLOC_TC_NBOOT; ++__i)
+    if (__pthread_atomic_cas ((volatile int *) &__malloc_tc_booting[__i],
+			      0, (int) __self))
+      break;
+  if (__i == __MALLOC_TC_NBOOT)
+    return NULL;
+
+  __tc = NULL;
+  if (__malloc_tc_fetch (__malloc_tc_class (sizeof (struct __malloc_tc_cache)),
+			 1, &__obj))
+    {
+      __tc = (struct __malloc_tc_cache *) __obj;
+      memset (__tc, 0, sizeof (struct __malloc_tc_cache));
+      __tc->__sample_seed = (unsigned int) (unsigned long) __tc;
+      if (pthread_setspecific (__malloc_tc_key, __tc) == 0)
+	{
+	  __pthread_futex_lock (&__malloc_tc_caches_lock);
+	  __tc->__next = __malloc_tc_caches;
+	  __malloc_tc_caches = __tc;
+	  __pthread_futex_unlock (&__malloc_tc_caches_lock);
+	}
+      else
+	{
+	  __malloc_tc_release (__malloc_tc_class
+			       (sizeof (struct __malloc_tc_cache)), __tc, 1);
+	  __tc = NULL;
+	}
+    }
+  __malloc_tc_booting[__i] = 0;
+  return __tc;
+}
+
+/* The calling thread's cache, or NULL to use the central lists. */
+static __inline struct __malloc_tc_cache *
+__malloc_tc_get (void)
+{
+  struct __malloc_tc_cache *__tc;
+
+  if (__builtin_expect (__malloc_tc_key_state > 0, 1))
+    {
+      __tc = (struct __malloc_tc_cache *) pthread_getspecific (__malloc_tc_key);
+      if (__builtin_expect (__tc != NULL, 1))
+	return __tc != __MALLOC_TC_DEAD ? __tc : NULL;
+    }
+  return __malloc_tc_create ();
+}
+
+/**********************************************************************/
+/* Large blocks. */
+
+/* A block of N bytes starting at an OFFSET from its span: the header
+   size, rounded up to an alignment below the span size. */
+static void *
+__malloc_tc_large (size_t __n, size_t __offset)
+{
+  struct __malloc_tc_span *__s;
+  size_t __len;
+
+  if (__n > (size_t) -1 - 2 * __MALLOC_TC_SPAN)
+    {
+      errno = ENOMEM;
+      return NULL;
+    }
+  __len = __offset + __n;
+  if (__len <= __MALLOC_TC_SPAN && __len <= __malloc_tc_mmap_threshold)
+    {
+      __s = __malloc_tc_span_get ();
+      if (__s == NULL)
+	goto nomem;
+      __s->__class = __MALLOC_TC_POOLED;
+      __s->__size = __MALLOC_TC_SPAN;
+      __pthread_atomic_add ((volatile int *) &__malloc_tc_pool.__pooled, 1);
+    }
+  else
+    {
+      __len = (__len + __MALLOC_TC_PAGE - 1) & ~(size_t) (__MALLOC_TC_PAGE - 1);
+      __s = (struct __malloc_tc_span *) __malloc_tc_map (__len);
+      if (__s == NULL)
+	goto nomem;
+      __s->__class = __MALLOC_TC_MAPPED;
+      __s->__size = __len;
+      __pthread_futex_lock (&__malloc_tc_pool.__lock);
+      ++__malloc_tc_pool.__large;
+      __malloc_tc_pool.__large_bytes += __len;
+      __pthread_futex_unlock (&__malloc_tc_pool.__lock);
+    }
+  __s->__sampled = 0;
+  return (char *) __s + __offset;
+
+ nomem:
+  errno = ENOMEM;
+  return NULL;
+}
+
+static void
+__malloc_tc_large_free (struct __malloc_tc_span *__s)
+{
+  if (__s->__class == __MALLOC_TC_POOLED)
+    {
+      __pthread_atomic_add ((volatile int *) &__malloc_tc_pool.__pooled, -1);
+      __malloc_tc_span_put (__s);
+    }
+  else if (__s->__class == __MALLOC_TC_MAPPED)
+    {
+      __pthread_futex_lock (&__malloc_tc_pool.__lock);
+      --__malloc_tc_pool.__large;
+      __malloc_tc_pool.__large_bytes -= __s->__size;
+      __pthread_futex_unlock (&__malloc_tc_pool.__lock);
+      munmap (__s, __s->__size);
+    }
+}
+
+/* Bytes usable from P to the end of its block. */
+static size_t
+__malloc_tc_usable (void *__p)
+{
+  struct __malloc_tc_span *__s = __malloc_tc_span_of (__p);
+
+  if (__s->__class < __MALLOC_TC_NCLASS)
+    return (char *) __malloc_tc_object (__s, __p) + __s->__size - (char *) __p;
+  return (char *) __s + __s->__size - (char *) __p;
+}
+
+/**********************************************************************/
+/* Heap profiler. */
+
+/* Allocations seen from one call stack.  Buckets are never freed, so
+   the totals cover the whole run. */
+struct __malloc_tc_bucket
+{
+  struct __malloc_tc_bucket *__next;
+  unsigned int __hash;
+  unsigned int __depth;
+  unsigned long int __live_n;		/* Estimated, as are the others */
+  unsigned long int __live_bytes;
+  unsigned long int __total_n;
+  unsigned long int __total_bytes;
+  void *__pc[__MALLOC_TC_DEPTH];
+};
+
+/* A sampled block that has not been freed yet. */
+struct __malloc_tc_sample
+{
+  struct __malloc_tc_sample *__next;
+  void *__block;			/* Object start, or span */
+  struct __malloc_tc_bucket *__bucket;
+  unsigned int __hist;			/* Size class, or NCLASS if large */
+  unsigned long int __n;		/* Blocks it stands for */
+  unsigned long int __bytes;		/* Bytes it stands for */
+};
+
+/* Mean bytes between samples; 0 while the profiler is off. */
+static size_t __malloc_tc_sample_rate;
+static __malloc_tc_lock_t __malloc_tc_prof_lock;
+static struct __malloc_tc_bucket *__malloc_tc_buckets[__MALLOC_TC_NBUCKET];
+static struct __malloc_tc_sample *__malloc_tc_samples[__MALLOC_TC_NSAMPLE];
+static unsigned long int __malloc_tc_hist_n[__MALLOC_TC_NCLASS + 1];
+static unsigned long int __malloc_tc_hist_bytes[__MALLOC_TC_NCLASS + 1];
+
+/* The object or span that identifies the block P points into. */
+static __inline void *
+__malloc_tc_block (struct __malloc_tc_span *__s, void *__p)
+{
+  return __s->__class < __MALLOC_TC_NCLASS ? __malloc_tc_object (__s, __p)
+					   : (void *) __s;
+}
+
+static __inline unsigned int
+__malloc_tc_sample_hash (void *__block)
+{
+  unsigned long int __a = (unsigned long int) __block;
+
+  return ((__a >> 3) ^ (__a >> 16)) & (__MALLOC_TC_NSAMPLE - 1);
+}
+
+/* Frame pointer chain.  In ARM state FP points at the saved pc of an
+   APCS frame, below which lie the return address, the caller's sp and
+   the caller's FP; elsewhere it points at the caller's FP, with the
+   return address above it. */
+#ifdef __arm__
+# define __MALLOC_TC_FP_NEXT(__fp)	((void **) (__fp)[-3])
+# define __MALLOC_TC_FP_RET(__fp)	((__fp)[-1])
+#else
+# define __MALLOC_TC_FP_NEXT(__fp)	((void **) (__fp)[0])
+# define __MALLOC_TC_FP_RET(__fp)	((__fp)[1])
+#endif
+
+/* Stores in PC the return addresses of the frames from FP outwards,
+   less the first SKIP, and returns how many.  A frame is only followed
+   to a caller's that is above it, aligned and less than 100000 bytes
+   away; anything else is the outermost frame (whose FP is 0), or code
+   built without frame pointers. */
+static unsigned int
+__malloc_tc_backtrace (void **__fp, void **__pc, unsigned int __skip)
+{
+  unsigned int __depth = 0;
+  void **__next;
+
+#ifndef __thumb__
+  while (__fp != NULL && __depth < __MALLOC_TC_DEPTH)
+    {
+      if (__skip != 0)
+	--__skip;
+      else if ((__pc[__depth] = __MALLOC_TC_FP_RET (__fp)) != NULL)
+	++__depth;
+      else
+	break;
+      __next = __MALLOC_TC_FP_NEXT (__fp);
+      if (__next <= __fp
+	  || (unsigned long int) __next - (unsigned long int) __fp >= 100000
+	  || ((unsigned long int) __next & (sizeof (void *) - 1)) != 0)
+	break;
+      __fp = __next;
+    }
+#endif
+  return __depth;
+}
+
+/* Files the sampled block P of N bytes under the stack PC[0..DEPTH). */
+static void
+__malloc_tc_profile_record (void *__p, size_t __n, void **__pc,
+			    unsigned int __depth)
+{
+  struct __malloc_tc_span *__s = __malloc_tc_span_of (__p);
+  struct __malloc_tc_bucket *__b;
+  struct __malloc_tc_sample *__smp;
+  unsigned int __hash = 2166136261U;
+  unsigned int __i;
+  void *__obj;
+
+  for (__i = 0; __i < __depth; ++__i)
+    __hash = (__hash ^ (unsigned int) (unsigned long) __pc[__i]) * 16777619U;
+
+  __pthread_futex_lock (&__malloc_tc_prof_lock);
+  for (__b = __malloc_tc_buckets[__hash & (__MALLOC_TC_NBUCKET - 1)];
+       __b != NULL; __b = __b->__next)
+    if (__b->__hash == __hash && __b->__depth == __depth
+	&& memcmp (__b->__pc, __pc, __depth * sizeof (void *)) == 0)
+      break;
+  if (__b == NULL)
+    {
+      if (!__malloc_tc_fetch (__malloc_tc_class
+			      (sizeof (struct __malloc_tc_bucket)), 1, &__obj))
+	goto out;
+      __b = (struct __malloc_tc_bucket *) __obj;
+      memset (__b, 0, sizeof (struct __malloc_tc_bucket));
+      __b->__hash = __hash;
+      __b->__depth = __depth;
+      memcpy (__b->__pc, __pc, __depth * sizeof (void *));
+      __b->__next = __malloc_tc_buckets[__hash & (__MALLOC_TC_NBUCKET - 1)];
+      __malloc_tc_buckets[__hash & (__MALLOC_TC_NBUCKET - 1)] = __b;
+    }
+  if (!__malloc_tc_fetch (__malloc_tc_class
+			  (sizeof (struct __malloc_tc_sample)), 1, &__obj))
+    goto out;
+
+  /* A block smaller than the sampling interval is picked with
+     probability __n / rate, so it stands for rate bytes' worth of such
+     blocks. */
+  __smp = (struct __malloc_tc_sample *) __obj;
+  __smp->__block = __malloc_tc_block (__s, __p);
+  __smp->__bucket = __b;
+  __smp->__hist = __s->__class < __MALLOC_TC_NCLASS ? __s->__class
+						    : __MALLOC_TC_NCLASS;
+  if (__n == 0)
+    __n = 1;
+  __smp->__n = __n >= __malloc_tc_sample_rate
+	       ? 1 : __malloc_tc_sample_rate / __n;
+  __smp->__bytes = __n >= __malloc_tc_sample_rate
+		   ? __n : __malloc_tc_sample_rate;
+  __i = __malloc_tc_sample_hash (__smp->__block);
+  __smp->__next = __malloc_tc_samples[__i];
+  __malloc_tc_samples[__i] = __smp;
+  ++__s->__sampled;
+
+  __b->__live_n += __smp->__n;
+  __b->__live_bytes += __smp->__bytes;
+  __b->__total_n += __smp->__n;
+  __b->__total_bytes += __smp->__bytes;
+  __malloc_tc_hist_n[__smp->__hist] += __smp->__n;
+  __malloc_tc_hist_bytes[__smp->__hist] += __smp->__bytes;
+ out:
+  __pthread_futex_unlock (&__malloc_tc_prof_lock);
+}
+
+/* Called for every successful allocation while the profiler is on.
+   This, malloc and memalign are kept out of line so that the frame to
+   skip is always this one, whose return address is in its caller. */
+static void __attribute__ ((__noinline__))
+__malloc_tc_profile_alloc (void *__p, size_t __n)
+{
+  struct __malloc_tc_cache *__tc;
+  void *__pc[__MALLOC_TC_DEPTH];
+  size_t __rate;
+
+  if (__malloc_tc_key_state <= 0)
+    return;
+  __tc = (struct __malloc_tc_cache *) pthread_getspecific (__malloc_tc_key);
+  if (__tc == NULL || __tc == __MALLOC_TC_DEAD)
+    return;
+  __tc->__sample_left -= (long int) __n;
+  __rate = __malloc_tc_sample_rate;
+  if (__tc->__sample_left > 0 || __rate == 0)
+    return;
+
+  /* Intervals are uniform in [rate/2, 3*rate/2), so periodic
+     allocation patterns do not alias with them.  The overshoot of this
+     block is carried over; dropping it would undercount blocks that
+     are not much smaller than the interval. */
+  do
+    {
+      __tc->__sample_seed = __tc->__sample_seed * 1103515245U + 12345U;
+      __tc->__sample_left += __rate / 2
+	+ (long int) (((unsigned long long int) (__tc->__sample_seed >> 1)
+		       * __rate) >> 31);
+    }
+  while (__tc->__sample_left <= 0);
+
+  __malloc_tc_profile_record (__p, __n, __pc, __malloc_tc_backtrace
+				((void **) __builtin_frame_address (0), __pc, 1));
+}
+
+/* Called by free for blocks of spans that hold sampled blocks. */
+static void
+__malloc_tc_profile_free (struct __malloc_tc_span *__s, void *__p)
+{
+  struct __malloc_tc_sample **__pp;
+  struct __malloc_tc_sample *__smp;
+  void *__block = __malloc_tc_block (__s, __p);
+
+  __pthread_futex_lock (&__malloc_tc_prof_lock);
+  for (__pp = &__malloc_tc_samples[__malloc_tc_sample_hash (__block)];
+       (__smp = *__pp) != NULL; __pp = &__smp->__next)
+    if (__smp->__block == __block)
+      {
+	*__pp = __smp->__next;
+	--__s->__sampled;
+	__smp->__bucket->__live_n -= __smp->__n;
+	__smp->__bucket->__live_bytes -= __smp->__bytes;
+	__malloc_tc_hist_n[__smp->__hist] -= __smp->__n;
+	__malloc_tc_hist_bytes[__smp->__hist] -= __smp->__bytes;
+	__smp->__next = NULL;
+	__malloc_tc_release (__malloc_tc_class
+			     (sizeof (struct __malloc_tc_sample)), __smp, 1);
+	break;
+      }
+  __pthread_futex_unlock (&__malloc_tc_prof_lock);
+}
+
+/* printf to FD, through a buffer on the stack: the profiler lock is
+   held, so nothing here may allocate. */
+static int
+__malloc_tc_dprintf (int __fd, const char *__fmt, ...)
+{
+  char __buf[256];
+  va_list __ap;
+  int __len;
+  int __done;
+  ssize_t __ret;
+
+  va_start (__ap, __fmt);
+  __len = vsnprintf (__buf, sizeof (__buf), __fmt, __ap);
+  va_end (__ap);
+  if (__len < 0)
+    return -1;
+  if (__len >= (int) sizeof (__buf))
+    __len = sizeof (__buf) - 1;
+  for (__done = 0; __done < __len; __done += __ret)
+    {
+      __ret = write (__fd, __buf + __done, __len - __done);
+      if (__ret < 0)
+	{
+	  if (errno == EINTR)
+	    {
+	      __ret = 0;
+	      continue;
+	    }
+	  return -1;
+	}
+    }
+  return 0;
+}
+
+/**********************************************************************/
+/* Public interface. */
+
+static __inline void *
+__malloc_tc_alloc (size_t __n)
+{
+  struct __malloc_tc_cache *__tc;
+  struct __malloc_tc_bin *__bin;
+  unsigned int __c;
+  unsigned int __got;
+  void *__obj;
+
+  if (__n > __MALLOC_TC_MAX_SMALL)
+    return __malloc_tc_large (__n, __MALLOC_TC_HDR);
+
+  __c = __malloc_tc_class (__n);
+  __tc = __malloc_tc_get ();
+  if (__tc == NULL)
+    __got = __malloc_tc_fetch (__c, 1, &__obj);
+  else
+    {
+      __bin = &__tc->__bin[__c];
+      if (__builtin_expect (__bin->__head != NULL, 1))
+	{
+	  __obj = __bin->__head;
+	  __bin->__head = *(void **) __obj;
+	  --__bin->__count;
+	  __tc->__bytes -= __malloc_tc_class_size (__c);
+	  return __obj;
+	}
+      __got = __malloc_tc_fetch (__c, __malloc_tc_batch (__c), &__obj);
+      if (__got > 1)
+	{
+	  __bin->__head = *(void **) __obj;
+	  __bin->__count = __got - 1;
+	  __tc->__bytes += (__got - 1) * __malloc_tc_class_size (__c);
+	}
+    }
+  if (__got == 0)
+    {
+      errno = ENOMEM;
+      return NULL;
+    }
+  return __obj;
+}
+
+__attribute__ ((__noinline__)) void *
+__NTH (malloc (size_t __n))
+{
+  void *__p = __malloc_tc_alloc (__n);
+
+  if (__builtin_expect (__malloc_tc_sample_rate != 0, 0) && __p != NULL)
+    __malloc_tc_profile_alloc (__p, __n);
+  return __p;
+}
+
+void
+__NTH (free (void *__p))
+{
+  struct __malloc_tc_span *__s;
+  struct __malloc_tc_cache *__tc;
+  struct __malloc_tc_bin *__bin;
+  unsigned int __c;
+
+  if (__p == NULL)
+    return;
+  __s = __malloc_tc_span_of (__p);
+  if (__builtin_expect (__s->__sampled != 0, 0))
+    __malloc_tc_profile_free (__s, __p);
+  __c = __s->__class;
+  if (__c >= __MALLOC_TC_NCLASS)
+    {
+      __malloc_tc_large_free (__s);
+      return;
+    }
+
+  __p = __malloc_tc_object (__s, __p);
+  __tc = __malloc_tc_get ();
+  if (__tc == NULL)
+    {
+      *(void **) __p = NULL;
+      __malloc_tc_release (__c, __p, 1);
+      return;
+    }
+  __bin = &__tc->__bin[__c];
+  *(void **) __p = __bin->__head;
+  __bin->__head = __p;
+  ++__bin->__count;
+  __tc->__bytes += __s->__size;
+  if (__bin->__count > 2 * __malloc_tc_batch (__c))
+    __malloc_tc_flush (__tc, __c, __malloc_tc_batch (__c));
+  if (__tc->__bytes > __malloc_tc_cache_max)
+    __malloc_tc_scavenge (__tc, 0);
+}
+
+void *
+__NTH (calloc (size_t __nmemb, size_t __size))
+{
+  unsigned long long int __total = (unsigned long long int) __nmemb * __size;
+  void *__p;
+
+  if (__total > (size_t) -1)
+    {
+      errno = ENOMEM;
+      return NULL;
+    }
+  __p = malloc ((size_t) __total);
+  /* A dedicated mapping is fresh from the kernel, hence zeroed. */
+  if (__p != NULL
+      && __malloc_tc_span_of (__p)->__class != __MALLOC_TC_MAPPED)
+    memset (__p, 0, (size_t) __total);
+  return __p;
+}
+
+void *
+__NTH (realloc (void *__p, size_t __n))
+{
+  size_t __old;
+  void *__q;
+
+  if (__p == NULL)
+    return malloc (__n);
+  if (__n == 0)
+    {
+      free (__p);
+      return NULL;
+    }
+  /* Stay put unless that would waste more than half the block. */
+  __old = __malloc_tc_usable (__p);
+  if (__n <= __old && __n >= __old / 2)
+    return __p;
+  __q = malloc (__n);
+  if (__q == NULL)
+    return NULL;
+  memcpy (__q, __p, __n < __old ? __n : __old);
+  free (__p);
+  return __q;
+}
+
+/* ALIGNMENT is rounded up to a power of two.  Alignments of a span
+   (64 KiB) or more cannot be served. */
+__attribute__ ((__noinline__)) void *
+__NTH (memalign (size_t __alignment, size_t __size))
+{
+  unsigned long int __p;
+  void *__q;
+
+  if (__alignment <= 8)
+    return malloc (__size);
+  while (__alignment & (__alignment - 1))
+    __alignment += __alignment & -__alignment;
+  if (__alignment >= __MALLOC_TC_SPAN)
+    {
+      errno = EINVAL;
+      return NULL;
+    }
+  if (__alignment > __MALLOC_TC_MAX_SMALL
+      || __size > __MALLOC_TC_MAX_SMALL + 8 - __alignment)
+    {
+      __q = __malloc_tc_large (__size, (__MALLOC_TC_HDR + __alignment - 1)
+				       & ~(__alignment - 1));
+      if (__builtin_expect (__malloc_tc_sample_rate != 0, 0) && __q != NULL)
+	__malloc_tc_profile_alloc (__q, __size);
+      return __q;
+    }
+
+  /* Small objects are 8-byte aligned; free and realloc find the start
+     of the object from any pointer into it.  The pointer returned must
+     not be the end of the object, even for a size of 0. */
+  __p = (unsigned long int) malloc ((__size ? __size : 1) + __alignment - 8);
+  if (__p == 0)
+    return NULL;
+  return (void *) ((__p + __alignment - 1) & ~(__alignment - 1));
+}
+
+void *
+__NTH (valloc (size_t __size))
+{
+  return memalign (__MALLOC_TC_PAGE, __size);
+}
+
+int
+__NTH (posix_memalign (void **__memptr, size_t __alignment, size_t __size))
+{
+  void *__p;
+
+  if (__alignment % sizeof (void *) != 0
+      || (__alignment & (__alignment - 1)) != 0
+      || __alignment >= __MALLOC_TC_SPAN)
+    return EINVAL;
+  __p = memalign (__alignment, __size);
+  if (__p == NULL)
+    return ENOMEM;
+  *__memptr = __p;
+  return 0;
+}
+
+/* arena, hblks and hblkhd are as for the standard malloc.  The other
+   fields describe the spans instead of a heap:
+     ordblks   free spans in the pool
+     smblks    thread caches
+     usmblks   most bytes ever mapped for spans
+     fsmblks   bytes in thread caches
+     uordblks  bytes in use in spans, including thread caches
+     fordblks  bytes mapped for spans but not in use
+     keepcost  resident free spans, releasable by malloc_trim */
+struct mallinfo
+__NTH (mallinfo (void))
+{
+  struct __malloc_tc_central *__cl;
+  struct __malloc_tc_cache *__tc;
+  struct mallinfo __mi;
+  unsigned long int __used = 0;
+  unsigned long int __cached = 0;
+  unsigned int __c;
+
+  memset (&__mi, 0, sizeof (__mi));
+  for (__c = 0; __c < __MALLOC_TC_NCLASS; ++__c)
+    {
+      __cl = &__malloc_tc_central[__c];
+      __pthread_futex_lock (&__cl->__lock);
+      __used += __cl->__out * __malloc_tc_class_size (__c);
+      __pthread_futex_unlock (&__cl->__lock);
+    }
+
+  __pthread_futex_lock (&__malloc_tc_caches_lock);
+  for (__tc = __malloc_tc_caches; __tc != NULL; __tc = __tc->__next)
+    {
+      __cached += __tc->__bytes;
+      ++__mi.smblks;
+    }
+  __pthread_futex_unlock (&__malloc_tc_caches_lock);
+
+  __pthread_futex_lock (&__malloc_tc_pool.__lock);
+  __mi.arena = __malloc_tc_pool.__mapped * __MALLOC_TC_SPAN;
+  __mi.ordblks = __malloc_tc_pool.__ndirty + __malloc_tc_pool.__nclean;
+  __mi.hblks = __malloc_tc_pool.__large;
+  __mi.hblkhd = __malloc_tc_pool.__large_bytes;
+  __mi.usmblks = __malloc_tc_pool.__max_mapped * __MALLOC_TC_SPAN;
+  __mi.keepcost = __malloc_tc_pool.__ndirty * __MALLOC_TC_SPAN;
+  __used += __malloc_tc_pool.__pooled * __MALLOC_TC_SPAN;
+  __pthread_futex_unlock (&__malloc_tc_pool.__lock);
+
+  __mi.fsmblks = __cached;
+  __mi.uordblks = __used;
+  __mi.fordblks = __mi.arena - __mi.uordblks;
+  return __mi;
+}
+
+/* Empties the calling thread's cache, releases the pages of all but
+   PAD bytes of resident free spans, and unmaps free spans beyond
+   M_TOP_PAD. */
+int
+malloc_trim (size_t __pad)
+{
+  struct __malloc_tc_cache *__tc;
+  struct __malloc_tc_span *__dirty;
+  struct __malloc_tc_span *__unmap;
+  struct __malloc_tc_span **__pp;
+  struct __malloc_tc_span *__s;
+  unsigned long int __keep;
+  int __released = 0;
+
+  if (__malloc_tc_key_state > 0)
+    {
+      __tc = (struct __malloc_tc_cache *) pthread_getspecific (__malloc_tc_key);
+      if (__tc != NULL && __tc != __MALLOC_TC_DEAD)
+	__malloc_tc_scavenge (__tc, 1);
+    }
+
+  __pthread_futex_lock (&__malloc_tc_pool.__lock);
+  __keep = __pad / __MALLOC_TC_SPAN;
+  for (__pp = &__malloc_tc_pool.__dirty; *__pp != NULL && __keep != 0;
+       __pp = &(*__pp)->__next)
+    --__keep;
+  __dirty = *__pp;
+  *__pp = NULL;
+  __malloc_tc_pool.__ndirty = __pad / __MALLOC_TC_SPAN - __keep;
+  __pthread_futex_unlock (&__malloc_tc_pool.__lock);
+
+  for (__s = __dirty; __s != NULL; __s = __s->__next)
+    {
+      madvise (__s, __MALLOC_TC_SPAN, __MALLOC_TC_DONTNEED);
+      __released = 1;
+    }
+
+  __pthread_futex_lock (&__malloc_tc_pool.__lock);
+  while (__dirty != NULL)
+    {
+      __s = __dirty;
+      __dirty = __s->__next;
+      __s->__next = __malloc_tc_pool.__clean;
+      __malloc_tc_pool.__clean = __s;
+      ++__malloc_tc_pool.__nclean;
+    }
+  __keep = __malloc_tc_top_pad / __MALLOC_TC_SPAN;
+  for (__pp = &__malloc_tc_pool.__clean; *__pp != NULL && __keep != 0;
+       __pp = &(*__pp)->__next)
+    --__keep;
+  __unmap = *__pp;
+  *__pp = NULL;
+  for (__s = __unmap; __s != NULL; __s = __s->__next)
+    {
+      --__malloc_tc_pool.__nclean;
+      --__malloc_tc_pool.__mapped;
+    }
+  __pthread_futex_unlock (&__malloc_tc_pool.__lock);
+
+  while (__unmap != NULL)
+    {
+      __s = __unmap;
+      __unmap = __s->__next;
+      munmap (__s, __MALLOC_TC_SPAN);
+      __released = 1;
+    }
+  return __released;
+}
+
+void
+malloc_stats (FILE *__file)
+{
+  struct __malloc_tc_central *__cl;
+  struct mallinfo __mi;
+  unsigned long int __spans;
+  unsigned long int __out;
+  unsigned int __c;
+
+  if (__file == NULL)
+    __file = stderr;
+  fprintf (__file, "class  size  spans   in use\n");
+  for (__c = 0; __c < __MALLOC_TC_NCLASS; ++__c)
+    {
+      __cl = &__malloc_tc_central[__c];
+      __pthread_futex_lock (&__cl->__lock);
+      __spans = __cl->__spans;
+      __out = __cl->__out;
+      __pthread_futex_unlock (&__cl->__lock);
+      if (__spans != 0)
+	fprintf (__file, "%5u %5lu %6lu %8lu\n", __c,
+		 (unsigned long int) __malloc_tc_class_size (__c),
+		 __spans, __out);
+    }
+
+  __mi = mallinfo ();
+  fprintf (__file, "max span bytes     = %10u\n", __mi.usmblks);
+  fprintf (__file, "span bytes         = %10u\n", __mi.arena);
+  fprintf (__file, "in use bytes       = %10u\n", __mi.uordblks);
+  fprintf (__file, "thread cache bytes = %10u\n", __mi.fsmblks);
+  fprintf (__file, "resident free bytes= %10u\n", __mi.keepcost);
+  fprintf (__file, "mmap regions       = %10u\n", __mi.hblks);
+  fprintf (__file, "mmap bytes         = %10u\n", __mi.hblkhd);
+}
+
+/* M_TRIM_THRESHOLD  bytes of free spans kept resident (default 256K)
+   M_TOP_PAD         bytes of free spans kept mapped without pages
+                     beyond that (default 1M)
+   M_MMAP_THRESHOLD  large requests above this get their own mapping
+                     instead of a span (default and maximum 64K)
+   M_THREAD_CACHE_MAX  bytes each thread may cache (default 64K; 0
+                     stops new threads from creating caches)
+   M_MMAP_MAX and M_CHECK_ACTION are accepted and ignored: there is no
+   heap to fall back on, and no consistency checks. */
+int
+__NTH (mallopt (int __param, int __val))
+{
+  if (__val < 0)
+    return 0;
+  switch (__param)
+    {
+    case M_TRIM_THRESHOLD:
+      __malloc_tc_trim_threshold = __val;
+      break;
+    case M_TOP_PAD:
+      __malloc_tc_top_pad = __val;
+      break;
+    case M_MMAP_THRESHOLD:
+      __malloc_tc_mmap_threshold = __val;
+      break;
+    case M_THREAD_CACHE_MAX:
+      __malloc_tc_cache_max = __val;
+      break;
+    case M_MMAP_MAX:
+    case M_CHECK_ACTION:
+      break;
+    default:
+      return 0;
+    }
+  return 1;
+}
+
+/* Starts sampling about once every SAMPLE_BYTES bytes allocated by each
+   thread.  Needs the thread caches, hence libpthread. */
+int
+malloc_profile_start (size_t __sample_bytes)
+{
+  if (__sample_bytes == 0)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+  if (__malloc_tc_key_state == 0)
+    __malloc_tc_key_init ();
+  if (__malloc_tc_key_state < 0)
+    {
+      errno = ENOSYS;
+      return -1;
+    }
+  __malloc_tc_sample_rate = __sample_bytes;
+  return 0;
+}
+
+/* Stops sampling.  Blocks already sampled stay in the profile until
+   they are freed. */
+void
+malloc_profile_stop (void)
+{
+  __malloc_tc_sample_rate = 0;
+}
+
+/* Writes the profile to FD as text:
+     heap profile: <live n>: <live bytes> [<total n>: <total bytes>] @ heap/<rate>
+     <live n>: <live bytes> [<total n>: <total bytes>] @ <pc> <pc> ...
+     ...
+     SIZE_HISTOGRAM:
+     <size>: <live n>: <live bytes>		(size 0 for large blocks)
+     ...
+     MAPPED_LIBRARIES:
+     <contents of /proc/self/maps>
+   The counts are estimates scaled up from the samples.  Allocations
+   that sample block on the profiler lock meanwhile. */
+int
+malloc_profile_dump (int __fd)
+{
+  struct __malloc_tc_bucket *__b;
+  unsigned long int __live_n = 0;
+  unsigned long int __live_bytes = 0;
+  unsigned long int __total_n = 0;
+  unsigned long int __total_bytes = 0;
+  unsigned int __i;
+  unsigned int __d;
+  char __buf[256];
+  ssize_t __len;
+  int __maps;
+  int __ret = 0;
+
+  __pthread_futex_lock (&__malloc_tc_prof_lock);
+  for (__i = 0; __i < __MALLOC_TC_NBUCKET; ++__i)
+    for (__b = __malloc_tc_buckets[__i]; __b != NULL; __b = __b->__next)
+      {
+	__live_n += __b->__live_n;
+	__live_bytes += __b->__live_bytes;
+	__total_n += __b->__total_n;
+	__total_bytes += __b->__total_bytes;
+      }
+  __ret |= __malloc_tc_dprintf (__fd, "heap profile: %lu: %lu [%lu: %lu]"
+				" @ heap/%lu\n", __live_n, __live_bytes,
+				__total_n, __total_bytes,
+				(unsigned long int) __malloc_tc_sample_rate);
+  for (__i = 0; __i < __MALLOC_TC_NBUCKET; ++__i)
+    for (__b = __malloc_tc_buckets[__i]; __b != NULL; __b = __b->__next)
+      {
+	__ret |= __malloc_tc_dprintf (__fd, "%lu: %lu [%lu: %lu] @",
+				      __b->__live_n, __b->__live_bytes,
+				      __b->__total_n, __b->__total_bytes);
+	for (__d = 0; __d < __b->__depth; ++__d)
+	  __ret |= __malloc_tc_dprintf (__fd, " %p", __b->__pc[__d]);
+	__ret |= __malloc_tc_dprintf (__fd, "\n");
+      }
+
+  __ret |= __malloc_tc_dprintf (__fd, "\nSIZE_HISTOGRAM:\n");
+  for (__i = 0; __i <= __MALLOC_TC_NCLASS; ++__i)
+    if (__malloc_tc_hist_n[__i] != 0)
+      __ret |= __malloc_tc_dprintf (__fd, "%lu: %lu: %lu\n",
+				    __i < __MALLOC_TC_NCLASS
+				    ? (unsigned long int)
+				      __malloc_tc_class_size (__i) : 0UL,
+				    __malloc_tc_hist_n[__i],
+				    __malloc_tc_hist_bytes[__i]);
+  __pthread_futex_unlock (&__malloc_tc_prof_lock);
+
+  __ret |= __malloc_tc_dprintf (__fd, "\nMAPPED_LIBRARIES:\n");
+  __maps = open ("/proc/self/maps", O_RDONLY);
+  if (__maps >= 0)
+    {
+      while ((__len = read (__maps, __buf, sizeof (__buf))) > 0)
+	if (write (__fd, __buf, __len) != __len)
+	  {
+	    __ret = -1;
+	    break;
+	  }
+      close (__maps);
+    }
+  return __ret;
+}
+
+/* malloc_profile_dump into the file FILENAME, which is truncated. */
+int
+malloc_profile_save (const char *__filename)
+{
+  int __fd;
+  int __ret;
+
+  __fd = open (__filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (__fd < 0)
+    return -1;
+  __ret = malloc_profile_dump (__fd);
+  if (close (__fd) != 0)
+    __ret = -1;
+  return __ret;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _BITS_UCLIBC_MALLOC_TC_H */
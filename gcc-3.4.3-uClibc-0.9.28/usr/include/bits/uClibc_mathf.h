@@ -0,0 +1,738 @@
+/* Single-precision math functions in integer arithmetic.
+ *
+ * GNU Library General Public License (LGPL) version 2 or later.
+ *
+ * Without an FPU every float operation is a call into the soft-float
+ * support, and libm computes most float functions through the double
+ * versions, so one sinf costs hundreds of soft-double additions and
+ * multiplications.  These work on the bits of the argument with 32 and
+ * 32x32->64 bit integer operations only: a table lookup and a short
+ * fixed-point polynomial, then one rounding into the float result.
+ *
+ * Largest errors against the correctly rounded result, measured over
+ * every float (powf over random pairs):
+ *
+ *			default		-ffast-math
+ *	sqrtf		0.5 ulp		0.5 ulp
+ *	exp2f, expf	0.53 ulp	4.2 ulp
+ *	log2f, logf	0.51 ulp	2.7 ulp
+ *	log10f		0.51 ulp	2.4 ulp
+ *	powf		0.53 ulp	4.1 ulp
+ *	sinf, cosf	0.54 ulp	5.8 ulp
+ *
+ * so outside -ffast-math (__FAST_MATH__) the result is the correctly
+ * rounded one or its neighbour.  Special arguments give the results
+ * C99 Annex F gives for them, but errno is never set and the
+ * floating-point exception flags are not raised; only round-to-nearest
+ * is supported.
+ *
+ * <math.h> maps the names onto these unless __NO_MATH_INLINES is
+ * defined, as it is for strict ISO C.  (sinf) (x) and &sinf still
+ * reach libm.
+ */
+
+#ifndef _MATH_H
+#error Always include <math.h> rather than <bits/uClibc_mathf.h>
+#endif
+
+#ifndef _BITS_UCLIBC_MATHF_H
+#define _BITS_UCLIBC_MATHF_H	1
+
+__extension__ typedef unsigned long long int __uclibc_mathf_u64;
+__extension__ typedef long long int __uclibc_mathf_s64;
+
+union __uclibc_mathf_bits
+{
+  float __f;
+  unsigned int __u;
+};
+
+static __inline unsigned int
+__uclibc_mathf_tobits (float __x)
+{
+  union __uclibc_mathf_bits __b;
+
+  __b.__f = __x;
+  return __b.__u;
+}
+
+static __inline float
+__uclibc_mathf_frombits (unsigned int __u)
+{
+  union __uclibc_mathf_bits __b;
+
+  __b.__u = __u;
+  return __b.__f;
+}
+
+/* The high word of A * B. */
+static __inline unsigned int
+__uclibc_mathf_mulhi (unsigned int __a, unsigned int __b)
+{
+  return (unsigned int) (((__uclibc_mathf_u64) __a * __b) >> 32);
+}
+
+/* A * B / 2^32, for a 64 bit A. */
+static __inline __uclibc_mathf_u64
+__uclibc_mathf_mul64 (__uclibc_mathf_u64 __a, unsigned int __b)
+{
+  return (__a >> 32) * __b + (((__a & 0xffffffffU) * __b) >> 32);
+}
+
+static __inline int
+__uclibc_mathf_clz64 (__uclibc_mathf_u64 __m)
+{
+  if ((__m >> 32) != 0)
+    return __builtin_clz ((unsigned int) (__m >> 32));
+  return 32 + __builtin_clz ((unsigned int) __m);
+}
+
+/* The float nearest M * 2^E (M nonzero), with SIGN as its sign bit:
+   an infinity on overflow, a subnormal or zero on underflow. */
+static __inline float
+__uclibc_mathf_pack (unsigned int __sign, __uclibc_mathf_u64 __m, int __e)
+{
+  unsigned int __bits;
+  int __z;
+
+  __z = __uclibc_mathf_clz64 (__m);
+  __m <<= __z;
+  __e += 63 + 127 - __z;	/* Biased exponent of the leading bit */
+  if (__e >= 255)
+    return __uclibc_mathf_frombits (__sign | 0x7f800000);
+  if (__e <= 0)
+    {
+      /* Denormalize, keeping the bits shifted out as a sticky bit. */
+      __z = 1 - __e;
+      if (__z > 63)
+	__m = 1;
+      else
+	__m = (__m >> __z) | ((__m << (63 - __z) << 1) != 0);
+      __e = 0;
+    }
+  __bits = (unsigned int) (__m >> 40);
+  if (((__m >> 39) & 1) != 0
+      && ((__m & ((((__uclibc_mathf_u64) 1) << 39) - 1)) != 0
+	  || (__bits & 1) != 0))
+    ++__bits;
+  /* The implicit bit adds one to the exponent field, as does a carry
+     out of the significand when rounding. */
+  if (__e > 0)
+    __bits += (unsigned int) (__e - 1) << 23;
+  return __uclibc_mathf_frombits (__sign | __bits);
+}
+
+/**********************************************************************/
+/* sqrtf */
+
+/* Square root, by the digit-by-digit method on the significand, which
+   leaves an exact remainder to round with. */
+static __inline float
+__uclibc_sqrtf (float __x)
+{
+  unsigned int __ix = __uclibc_mathf_tobits (__x);
+  unsigned int __q;
+  unsigned int __s;
+  unsigned int __t;
+  unsigned int __r;
+  int __e;
+
+  if (__ix - 0x00800000U >= 0x7f000000U)
+    {
+      /* Zero, subnormal, infinity, NaN or negative. */
+      if ((__ix & 0x7fffffffU) == 0 || __ix == 0x7f800000U
+	  || (__ix & 0x7fffffffU) > 0x7f800000U)
+	return __x;
+      if (__ix & 0x80000000U)
+	return __uclibc_mathf_frombits (0x7fc00000);
+      __e = __builtin_clz (__ix) - 8;
+      __ix <<= __e;
+      __e = 1 - __e;
+    }
+  else
+    __e = __ix >> 23;
+  __e -= 127;
+  __ix = (__ix & 0x007fffffU) | 0x00800000U;
+  if (__e & 1)
+    __ix += __ix;
+  __e >>= 1;
+
+  /* Twenty-five bits of root: the float's 24 and a rounding bit. */
+  __ix += __ix;
+  __q = __s = 0;
+  for (__r = 0x01000000U; __r != 0; __r >>= 1)
+    {
+      __t = __s + __r;
+      if (__t <= __ix)
+	{
+	  __s = __t + __r;
+	  __ix -= __t;
+	  __q += __r;
+	}
+      __ix += __ix;
+    }
+  /* The root is never exactly halfway, so a set rounding bit rounds
+     up when anything is left over. */
+  if (__ix != 0)
+    __q += __q & 1;
+  return __uclibc_mathf_frombits ((__q >> 1) + 0x3f000000U
+				  + ((unsigned int) __e << 23));
+}
+
+/**********************************************************************/
+/* exp2f, expf */
+
+/* 2^(i/64) in Q1.31. */
+static const unsigned int __uclibc_mathf_exp2_tab[64] =
+{
+  0x80000000, 0x8164d1f4, 0x82cd8699, 0x843a28c4,
+  0x85aac368, 0x871f6197, 0x88980e81, 0x8a14d575,
+  0x8b95c1e4, 0x8d1adf5b, 0x8ea4398b, 0x9031dc43,
+  0x91c3d374, 0x935a2b2f, 0x94f4efa9, 0x96942d37,
+  0x9837f052, 0x99e04593, 0x9b8d39ba, 0x9d3ed9a7,
+  0x9ef53261, 0xa0b05110, 0xa2704303, 0xa43515ae,
+  0xa5fed6aa, 0xa7cd93b5, 0xa9a15ab5, 0xab7a39b6,
+  0xad583eea, 0xaf3b78ad, 0xb123f582, 0xb311c413,
+  0xb504f334, 0xb6fd91e3, 0xb8fbaf47, 0xbaff5ab2,
+  0xbd08a39f, 0xbf1799b6, 0xc12c4cca, 0xc346ccda,
+  0xc5672a11, 0xc78d74c9, 0xc9b9bd86, 0xcbec14ff,
+  0xce248c15, 0xd06333db, 0xd2a81d92, 0xd4f35aac,
+  0xd744fccb, 0xd99d15c2, 0xdbfbb798, 0xde60f482,
+  0xe0ccdeec, 0xe33f8973, 0xe5b906e7, 0xe8396a50,
+  0xeac0c6e8, 0xed4f301f, 0xefe4b99c, 0xf281773c,
+  0xf5257d15, 0xf7d0df73, 0xfa83b2db, 0xfd3e0c0d
+};
+
+#define __UCLIBC_MATHF_LN2	0xb17217f8U	/* ln 2 in Q.32 */
+#define __UCLIBC_MATHF_LOG2E	0xb8aa3b29U	/* log2 e in Q1.31, */
+#define __UCLIBC_MATHF_LOG2E_LO	0x5c17f0bcU	/* and the next 32 bits */
+
+/* 2^(T / 2^32). */
+static __inline float
+__uclibc_mathf_exp2 (__uclibc_mathf_s64 __t)
+{
+  unsigned int __f;
+  unsigned int __y;
+  unsigned int __p;
+  unsigned int __m;
+  int __n;
+
+  if (__t >= (__uclibc_mathf_s64) 256 << 32)
+    __t = (__uclibc_mathf_s64) 256 << 32;
+  else if (__t < -((__uclibc_mathf_s64) 256 << 32))
+    __t = -((__uclibc_mathf_s64) 256 << 32);
+  __n = (int) (__t >> 32);
+  __f = (unsigned int) __t;
+
+  /* 2^(i/64 + r) with r < 1/64: the table times e^y, y = r ln 2,
+     e^y - 1 = y + y^2/2 + y^3/6 in Q.32. */
+  __y = __uclibc_mathf_mulhi (__f & 0x03ffffffU, __UCLIBC_MATHF_LN2);
+#ifdef __FAST_MATH__
+  __p = 0x80000000U;
+#else
+  __p = 0x80000000U + __uclibc_mathf_mulhi (__y, 0x2aaaaaabU);
+#endif
+  __p = __y + __uclibc_mathf_mulhi (__y, __uclibc_mathf_mulhi (__y, __p));
+  __m = __uclibc_mathf_exp2_tab[__f >> 26];
+  __m += __uclibc_mathf_mulhi (__m, __p);
+  return __uclibc_mathf_pack (0, __m, __n - 31);
+}
+
+static __inline float
+__uclibc_exp2f (float __x)
+{
+  unsigned int __ix = __uclibc_mathf_tobits (__x);
+  unsigned int __e = (__ix >> 23) & 0xff;
+  __uclibc_mathf_s64 __t;
+
+  if (__e == 0xff)
+    return __ix == 0xff800000U ? 0.0f : __x;
+  if (__e >= 127 + 8)
+    __t = (__uclibc_mathf_s64) 256 << 32;
+  else if (__e < 127 - 33)
+    return 1.0f;
+  else
+    {
+      /* X in Q.32: the significand shifted by E - 150 + 32. */
+      __t = (__ix & 0x007fffffU) | 0x00800000U;
+      if (__e >= 118)
+	__t <<= __e - 118;
+      else
+	__t >>= 118 - __e;
+    }
+  return __uclibc_mathf_exp2 (__ix & 0x80000000U ? -__t : __t);
+}
+
+static __inline float
+__uclibc_expf (float __x)
+{
+  unsigned int __ix = __uclibc_mathf_tobits (__x);
+  unsigned int __e = (__ix >> 23) & 0xff;
+  unsigned int __m;
+  __uclibc_mathf_u64 __t;
+
+  if (__e == 0xff)
+    return __ix == 0xff800000U ? 0.0f : __x;
+  if (__e >= 127 + 8)
+    __t = (__uclibc_mathf_u64) 256 << 32;
+  else if (__e < 127 - 33)
+    return 1.0f;
+  else
+    {
+      /* X log2 e in Q.32: the significand times log2 e in Q1.31 (with
+	 32 more bits of it), shifted by E - 150 - 31 + 32. */
+      __m = (__ix & 0x007fffffU) | 0x00800000U;
+      __t = (__uclibc_mathf_u64) __m * __UCLIBC_MATHF_LOG2E;
+#ifndef __FAST_MATH__
+      __t += ((__uclibc_mathf_u64) __m * __UCLIBC_MATHF_LOG2E_LO) >> 32;
+#endif
+      __t >>= 149 - __e;
+    }
+  return __uclibc_mathf_exp2 (__ix & 0x80000000U
+			      ? -(__uclibc_mathf_s64) __t
+			      : (__uclibc_mathf_s64) __t);
+}
+
+/**********************************************************************/
+/* log2f, logf, log10f */
+
+/* Reciprocals, in Q1.10, of the middle of each of the 64 intervals
+   [0x3f330000 + i 2^17, 0x3f330000 + (i+1) 2^17) of float bits, which
+   together cover [0.7, 1.4); exactly 1 for the one holding 1. */
+static const unsigned short __uclibc_mathf_log2_invc[64] =
+{
+  1456, 1440, 1425, 1409, 1394, 1380, 1365, 1351,
+  1337, 1324, 1311, 1298, 1285, 1273, 1260, 1248,
+  1237, 1225, 1214, 1202, 1192, 1181, 1170, 1160,
+  1150, 1140, 1130, 1120, 1111, 1101, 1092, 1083,
+  1074, 1066, 1057, 1049, 1040, 1032, 1024, 1008,
+  993, 978, 964, 950, 936, 923, 910, 898,
+  886, 874, 862, 851, 840, 830, 819, 809,
+  799, 790, 780, 771, 762, 753, 745, 736
+};
+
+/* -log2 of each reciprocal, in Q.55. */
+__extension__ static const long long int __uclibc_mathf_log2_logc[64] =
+{
+  -18295230019036669LL, -17720875370810782LL, -17176592211296634LL,
+  -16589672024325016LL, -16033349552218952LL, -15508687610252531LL,
+  -14940610187659351LL, -14404743928299366LL, -13863295628309166LL,
+  -13355421337343369LL, -12842535682129383LL, -12324538778670451LL,
+  -11801327726627962LL, -11313644085426135LL, -10780104960921707LL,
+  -10282698612149875LL, -9822523184237417LL, -9315823151018951LL,
+  -8846968611143253LL, -8330620986328487LL, -7896378136677870LL,
+  -7414483210403207LL, -6928078780772557LL, -6481908086014591LL,
+  -6031874393462981LL, -5577910225898084LL, -5119946322515857LL,
+  -4657911575509476LL, -4238539420628993LL, -3768567260607283LL,
+  -3341928202260801LL, -2911758297774936LL, -2477998616850309LL,
+  -2089372008070380LL, -1648665551613210LL, -1253764759166897LL,
+  -805885395360325LL, -404504506724485LL, 0LL,
+  818577024476843LL, 1597880479432500LL, 2389045933186414LL,
+  3138492423157931LL, 3898902990891466LL, 4670603204625993LL,
+  5397588017229495LL, 6134885014528749LL, 6824876121545383LL,
+  7524149898278002LL, 8232959520058716LL, 8951568663234589LL,
+  9619136782149843LL, 10295390241266393LL, 10917895487459394LL,
+  11611373614515068LL, 12249938977254328LL, 12896446898779709LL,
+  13485260119223568LL, 14147416421415543LL, 14750656075546456LL,
+  15360978940267503LL, 15978553335364603LL, 16533736896887548LL,
+  17165489577334119LL
+};
+
+/* log2 of the positive finite float with bits IX, in Q.55; with the
+   full polynomial even under -ffast-math if FULL. */
+static __inline __uclibc_mathf_s64
+__uclibc_mathf_log2 (unsigned int __ix, int __full)
+{
+  unsigned int __tmp;
+  unsigned int __iz;
+  unsigned int __z;
+  int __k = 0;
+  int __i;
+  int __r;
+  int __v;
+  __uclibc_mathf_s64 __p;
+  __uclibc_mathf_u64 __a;
+
+  if (__ix < 0x00800000U)
+    {
+      __k = __builtin_clz (__ix) - 8;
+      __ix <<= __k;
+      __k = -__k;
+    }
+
+  /* x = 2^k z with z in [0.7, 1.4), and log2 x = k + log2 c +
+     log2 (1 + r) where r = z / c - 1 is exact: Q.24 z times Q1.10
+     1/c is r in Q.34, with |r| < 2^-6. */
+  __tmp = __ix - 0x3f330000U;
+  __i = (__tmp >> 17) & 63;
+  __k += (int) __tmp >> 23;
+  __iz = __ix - (__tmp & 0xff800000U);
+  __z = (__iz & 0x007fffffU) | 0x00800000U;
+  if (__iz >= 0x3f800000U)
+    __z <<= 1;
+  __r = (int) ((__uclibc_mathf_u64) __z * __uclibc_mathf_log2_invc[__i]
+	       - ((__uclibc_mathf_u64) 1 << 34));
+
+  /* ln (1 + r) = r + r w, w = r (-1/2 + r/3 - r^2/4 + r^3/5) with the
+     bracket in Q.30 and w, under 2^-7, in Q.38: as precise relative to
+     r as r is small. */
+#ifdef __FAST_MATH__
+  if (!__full)
+    __v = 357913941;
+  else
+#endif
+    {
+      __v = 214748365;
+      __v = -268435456 + (int) (((__uclibc_mathf_s64) __r * __v) >> 34);
+      __v = 357913941 + (int) (((__uclibc_mathf_s64) __r * __v) >> 34);
+    }
+  __v = -536870912 + (int) (((__uclibc_mathf_s64) __r * __v) >> 34);
+  __p = (__uclibc_mathf_s64) __r * __v;
+  __p = ((__uclibc_mathf_s64) __r << 30)
+    + (((__uclibc_mathf_s64) __r * (int) (__p >> 26)) >> 8);
+
+  /* Times log2 e, to Q.63, then Q.55. */
+  __a = __p < 0 ? -(__uclibc_mathf_u64) __p : (__uclibc_mathf_u64) __p;
+  __a = __uclibc_mathf_mul64 (__a, __UCLIBC_MATHF_LOG2E)
+    + (__uclibc_mathf_mul64 (__a, __UCLIBC_MATHF_LOG2E_LO) >> 32);
+  __p = __p < 0 ? -(__uclibc_mathf_s64) __a : (__uclibc_mathf_s64) __a;
+  return ((__uclibc_mathf_s64) __k << 55) + __uclibc_mathf_log2_logc[__i]
+    + (__p >> 8);
+}
+
+/* log2, scaled by SCALE / 2^32 unless SCALE is 0, of X. */
+static __inline float
+__uclibc_mathf_log (float __x, unsigned int __scale)
+{
+  unsigned int __ix = __uclibc_mathf_tobits (__x);
+  __uclibc_mathf_s64 __l;
+  __uclibc_mathf_u64 __m;
+
+  if (__ix - 0x00800000U >= 0x7f000000U)
+    {
+      /* Zero, subnormal, infinity, NaN or negative. */
+      if ((__ix & 0x7fffffffU) == 0)
+	return __uclibc_mathf_frombits (0xff800000);
+      if (__ix > 0x80000000U && __ix <= 0xff800000U)
+	return __uclibc_mathf_frombits (0x7fc00000);
+      if (__ix >= 0x7f800000U)
+	return __x;
+    }
+  if (__ix == 0x3f800000U)
+    return 0.0f;
+  __l = __uclibc_mathf_log2 (__ix, 0);
+  __m = __l < 0 ? -(__uclibc_mathf_u64) __l : (__uclibc_mathf_u64) __l;
+  if (__scale != 0)
+    __m = __uclibc_mathf_mul64 (__m, __scale);
+  return __uclibc_mathf_pack (__l < 0 ? 0x80000000U : 0, __m, -55);
+}
+
+static __inline float
+__uclibc_log2f (float __x)
+{
+  return __uclibc_mathf_log (__x, 0);
+}
+
+static __inline float
+__uclibc_logf (float __x)
+{
+  return __uclibc_mathf_log (__x, __UCLIBC_MATHF_LN2);
+}
+
+static __inline float
+__uclibc_log10f (float __x)
+{
+  return __uclibc_mathf_log (__x, 0x4d104d42U);	/* log10 2 in Q.32 */
+}
+
+/**********************************************************************/
+/* powf */
+
+/* 0 if the finite nonzero float with bits IY is not an integer, 1 if it
+   is an odd one and 2 if an even one. */
+static __inline int
+__uclibc_mathf_integer (unsigned int __iy)
+{
+  int __e = (__iy >> 23) & 0xff;
+
+  if (__e < 127)
+    return 0;
+  if (__e > 150)
+    return 2;
+  __iy = (__iy & 0x007fffffU) | 0x00800000U;
+  if (__e < 150 && (__iy << (__e - 118)) != 0)
+    return 0;
+  return (__iy >> (150 - __e)) & 1 ? 1 : 2;
+}
+
+static __inline float
+__uclibc_powf (float __x, float __y)
+{
+  unsigned int __ix = __uclibc_mathf_tobits (__x);
+  unsigned int __iy = __uclibc_mathf_tobits (__y);
+  unsigned int __sign = 0;
+  int __e;
+  __uclibc_mathf_s64 __l;
+  __uclibc_mathf_u64 __t;
+
+  if ((__iy & 0x7fffffffU) == 0 || __ix == 0x3f800000U)
+    return 1.0f;
+  if ((__ix & 0x7fffffffU) > 0x7f800000U
+      || (__iy & 0x7fffffffU) > 0x7f800000U)
+    return __x + __y;
+  if ((__iy & 0x7fffffffU) == 0x7f800000U)
+    {
+      /* 1 for |x| == 1, else 0 or infinity. */
+      if ((__ix & 0x7fffffffU) == 0x3f800000U)
+	return 1.0f;
+      return ((__ix & 0x7fffffffU) < 0x3f800000U) == !(__iy & 0x80000000U)
+	? 0.0f : __uclibc_mathf_frombits (0x7f800000);
+    }
+  if (__ix & 0x80000000U)
+    {
+      /* The sign is that of an odd integer Y's power; a negative X to
+	 any other power is NaN unless it is -0 or -infinity. */
+      __e = __uclibc_mathf_integer (__iy);
+      if (__e == 1)
+	__sign = 0x80000000U;
+      __ix &= 0x7fffffffU;
+      if (__e == 0 && __ix != 0 && __ix != 0x7f800000U)
+	return __uclibc_mathf_frombits (0x7fc00000);
+    }
+  if (__ix == 0 || __ix == 0x7f800000U)
+    return __uclibc_mathf_frombits (__sign
+				    | ((__ix == 0) == !(__iy & 0x80000000U)
+				       ? 0 : 0x7f800000));
+
+  /* 2^(y log2 x): the Q.55 logarithm, normalized by 2^z, times the
+     significand of Y is that many Q.32 units shifted by
+     E - 150 + 32 - 55 - z.  Y multiplies the logarithm's error, so it
+     is never the -ffast-math one. */
+  __l = __uclibc_mathf_log2 (__ix, 1);
+  __t = __l < 0 ? -(__uclibc_mathf_u64) __l : (__uclibc_mathf_u64) __l;
+  __e = __uclibc_mathf_clz64 (__t);
+  __t <<= __e;
+  __e = (int) ((__iy >> 23) & 0xff) - 141 - __e;
+  __t = __uclibc_mathf_mul64 (__t, (__iy & 0x007fffffU) | 0x00800000U);
+  if (__e >= 0)
+    {
+      if (__e >= 63 || (__t >> (63 - __e)) != 0)
+	__t = (__uclibc_mathf_u64) 256 << 32;
+      else
+	__t <<= __e;
+    }
+  else if (__e > -64)
+    __t >>= -__e;
+  else
+    __t = 0;
+  if (__t > (__uclibc_mathf_u64) 256 << 32)
+    __t = (__uclibc_mathf_u64) 256 << 32;
+  if ((__l < 0) != ((__iy & 0x80000000U) != 0))
+    __t = -__t;
+  return __uclibc_mathf_frombits
+    (__sign | __uclibc_mathf_tobits (__uclibc_mathf_exp2
+				     ((__uclibc_mathf_s64) __t)));
+}
+
+/**********************************************************************/
+/* sinf, cosf */
+
+/* The bits of 2/pi, after a zero word for the bits before the point. */
+static const unsigned int __uclibc_mathf_2opi[8] =
+{
+  0x00000000, 0xa2f9836e, 0x4e441529, 0xfc2757d1,
+  0xf534ddc0, 0xdb629599, 0x3c439041, 0xfe5163ab
+};
+
+#define __UCLIBC_MATHF_PIO2	0xc90fdaa2U	/* pi/2 in Q1.31 */
+
+/* Reduces the finite float with bits IX, at least pi/4, to x - q pi/2
+   in [-pi/4, pi/4]: returns q mod 4, and the reduced argument as
+   M 2^*E with the top bit of M set and *NEG as its sign bit.
+
+   x 2/pi mod 4 is the significand times the 96 bits of 2/pi whose
+   products with it are neither multiples of 4 nor below 2^-70, and
+   only the low 96 bits of that product count.  That leaves more than
+   enough bits after the cancellation for the floats nearest to
+   multiples of pi/2. */
+static __inline int
+__uclibc_mathf_rem_pio2 (unsigned int __ix, unsigned int *__m, int *__e,
+			 unsigned int *__neg)
+{
+  unsigned int __w[3];
+  unsigned int __r0;
+  unsigned int __r1;
+  unsigned int __r2;
+  unsigned int __lo;
+  unsigned int __s;
+  unsigned int __mx;
+  int __i;
+  int __q;
+  __uclibc_mathf_u64 __p1;
+  __uclibc_mathf_u64 __p2;
+  __uclibc_mathf_u64 __hi;
+
+  /* Bit k of 2/pi (weight 2^-k) is bit k + 31 of the table; the first
+     one wanted is k = E - 151 for the biased exponent E. */
+  __i = (int) (__ix >> 23) - 120;
+  __s = __i & 31;
+  __i >>= 5;
+  if (__s == 0)
+    {
+      __w[0] = __uclibc_mathf_2opi[__i];
+      __w[1] = __uclibc_mathf_2opi[__i + 1];
+      __w[2] = __uclibc_mathf_2opi[__i + 2];
+    }
+  else
+    {
+      __w[0] = (__uclibc_mathf_2opi[__i] << __s)
+	| (__uclibc_mathf_2opi[__i + 1] >> (32 - __s));
+      __w[1] = (__uclibc_mathf_2opi[__i + 1] << __s)
+	| (__uclibc_mathf_2opi[__i + 2] >> (32 - __s));
+      __w[2] = (__uclibc_mathf_2opi[__i + 2] << __s)
+	| (__uclibc_mathf_2opi[__i + 3] >> (32 - __s));
+    }
+  __mx = (__ix & 0x007fffffU) | 0x00800000U;
+  __p2 = (__uclibc_mathf_u64) __mx * __w[2];
+  __p1 = (__uclibc_mathf_u64) __mx * __w[1] + (__p2 >> 32);
+  __r2 = (unsigned int) __p2;
+  __r1 = (unsigned int) __p1;
+  __r0 = (unsigned int) (__p1 >> 32) + __mx * __w[0];
+
+  /* The top two bits are the quadrant and the other 94 the fraction of
+     a quarter turn, here in HI:LO; round to the nearest quadrant. */
+  __q = __r0 >> 30;
+  __hi = ((__uclibc_mathf_u64) __r0 << 34) | ((__uclibc_mathf_u64) __r1 << 2)
+    | (__r2 >> 30);
+  __lo = __r2 << 2;
+  *__neg = 0;
+  if (__hi >> 63)
+    {
+      ++__q;
+      *__neg = 0x80000000U;
+      __lo = -__lo;
+      __hi = ~__hi + (__lo == 0);
+    }
+
+  /* Normalized, times pi/2. */
+  __s = 0;
+  if (__hi == 0)
+    {
+      __hi = (__uclibc_mathf_u64) __lo << 32;
+      __lo = 0;
+      __s = 32;
+      if (__hi == 0)
+	__hi = 1;
+    }
+  __i = __uclibc_mathf_clz64 (__hi);
+  if (__i != 0)
+    __hi = (__hi << __i) | ((__uclibc_mathf_u64) __lo << 32 >> (64 - __i));
+  __i += __s;
+  __hi = (__hi >> 32) * __UCLIBC_MATHF_PIO2;
+  if (__hi >> 63)
+    {
+      *__m = (unsigned int) (__hi >> 32);
+      *__e = -31 - __i;
+    }
+  else
+    {
+      *__m = (unsigned int) (__hi >> 31);
+      *__e = -32 - __i;
+    }
+  return __q & 3;
+}
+
+/* sin of M 2^E in [-pi/4, pi/4] as above, or its cos if COS, with SIGN
+   as the sign bit. */
+static __inline float
+__uclibc_mathf_sincos (unsigned int __m, int __e, unsigned int __sign,
+		       int __cos)
+{
+  unsigned int __z;
+  unsigned int __p;
+
+  /* z = x^2 in Q.32 for the polynomials in it, whose terms shrink
+     quickly enough that Q.32 is precise relative to their sum. */
+  __z = -__e - 32 < 32 ? __m >> (-__e - 32) : 0;
+  __z = __uclibc_mathf_mulhi (__z, __z);
+  if (__cos)
+    {
+      /* 1 - z/2 + z^2/4! - z^3/6! + z^4/8! (- z^5/10!). */
+#ifdef __FAST_MATH__
+      __p = 0x0001a01aU;
+#else
+      __p = 0x0001a01aU - __uclibc_mathf_mulhi (__z, 0x000004a0U);
+#endif
+      __p = 0x005b05b0U - __uclibc_mathf_mulhi (__z, __p);
+      __p = 0x0aaaaaabU - __uclibc_mathf_mulhi (__z, __p);
+      __p = 0x80000000U - __uclibc_mathf_mulhi (__z, __p);
+      __p = 0x80000000U - (__uclibc_mathf_mulhi (__z, __p) >> 1);
+      return __uclibc_mathf_pack (__sign, __p, -31);
+    }
+  /* x (1 - z/3! + z^2/5! - z^3/7! (+ z^4/9!)). */
+#ifdef __FAST_MATH__
+  __p = 0x000d00d0U;
+#else
+  __p = 0x000d00d0U - __uclibc_mathf_mulhi (__z, 0x00002e3cU);
+#endif
+  __p = 0x02222222U - __uclibc_mathf_mulhi (__z, __p);
+  __p = 0x2aaaaaabU - __uclibc_mathf_mulhi (__z, __p);
+  __p = 0x80000000U - (__uclibc_mathf_mulhi (__z, __p) >> 1);
+  return __uclibc_mathf_pack (__sign, (__uclibc_mathf_u64) __m * __p,
+			      __e - 31);
+}
+
+static __inline float
+__uclibc_mathf_sin (float __x, int __cos)
+{
+  unsigned int __ix = __uclibc_mathf_tobits (__x);
+  unsigned int __sign = __ix & 0x80000000U;
+  unsigned int __neg = 0;
+  unsigned int __m;
+  int __e;
+  int __q;
+
+  __ix &= 0x7fffffffU;
+  if (__ix >= 0x7f800000U)
+    return __ix == 0x7f800000U ? __uclibc_mathf_frombits (0x7fc00000)
+      : __x;
+  if (__ix < 0x39800000U)
+    /* |x| < 2^-12: sin x rounds to x and cos x to 1. */
+    return __cos ? 1.0f : __x;
+  if (__ix < 0x3f490fdbU)
+    {
+      /* |x| < pi/4: no reduction. */
+      __m = ((__ix & 0x007fffffU) | 0x00800000U) << 8;
+      __e = (int) (__ix >> 23) - 158;
+      __q = 0;
+    }
+  else
+    __q = __uclibc_mathf_rem_pio2 (__ix, &__m, &__e, &__neg);
+
+  /* cos x is sin (|x| + pi/2), and sin (t + q pi/2) is sin t, cos t,
+     -sin t or -cos t. */
+  if (__cos)
+    {
+      __sign = 0;
+      ++__q;
+    }
+  if (__q & 2)
+    __sign ^= 0x80000000U;
+  if (__q & 1)
+    return __uclibc_mathf_sincos (__m, __e, __sign, 1);
+  return __uclibc_mathf_sincos (__m, __e, __sign ^ __neg, 0);
+}
+
+static __inline float
+__uclibc_sinf (float __x)
+{
+  return __uclibc_mathf_sin (__x, 0);
+}
+
+static __inline float
+__uclibc_cosf (float __x)
+{
+  return __uclibc_mathf_sin (__x, 1);
+}
+
+#endif /* _BITS_UCLIBC_MATHF_H */
@@ -0,0 +1,536 @@
+/* Inline spinlocks, barriers and futex read-write locks for uClibc.
+ *
+ * GNU Library General Public License (LGPL) version 2 or later.
+ *
+ * linuxthreads has no pthread_spin_* or pthread_barrier_*, and its
+ * rwlocks go through the manager-thread fastlock machinery.  The
+ * primitives here are self contained: they use the kernel's
+ * cmpxchg helper (present on every ARM kernel since 2.6.12) for the
+ * atomic step and FUTEX_WAIT/FUTEX_WAKE only when a thread really has
+ * to block, so the uncontended paths never leave user space.
+ *
+ * Every lock carries an optional pointer to a struct pthread_lock_stats.
+ * When it is NULL (the default after init) the only cost is a single
+ * test on the contended path.
+ */
+
+#ifndef _PTHREAD_H
+#error Always include <pthread.h> rather than <bits/uClibc_pthread_lock.h>
+#endif
+
+#ifndef _BITS_UCLIBC_PTHREAD_LOCK_H
+#define _BITS_UCLIBC_PTHREAD_LOCK_H	1
+
+#include <errno.h>
+#include <limits.h>
+#include <sys/time.h>
+#include <sys/syscall.h>
+
+/**********************************************************************/
+/* Atomic primitives. */
+
+/* int __kernel_cmpxchg(int oldval, int newval, volatile int *ptr);
+ * Returns zero if *ptr was changed from oldval to newval.  The kernel
+ * provides the right implementation (restartable sequence on UP,
+ * ldrex/strex plus barriers on SMP) at this fixed address. */
+typedef int (__pthread_kernel_cmpxchg_t) (int __oldval, int __newval,
+					  volatile int *__ptr);
+#define __pthread_kernel_cmpxchg \
+	(*(__pthread_kernel_cmpxchg_t *) 0xffff0fc0)
+
+#define __pthread_compiler_barrier()	__asm__ __volatile__ ("" : : : "memory")
+
+/* Atomically add VAL to *MEM and return the previous value. */
+static __inline int
+__pthread_atomic_add (volatile int *__mem, int __val)
+{
+  int __old;
+
+  do
+    __old = *__mem;
+  while (__pthread_kernel_cmpxchg (__old, __old + __val, __mem) != 0);
+  return __old;
+}
+
+/* Nonzero if *MEM was changed from OLDVAL to NEWVAL. */
+static __inline int
+__pthread_atomic_cas (volatile int *__mem, int __oldval, int __newval)
+{
+  return __pthread_kernel_cmpxchg (__oldval, __newval, __mem) == 0;
+}
+
+extern long int syscall (long int __sysno, ...) __THROW;
+
+#define __PTHREAD_FUTEX_WAIT		0
+#define __PTHREAD_FUTEX_WAKE		1
+
+static __inline void
+__pthread_futex_wait (volatile int *__addr, int __val)
+{
+  syscall (__NR_futex, __addr, __PTHREAD_FUTEX_WAIT, __val, NULL);
+}
+
+static __inline void
+__pthread_futex_wake (volatile int *__addr, int __nr)
+{
+  syscall (__NR_futex, __addr, __PTHREAD_FUTEX_WAKE, __nr);
+}
+
+/* A plain mutex in one int, for the library's own tables: 0 unlocked,
+   1 locked, 2 locked with waiters.  Waiters sleep on the futex, so a
+   preempted holder costs nothing but latency. */
+static __inline void
+__pthread_futex_lock (volatile int *__l)
+{
+  if (__pthread_atomic_cas (__l, 0, 1))
+    return;
+  do
+    if (*__l == 2 || __pthread_atomic_cas (__l, 1, 2))
+      __pthread_futex_wait (__l, 2);
+  while (!__pthread_atomic_cas (__l, 0, 2));
+}
+
+static __inline void
+__pthread_futex_unlock (volatile int *__l)
+{
+  if (__pthread_atomic_add (__l, -1) != 1)
+    {
+      *__l = 0;
+      __pthread_futex_wake (__l, 1);
+    }
+}
+
+/**********************************************************************/
+/* Contention statistics. */
+
+/* Per-lock counters, filled in when attached to a lock with one of the
+   *_setstats_np functions.  All times are in microseconds and are only
+   measured on the contended path; the wait totals wrap after about
+   71 minutes of accumulated waiting. */
+struct pthread_lock_stats
+{
+  unsigned long int acquisitions;	/* Successful lock/wait calls */
+  unsigned long int contentions;	/* Calls that had to wait */
+  unsigned long int wait_usec;		/* Total time spent waiting */
+  unsigned long int max_wait_usec;	/* Longest single wait */
+};
+
+#ifdef __USE_GNU
+/* Zero all counters in STATS. */
+static __inline void
+pthread_lock_stats_reset_np (struct pthread_lock_stats *__stats)
+{
+  __stats->acquisitions = 0;
+  __stats->contentions = 0;
+  __stats->wait_usec = 0;
+  __stats->max_wait_usec = 0;
+}
+#endif
+
+static __inline unsigned long int
+__pthread_lock_stats_now (void)
+{
+  struct timeval __tv;
+
+  gettimeofday (&__tv, NULL);
+  return __tv.tv_sec * 1000000UL + __tv.tv_usec;
+}
+
+/* Account one acquisition.  START is the value of
+   __pthread_lock_stats_now() when the caller began waiting, or zero if
+   it got the lock without waiting.  The counters are updated
+   atomically since shared acquisitions (read locks, barriers) can
+   record concurrently. */
+static __inline void
+__pthread_lock_stats_record (struct pthread_lock_stats *__stats,
+			     unsigned long int __start)
+{
+  volatile int *__max;
+  int __waited;
+  int __old;
+
+  __pthread_atomic_add ((volatile int *) &__stats->acquisitions, 1);
+  if (__start == 0)
+    return;
+  __waited = (int) (__pthread_lock_stats_now () - __start);
+  __pthread_atomic_add ((volatile int *) &__stats->contentions, 1);
+  __pthread_atomic_add ((volatile int *) &__stats->wait_usec, __waited);
+  __max = (volatile int *) &__stats->max_wait_usec;
+  do
+    __old = *__max;
+  while ((unsigned int) __waited > (unsigned int) __old
+	 && !__pthread_atomic_cas (__max, __old, __waited));
+}
+
+/**********************************************************************/
+/* Spinlocks. */
+
+#ifdef __USE_XOPEN2K
+/* Number of busy polls of a held spinlock before the waiter starts to
+   yield the CPU.  On a uniprocessor the holder cannot make progress
+   while we spin, so this is kept small; define it before including
+   <pthread.h> to tune it for SMP parts. */
+# ifndef __PTHREAD_SPIN_COUNT
+#  define __PTHREAD_SPIN_COUNT		4
+# endif
+/* Number of sched_yield() calls before the waiter starts sleeping a
+   tick at a time.  sched_yield() only hands the CPU to threads of equal
+   priority, so a real-time waiter must eventually sleep to let a
+   lower-priority holder run. */
+# ifndef __PTHREAD_YIELD_COUNT
+#  define __PTHREAD_YIELD_COUNT		16
+# endif
+
+/* Back off while waiting for a lock; ROUND counts calls made so far. */
+static __inline void
+__pthread_lock_backoff (unsigned int __round)
+{
+  if (__round < __PTHREAD_SPIN_COUNT)
+    __pthread_compiler_barrier ();
+  else if (__round < __PTHREAD_SPIN_COUNT + __PTHREAD_YIELD_COUNT)
+    sched_yield ();
+  else
+    {
+      struct timespec __ts = { 0, 1 };
+      nanosleep (&__ts, NULL);
+    }
+}
+
+/* Initialize the spinlock LOCK.  PSHARED is accepted for compatibility;
+   the lock word works unchanged when placed in shared memory. */
+static __inline int
+pthread_spin_init (pthread_spinlock_t *__lock, int __pshared)
+{
+  __lock->__sl_ticket = 0;
+  __lock->__sl_stats = NULL;
+  return 0;
+}
+
+/* Destroy the spinlock LOCK.  */
+static __inline int
+pthread_spin_destroy (pthread_spinlock_t *__lock)
+{
+  return 0;
+}
+
+/* Wait until spinlock LOCK is retrieved.  Waiters are served in
+   arrival order.  */
+static __inline int
+pthread_spin_lock (pthread_spinlock_t *__lock)
+{
+  volatile int *__word = (volatile int *) &__lock->__sl_ticket;
+  unsigned int __me;
+  unsigned int __round;
+  unsigned long int __start;
+
+  __me = (unsigned int) __pthread_atomic_add (__word, 0x10000) >> 16;
+  if ((__lock->__sl_ticket & 0xffff) == __me)
+    {
+      if (__lock->__sl_stats != NULL)
+	__pthread_lock_stats_record (__lock->__sl_stats, 0);
+      return 0;
+    }
+
+  __start = __lock->__sl_stats != NULL ? __pthread_lock_stats_now () | 1 : 0;
+  __round = 0;
+  while ((__lock->__sl_ticket & 0xffff) != __me)
+    __pthread_lock_backoff (__round++);
+  __pthread_compiler_barrier ();
+  if (__lock->__sl_stats != NULL)
+    __pthread_lock_stats_record (__lock->__sl_stats, __start);
+  return 0;
+}
+
+/* Try to lock spinlock LOCK.  */
+static __inline int
+pthread_spin_trylock (pthread_spinlock_t *__lock)
+{
+  volatile int *__word = (volatile int *) &__lock->__sl_ticket;
+  unsigned int __old = __lock->__sl_ticket;
+
+  if ((__old >> 16) != (__old & 0xffff)
+      || !__pthread_atomic_cas (__word, __old, __old + 0x10000))
+    return EBUSY;
+  if (__lock->__sl_stats != NULL)
+    __pthread_lock_stats_record (__lock->__sl_stats, 0);
+  return 0;
+}
+
+/* Release spinlock LOCK.  */
+static __inline int
+pthread_spin_unlock (pthread_spinlock_t *__lock)
+{
+  volatile int *__word = (volatile int *) &__lock->__sl_ticket;
+  unsigned int __old;
+
+  /* Only the "now serving" half changes, but a concurrent lock call
+     may be bumping the other half, so this must be atomic too. */
+  __pthread_compiler_barrier ();
+  do
+    __old = __lock->__sl_ticket;
+  while (!__pthread_atomic_cas (__word, __old,
+				(__old & 0xffff0000) | ((__old + 1) & 0xffff)));
+  return 0;
+}
+
+# ifdef __USE_GNU
+/* Attach STATS (or detach with NULL) to spinlock LOCK. */
+static __inline int
+pthread_spin_setstats_np (pthread_spinlock_t *__lock,
+			  struct pthread_lock_stats *__stats)
+{
+  __lock->__sl_stats = __stats;
+  return 0;
+}
+# endif
+#endif
+
+/**********************************************************************/
+/* Barriers. */
+
+#ifdef __USE_XOPEN2K
+static __inline int
+pthread_barrierattr_init (pthread_barrierattr_t *__attr)
+{
+  __attr->__pshared = PTHREAD_PROCESS_PRIVATE;
+  return 0;
+}
+
+static __inline int
+pthread_barrierattr_destroy (pthread_barrierattr_t *__attr)
+{
+  return 0;
+}
+
+static __inline int
+pthread_barrierattr_getpshared (__const pthread_barrierattr_t *
+				__restrict __attr,
+				int *__restrict __pshared)
+{
+  *__pshared = __attr->__pshared;
+  return 0;
+}
+
+static __inline int
+pthread_barrierattr_setpshared (pthread_barrierattr_t *__attr,
+				int __pshared)
+{
+  if (__pshared != PTHREAD_PROCESS_PRIVATE
+      && __pshared != PTHREAD_PROCESS_SHARED)
+    return EINVAL;
+  __attr->__pshared = __pshared;
+  return 0;
+}
+
+/* Initialize BARRIER to release waiters in groups of COUNT.  */
+static __inline int
+pthread_barrier_init (pthread_barrier_t *__restrict __barrier,
+		      __const pthread_barrierattr_t *__restrict __attr,
+		      unsigned int __count)
+{
+  if (__count == 0 || __count > INT_MAX)
+    return EINVAL;
+  __barrier->__ba_left = __count;
+  __barrier->__ba_sense = 0;
+  __barrier->__ba_required = __count;
+  __barrier->__ba_stats = NULL;
+  return 0;
+}
+
+static __inline int
+pthread_barrier_destroy (pthread_barrier_t *__barrier)
+{
+  if (__barrier->__ba_left != (int) __barrier->__ba_required)
+    return EBUSY;
+  return 0;
+}
+
+/* Wait until COUNT threads have reached BARRIER.  Exactly one of them
+   gets PTHREAD_BARRIER_SERIAL_THREAD, the rest get zero.  */
+static __inline int
+pthread_barrier_wait (pthread_barrier_t *__barrier)
+{
+  int __sense = __barrier->__ba_sense;
+  unsigned long int __start;
+
+  if (__pthread_atomic_add (&__barrier->__ba_left, -1) == 1)
+    {
+      /* Last to arrive: re-arm for the next round before releasing
+	 anyone, then flip the sense and wake the sleepers. */
+      __barrier->__ba_left = __barrier->__ba_required;
+      __pthread_compiler_barrier ();
+      __barrier->__ba_sense = !__sense;
+      __pthread_futex_wake (&__barrier->__ba_sense, INT_MAX);
+      if (__barrier->__ba_stats != NULL)
+	__pthread_lock_stats_record (__barrier->__ba_stats, 0);
+      return PTHREAD_BARRIER_SERIAL_THREAD;
+    }
+
+  __start = __barrier->__ba_stats != NULL
+	    ? __pthread_lock_stats_now () | 1 : 0;
+  while (__barrier->__ba_sense == __sense)
+    __pthread_futex_wait (&__barrier->__ba_sense, __sense);
+  if (__barrier->__ba_stats != NULL)
+    __pthread_lock_stats_record (__barrier->__ba_stats, __start);
+  return 0;
+}
+
+# ifdef __USE_GNU
+/* Attach STATS (or detach with NULL) to BARRIER.  Every thread but the
+   last to arrive counts as a contention. */
+static __inline int
+pthread_barrier_setstats_np (pthread_barrier_t *__barrier,
+			     struct pthread_lock_stats *__stats)
+{
+  __barrier->__ba_stats = __stats;
+  return 0;
+}
+# endif
+#endif
+
+/**********************************************************************/
+/* Writer-preferring futex read-write locks. */
+
+#ifdef __USE_GNU
+/* Unlike pthread_rwlock_t, a pthread_fastrwlock_t never takes an
+   internal lock: readers and writers claim __rw_state with a single
+   compare-and-swap, and sleep on __rw_seq only while the lock is held
+   in a conflicting mode.  New readers are held back as soon as a
+   writer is waiting, so a thread must not take a read lock it
+   already holds (compare PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP). */
+
+# define PTHREAD_FASTRWLOCK_INITIALIZER_NP { 0, 0, 0, 0, NULL }
+
+static __inline int
+pthread_fastrwlock_init_np (pthread_fastrwlock_t *__rwlock)
+{
+  __rwlock->__rw_state = 0;
+  __rwlock->__rw_writers = 0;
+  __rwlock->__rw_sleepers = 0;
+  __rwlock->__rw_seq = 0;
+  __rwlock->__rw_stats = NULL;
+  return 0;
+}
+
+static __inline int
+pthread_fastrwlock_destroy_np (pthread_fastrwlock_t *__rwlock)
+{
+  if (__rwlock->__rw_state != 0)
+    return EBUSY;
+  return 0;
+}
+
+/* Sleep until the lock state may have changed.  BUSY re-checks, after
+   we have registered as a sleeper and sampled the sequence number,
+   that the lock is still unavailable; any release after that point
+   bumps __rw_seq and makes the futex wait return at once. */
+#define __pthread_fastrwlock_sleep(__rwlock, __busy) \
+  do {									      \
+    int __seq;								      \
+    __pthread_atomic_add (&(__rwlock)->__rw_sleepers, 1);		      \
+    __seq = (__rwlock)->__rw_seq;					      \
+    if (__busy)								      \
+      __pthread_futex_wait (&(__rwlock)->__rw_seq, __seq);		      \
+    __pthread_atomic_add (&(__rwlock)->__rw_sleepers, -1);		      \
+  } while (0)
+
+static __inline int
+pthread_fastrwlock_tryrdlock_np (pthread_fastrwlock_t *__rwlock)
+{
+  int __state = __rwlock->__rw_state;
+
+  if (__state < 0 || __rwlock->__rw_writers != 0
+      || !__pthread_atomic_cas (&__rwlock->__rw_state, __state, __state + 1))
+    return EBUSY;
+  if (__rwlock->__rw_stats != NULL)
+    __pthread_lock_stats_record (__rwlock->__rw_stats, 0);
+  return 0;
+}
+
+static __inline int
+pthread_fastrwlock_rdlock_np (pthread_fastrwlock_t *__rwlock)
+{
+  unsigned long int __start = 0;
+  int __state;
+
+  for (;;)
+    {
+      __state = __rwlock->__rw_state;
+      if (__state >= 0 && __rwlock->__rw_writers == 0)
+	{
+	  if (__pthread_atomic_cas (&__rwlock->__rw_state, __state,
+				    __state + 1))
+	    break;
+	  continue;
+	}
+      if (__start == 0 && __rwlock->__rw_stats != NULL)
+	__start = __pthread_lock_stats_now () | 1;
+      __pthread_fastrwlock_sleep (__rwlock,
+				  __rwlock->__rw_state < 0
+				  || __rwlock->__rw_writers != 0);
+    }
+  __pthread_compiler_barrier ();
+  if (__rwlock->__rw_stats != NULL)
+    __pthread_lock_stats_record (__rwlock->__rw_stats, __start);
+  return 0;
+}
+
+static __inline int
+pthread_fastrwlock_trywrlock_np (pthread_fastrwlock_t *__rwlock)
+{
+  if (!__pthread_atomic_cas (&__rwlock->__rw_state, 0, -1))
+    return EBUSY;
+  if (__rwlock->__rw_stats != NULL)
+    __pthread_lock_stats_record (__rwlock->__rw_stats, 0);
+  return 0;
+}
+
+static __inline int
+pthread_fastrwlock_wrlock_np (pthread_fastrwlock_t *__rwlock)
+{
+  unsigned long int __start = 0;
+
+  if (!__pthread_atomic_cas (&__rwlock->__rw_state, 0, -1))
+    {
+      if (__rwlock->__rw_stats != NULL)
+	__start = __pthread_lock_stats_now () | 1;
+      /* Announce ourselves so that no new readers get in. */
+      __pthread_atomic_add (&__rwlock->__rw_writers, 1);
+      while (!__pthread_atomic_cas (&__rwlock->__rw_state, 0, -1))
+	__pthread_fastrwlock_sleep (__rwlock, __rwlock->__rw_state != 0);
+      __pthread_atomic_add (&__rwlock->__rw_writers, -1);
+    }
+  __pthread_compiler_barrier ();
+  if (__rwlock->__rw_stats != NULL)
+    __pthread_lock_stats_record (__rwlock->__rw_stats, __start);
+  return 0;
+}
+
+static __inline int
+pthread_fastrwlock_unlock_np (pthread_fastrwlock_t *__rwlock)
+{
+  __pthread_compiler_barrier ();
+  if (__rwlock->__rw_state < 0)
+    __rwlock->__rw_state = 0;
+  else if (__pthread_atomic_add (&__rwlock->__rw_state, -1) != 1)
+    return 0;		/* Other readers still hold it. */
+
+  if (__rwlock->__rw_sleepers != 0)
+    {
+      __pthread_atomic_add (&__rwlock->__rw_seq, 1);
+      __pthread_futex_wake (&__rwlock->__rw_seq, INT_MAX);
+    }
+  return 0;
+}
+
+/* Attach STATS (or detach with NULL) to RWLOCK. */
+static __inline int
+pthread_fastrwlock_setstats_np (pthread_fastrwlock_t *__rwlock,
+				struct pthread_lock_stats *__stats)
+{
+  __rwlock->__rw_stats = __stats;
+  return 0;
+}
+#endif
+
+#endif /* _BITS_UCLIBC_PTHREAD_LOCK_H */
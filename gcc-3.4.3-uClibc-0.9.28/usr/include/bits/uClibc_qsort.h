@@ -0,0 +1,297 @@
+/* Inline introsort for qsort and qsort_r.
+ *
+ * GNU Library General Public License (LGPL) version 2 or later.
+ *
+ * The qsort in libc is a shell sort, O(n^1.5) and with a byte loop
+ * for every swap.  This one is an introsort: median-of-three (ninther
+ * for large partitions) quicksort, recursing only into the smaller
+ * side, with insertion sort for short partitions and a heapsort
+ * fallback once the recursion gets deeper than 2 log2 n, so it stays
+ * O(n log n) on any input.  Elements that are word aligned are swapped
+ * a word at a time, with straight-line code for 4, 8 and 16 byte
+ * elements.
+ *
+ * <stdlib.h> maps qsort onto __uclibc_qsort for C; <cstdlib> #undefs
+ * the macro, so C++ keeps the library function.
+ */
+
+#ifndef _STDLIB_H
+#error Always include <stdlib.h> rather than <bits/uClibc_qsort.h>
+#endif
+
+#ifndef _BITS_UCLIBC_QSORT_H
+#define _BITS_UCLIBC_QSORT_H	1
+
+/* Partitions of at most this many elements are insertion sorted. */
+#define __UCLIBC_QSORT_SMALL	8
+
+/* How elements are swapped; picked once per sort. */
+#define __UCLIBC_QSORT_BYTES	0	/* Byte loop */
+#define __UCLIBC_QSORT_WORDS	1	/* Word loop */
+#define __UCLIBC_QSORT_4	2
+#define __UCLIBC_QSORT_8	3
+#define __UCLIBC_QSORT_16	4
+
+/* The elements have the caller's type; this one may alias it. */
+typedef int __attribute__ ((__may_alias__)) __uclibc_qsort_word_t;
+
+struct __uclibc_qsort_ctx
+{
+  size_t __size;
+  int __swap;
+  __compar_fn_t __cmp;		/* qsort comparison, or */
+  __compar_d_fn_t __cmp_r;	/* qsort_r comparison and its argument */
+  void *__arg;
+};
+
+static __inline int
+__uclibc_qsort_cmp (const struct __uclibc_qsort_ctx *__ctx,
+		    const void *__a, const void *__b)
+{
+  if (__ctx->__cmp_r != NULL)
+    return __ctx->__cmp_r (__a, __b, __ctx->__arg);
+  return __ctx->__cmp (__a, __b);
+}
+
+static __inline void
+__uclibc_qsort_swap (const struct __uclibc_qsort_ctx *__ctx,
+		     char *__a, char *__b)
+{
+  __uclibc_qsort_word_t *__x = (__uclibc_qsort_word_t *) __a;
+  __uclibc_qsort_word_t *__y = (__uclibc_qsort_word_t *) __b;
+  __uclibc_qsort_word_t __t;
+  __uclibc_qsort_word_t __u;
+  size_t __n;
+  char __c;
+
+  switch (__ctx->__swap)
+    {
+    case __UCLIBC_QSORT_16:
+      __t = __x[2]; __u = __x[3];
+      __x[2] = __y[2]; __x[3] = __y[3];
+      __y[2] = __t; __y[3] = __u;
+      /* Fall through.  */
+    case __UCLIBC_QSORT_8:
+      __t = __x[1]; __x[1] = __y[1]; __y[1] = __t;
+      /* Fall through.  */
+    case __UCLIBC_QSORT_4:
+      __t = __x[0]; __x[0] = __y[0]; __y[0] = __t;
+      return;
+    case __UCLIBC_QSORT_WORDS:
+      for (__n = __ctx->__size / sizeof (__t); __n != 0; --__n)
+	{
+	  __t = *__x;
+	  *__x++ = *__y;
+	  *__y++ = __t;
+	}
+      return;
+    default:
+      for (__n = __ctx->__size; __n != 0; --__n)
+	{
+	  __c = *__a;
+	  *__a++ = *__b;
+	  *__b++ = __c;
+	}
+    }
+}
+
+/* The median of the elements at A, B and C. */
+static __inline char *
+__uclibc_qsort_med3 (const struct __uclibc_qsort_ctx *__ctx,
+		     char *__a, char *__b, char *__c)
+{
+  if (__uclibc_qsort_cmp (__ctx, __a, __b) < 0)
+    {
+      if (__uclibc_qsort_cmp (__ctx, __b, __c) < 0)
+	return __b;
+      return __uclibc_qsort_cmp (__ctx, __a, __c) < 0 ? __c : __a;
+    }
+  if (__uclibc_qsort_cmp (__ctx, __b, __c) > 0)
+    return __b;
+  return __uclibc_qsort_cmp (__ctx, __a, __c) > 0 ? __c : __a;
+}
+
+static __inline void
+__uclibc_qsort_insertion (const struct __uclibc_qsort_ctx *__ctx,
+			  char *__lo, char *__hi)
+{
+  const size_t __size = __ctx->__size;
+  char *__i;
+  char *__j;
+
+  for (__i = __lo + __size; __i <= __hi; __i += __size)
+    for (__j = __i;
+	 __j > __lo && __uclibc_qsort_cmp (__ctx, __j - __size, __j) > 0;
+	 __j -= __size)
+      __uclibc_qsort_swap (__ctx, __j - __size, __j);
+}
+
+/* Restores the heap property below ROOT in the heap of N elements at
+   BASE. */
+static __inline void
+__uclibc_qsort_sift (const struct __uclibc_qsort_ctx *__ctx, char *__base,
+		     size_t __root, size_t __n)
+{
+  const size_t __size = __ctx->__size;
+  size_t __child;
+
+  while ((__child = 2 * __root + 1) < __n)
+    {
+      if (__child + 1 < __n
+	  && __uclibc_qsort_cmp (__ctx, __base + __child * __size,
+				 __base + (__child + 1) * __size) < 0)
+	++__child;
+      if (__uclibc_qsort_cmp (__ctx, __base + __root * __size,
+			      __base + __child * __size) >= 0)
+	return;
+      __uclibc_qsort_swap (__ctx, __base + __root * __size,
+			   __base + __child * __size);
+      __root = __child;
+    }
+}
+
+static __inline void
+__uclibc_qsort_heap (const struct __uclibc_qsort_ctx *__ctx, char *__base,
+		     size_t __n)
+{
+  size_t __i;
+
+  for (__i = __n / 2; __i != 0; --__i)
+    __uclibc_qsort_sift (__ctx, __base, __i - 1, __n);
+  for (__i = __n - 1; __i != 0; --__i)
+    {
+      __uclibc_qsort_swap (__ctx, __base, __base + __i * __ctx->__size);
+      __uclibc_qsort_sift (__ctx, __base, 0, __i);
+    }
+}
+
+/* Sorts the N elements at LO, switching to heapsort after DEPTH more
+   levels of partitioning. */
+static __inline void
+__uclibc_qsort_intro (const struct __uclibc_qsort_ctx *__ctx, char *__lo,
+		      size_t __n, unsigned int __depth)
+{
+  const size_t __size = __ctx->__size;
+  char *__hi;
+  char *__mid;
+  char *__i;
+  char *__j;
+  size_t __left;
+  size_t __step;
+
+  while (__n > __UCLIBC_QSORT_SMALL)
+    {
+      if (__depth-- == 0)
+	{
+	  __uclibc_qsort_heap (__ctx, __lo, __n);
+	  return;
+	}
+
+      __hi = __lo + (__n - 1) * __size;
+      __mid = __lo + (__n / 2) * __size;
+      if (__n > 40)
+	{
+	  __step = (__n / 8) * __size;
+	  __mid = __uclibc_qsort_med3
+	    (__ctx,
+	     __uclibc_qsort_med3 (__ctx, __lo, __lo + __step,
+				  __lo + 2 * __step),
+	     __uclibc_qsort_med3 (__ctx, __mid - __step, __mid,
+				  __mid + __step),
+	     __uclibc_qsort_med3 (__ctx, __hi - 2 * __step, __hi - __step,
+				  __hi));
+	}
+      else
+	__mid = __uclibc_qsort_med3 (__ctx, __lo, __mid, __hi);
+      __uclibc_qsort_swap (__ctx, __lo, __mid);
+
+      /* Hoare partition around the pivot at LO.  Both scans stop on
+	 keys equal to the pivot, which splits runs of equal keys
+	 evenly instead of degrading to quadratic time. */
+      __i = __lo;
+      __j = __hi + __size;
+      for (;;)
+	{
+	  do
+	    __i += __size;
+	  while (__i <= __hi && __uclibc_qsort_cmp (__ctx, __i, __lo) < 0);
+	  do
+	    __j -= __size;
+	  while (__uclibc_qsort_cmp (__ctx, __j, __lo) > 0);
+	  if (__i >= __j)
+	    break;
+	  __uclibc_qsort_swap (__ctx, __i, __j);
+	}
+      __uclibc_qsort_swap (__ctx, __lo, __j);
+
+      /* [LO, J) and (J, HI] are left; recurse into the smaller. */
+      __left = (__j - __lo) / __size;
+      if (__left < __n - __left - 1)
+	{
+	  __uclibc_qsort_intro (__ctx, __lo, __left, __depth);
+	  __n -= __left + 1;
+	  __lo = __j + __size;
+	}
+      else
+	{
+	  __uclibc_qsort_intro (__ctx, __j + __size, __n - __left - 1,
+				__depth);
+	  __n = __left;
+	}
+    }
+  if (__n > 1)
+    __uclibc_qsort_insertion (__ctx, __lo, __lo + (__n - 1) * __size);
+}
+
+static __inline void
+__uclibc_qsort_run (void *__base, size_t __nmemb, size_t __size,
+		    __compar_fn_t __cmp, __compar_d_fn_t __cmp_r, void *__arg)
+{
+  struct __uclibc_qsort_ctx __ctx;
+  unsigned int __depth;
+  size_t __n;
+
+  if (__nmemb < 2 || __size == 0)
+    return;
+  __ctx.__size = __size;
+  __ctx.__cmp = __cmp;
+  __ctx.__cmp_r = __cmp_r;
+  __ctx.__arg = __arg;
+  if ((((unsigned long int) __base | __size)
+       & (sizeof (__uclibc_qsort_word_t) - 1)) != 0)
+    __ctx.__swap = __UCLIBC_QSORT_BYTES;
+  else if (__size == 4)
+    __ctx.__swap = __UCLIBC_QSORT_4;
+  else if (__size == 8)
+    __ctx.__swap = __UCLIBC_QSORT_8;
+  else if (__size == 16)
+    __ctx.__swap = __UCLIBC_QSORT_16;
+  else
+    __ctx.__swap = __UCLIBC_QSORT_WORDS;
+
+  for (__depth = 0, __n = __nmemb; __n > 1; __n >>= 1)
+    __depth += 2;
+  __uclibc_qsort_intro (&__ctx, (char *) __base, __nmemb, __depth);
+}
+
+/* qsort, as mapped by <stdlib.h>. */
+static __inline void
+__uclibc_qsort (void *__base, size_t __nmemb, size_t __size,
+		__compar_fn_t __compar)
+{
+  __uclibc_qsort_run (__base, __nmemb, __size, __compar, NULL, NULL);
+}
+
+#ifdef __USE_GNU
+/* Sort NMEMB elements of BASE, of SIZE bytes each, using COMPAR to
+   perform the comparisons.  ARG is passed to COMPAR as its third
+   argument.  */
+static __inline void
+qsort_r (void *__base, size_t __nmemb, size_t __size,
+	 __compar_d_fn_t __compar, void *__arg)
+{
+  __uclibc_qsort_run (__base, __nmemb, __size, NULL, __compar, __arg);
+}
+#endif
+
+#endif /* _BITS_UCLIBC_QSORT_H */
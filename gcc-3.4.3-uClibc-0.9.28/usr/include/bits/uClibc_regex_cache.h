@@ -0,0 +1,1460 @@
+/* Compiled-pattern cache, literal prefilter and DFA matcher for regex.
+ *
+ * GNU Library General Public License (LGPL) version 2 or later.
+ *
+ * regcomp is expensive and the libc regexec backtracks.  Define
+ * _REGEX_CACHE_DEFINE in exactly one source file of the program before
+ * including <regex.h>; that file then defines the functions declared
+ * there.
+ *
+ *  - regcomp_cached compiles a pattern with regcomp and keeps it: a
+ *    later call with the same pattern and flags returns the same
+ *    compiled pattern.  Each successful call is balanced by one
+ *    regfree_cached.  Released patterns stay cached, and the least
+ *    recently used are freed once more than __REGEX_CACHE_MAX are
+ *    kept; patterns in use are never freed.  Failed compiles are not
+ *    cached; regerror (err, NULL, ...) describes their error.
+ *  - regexec_cached returns what regexec would return for the
+ *    pattern, and may be called from several threads at once on one
+ *    pattern.  When every match must contain some literal string,
+ *    a string without it is rejected with strchr or strstr.  Patterns
+ *    without back-references are also compiled into a DFA, which
+ *    decides whether a string matches in one pass over it, one table
+ *    lookup per byte.  regexec then only runs to report the
+ *    subexpressions of a match, when PMATCH was asked for and the
+ *    pattern was not compiled with REG_NOSUB.
+ *  - regex_cache_stats reports how the cache and each stage did, and
+ *    regex_cache_flush frees every pattern not in use.
+ *
+ * The DFA is built when the pattern is compiled, up to
+ * __REGEX_DFA_STATES states, so matching never writes to it.  It
+ * reads patterns and strings as bytes, with ranges in byte order, as
+ * the C locale has them.  Patterns it does not handle are left to
+ * regexec alone: back-references, [= =] and [. .], GNU operators
+ * such as \w, \< and \|, [:upper:] and [:lower:] with REG_ICASE, and
+ * ^ or $ inside a pattern rather than at its ends.
+ */
+
+#ifndef _REGEX_H
+#error Always include <regex.h> rather than <bits/uClibc_regex_cache.h>
+#endif
+
+#ifndef _BITS_UCLIBC_REGEX_CACHE_H
+#define _BITS_UCLIBC_REGEX_CACHE_H	1
+
+#include <ctype.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <bits/uClibc_fnv.h>
+
+#define __REGEX_CACHE_BUCKETS	64	/* Hash chains */
+#define __REGEX_CACHE_MAX	64	/* Patterns kept */
+#define __REGEX_DFA_STATES	256	/* DFA states per pattern */
+#define __REGEX_NFA_NODES	4096	/* NFA nodes while building it */
+#define __REGEX_DEPTH		32	/* Nested groups */
+#define __REGEX_LIT		32	/* Longest literal looked for */
+
+/**********************************************************************/
+/* Lock. */
+
+/* Taken with __pthread_futex_lock. */
+typedef volatile int __regex_cache_lock_t;
+
+/**********************************************************************/
+/* State. */
+
+/* A DFA over byte classes: bytes no pattern position tells apart
+   share a class and a column.  State 0 is the match state. */
+struct __regex_dfa
+{
+  unsigned char __class[256];
+  unsigned int __nclasses;
+  unsigned int __nstates;
+  unsigned short __start[2];	/* Without and with REG_NOTBOL */
+  unsigned short *__next;	/* [state * __nclasses + class] */
+  unsigned char *__flags;	/* __REGEX_DFA_* per state */
+};
+
+#define __REGEX_DFA_STOP	1	/* Matched, or cannot match */
+#define __REGEX_DFA_EOL		2	/* Matches if the string ends here */
+
+struct __regex_cached
+{
+  regex_t __re;
+  struct __regex_cached *__next;	/* Hash chain */
+  struct __regex_cached *__newer;	/* Use order */
+  struct __regex_cached *__older;
+  unsigned int __hash;
+  int __cflags;
+  int __refs;
+  struct __regex_dfa *__dfa;		/* Or NULL */
+  char __lit[__REGEX_LIT + 1];		/* Or empty */
+  char __pattern[1];
+};
+
+static __regex_cache_lock_t __regex_cache_lock_v;
+static struct __regex_cached *__regex_cache_table[__REGEX_CACHE_BUCKETS];
+static struct __regex_cached *__regex_cache_newest;
+static struct __regex_cached *__regex_cache_oldest;
+static unsigned int __regex_cache_count;
+static struct regex_cache_stats __regex_cache_st;
+
+/* Counters bumped while matching, outside the lock. */
+static volatile int __regex_cache_prefilter;
+static volatile int __regex_cache_dfa;
+static volatile int __regex_cache_regexec;
+
+/**********************************************************************/
+/* Parsing.  The pattern is parsed again, the way regcomp parses it,
+   into a tree for the literal and DFA passes.  Anything the DFA does
+   not handle clears __ok. */
+
+enum
+{
+  __REGEX_SET,		/* One byte out of __set */
+  __REGEX_CAT,		/* Children in sequence */
+  __REGEX_ALT,		/* One of the children */
+  __REGEX_REP,		/* The child __min to __max times */
+  __REGEX_BOL,		/* ^ */
+  __REGEX_EOL,		/* $ */
+  __REGEX_EMPTY
+};
+
+struct __regex_ast
+{
+  int __type;
+  int __c;			/* The byte of a one-byte set, or -1 */
+  int __set;
+  int __min;
+  int __max;			/* -1 for no limit */
+  int __first;			/* Children */
+  int __last;
+  int __next;			/* Siblings */
+  int __prev;
+};
+
+struct __regex_parse
+{
+  const unsigned char *__p;
+  int __cflags;
+  int __ok;
+  int __depth;
+  int __bol;			/* Nothing can come before a ^ here */
+  int __eol;			/* A $ was parsed; nothing may follow it */
+  int __anchors;		/* ^ and $ parsed so far */
+  struct __regex_ast *__ast;
+  int __nast;
+  int __aast;
+  unsigned int (*__sets)[8];
+  int __nsets;
+  int __asets;
+};
+
+#define __REGEX_BIT(__s, __b)	((__s)[(__b) >> 5] & (1U << ((__b) & 31)))
+#define __REGEX_SETBIT(__s, __b) ((__s)[(__b) >> 5] |= 1U << ((__b) & 31))
+
+static int
+__regex_node (struct __regex_parse *__P, int __type)
+{
+  struct __regex_ast *__n;
+
+  if (!__P->__ok)
+    return -1;
+  if (__P->__nast == __P->__aast)
+    {
+      int __a = __P->__aast ? 2 * __P->__aast : 32;
+
+      __n = (struct __regex_ast *) realloc (__P->__ast, __a * sizeof (*__n));
+      if (__n == NULL)
+	{
+	  __P->__ok = 0;
+	  return -1;
+	}
+      __P->__ast = __n;
+      __P->__aast = __a;
+    }
+  __n = &__P->__ast[__P->__nast];
+  __n->__type = __type;
+  __n->__c = -1;
+  __n->__set = -1;
+  __n->__min = __n->__max = 0;
+  __n->__first = __n->__last = __n->__next = __n->__prev = -1;
+  return __P->__nast++;
+}
+
+static void
+__regex_add (struct __regex_parse *__P, int __parent, int __child)
+{
+  struct __regex_ast *__p = &__P->__ast[__parent];
+
+  __P->__ast[__child].__prev = __p->__last;
+  if (__p->__last < 0)
+    __p->__first = __child;
+  else
+    __P->__ast[__p->__last].__next = __child;
+  __p->__last = __child;
+}
+
+static unsigned int *
+__regex_newset (struct __regex_parse *__P, int *__index)
+{
+  if (__P->__nsets == __P->__asets)
+    {
+      int __a = __P->__asets ? 2 * __P->__asets : 16;
+      unsigned int (*__s)[8];
+
+      __s = (unsigned int (*)[8]) realloc (__P->__sets, __a * sizeof (*__s));
+      if (__s == NULL)
+	{
+	  __P->__ok = 0;
+	  return NULL;
+	}
+      __P->__sets = __s;
+      __P->__asets = __a;
+    }
+  *__index = __P->__nsets;
+  memset (__P->__sets[__P->__nsets], 0, sizeof (__P->__sets[0]));
+  return __P->__sets[__P->__nsets++];
+}
+
+/* A set node for the bytes whose translation is in S, after S is
+   complemented if NEG: with REG_ICASE regcomp translates the pattern
+   and regexec the string with tolower. */
+static int
+__regex_setnode (struct __regex_parse *__P, const unsigned int *__s,
+		 int __neg, int __c)
+{
+  unsigned int *__t;
+  int __n;
+  int __b;
+
+  __n = __regex_node (__P, __REGEX_SET);
+  if (__n < 0 || (__t = __regex_newset (__P, &__P->__ast[__n].__set)) == NULL)
+    return -1;
+  for (__b = 1; __b < 256; ++__b)
+    {
+      int __x = (__P->__cflags & REG_ICASE) ? tolower (__b) : __b;
+
+      if ((__REGEX_BIT (__s, __x) != 0) != __neg)
+	__REGEX_SETBIT (__t, __b);
+    }
+  if (__neg && (__P->__cflags & REG_NEWLINE))
+    __t[0] &= ~(1U << '\n');
+  __P->__ast[__n].__c = (__P->__cflags & REG_ICASE) ? -1 : __c;
+  return __n;
+}
+
+/* ^ and $ only where nothing can come before or after them: regex
+   implementations disagree about the rest. */
+static int
+__regex_anchor (struct __regex_parse *__P, int __type)
+{
+  if (__type == __REGEX_BOL && !__P->__bol)
+    {
+      __P->__ok = 0;
+      return -1;
+    }
+  if (__type == __REGEX_EOL)
+    __P->__eol = 1;
+  ++__P->__anchors;
+  return __regex_node (__P, __type);
+}
+
+static int
+__regex_literal (struct __regex_parse *__P, int __c)
+{
+  unsigned int __s[8];
+
+  memset (__s, 0, sizeof (__s));
+  if (__P->__cflags & REG_ICASE)
+    __c = tolower (__c);
+  __REGEX_SETBIT (__s, __c);
+  return __regex_setnode (__P, __s, 0, __c);
+}
+
+static int
+__regex_dot (struct __regex_parse *__P)
+{
+  unsigned int __s[8];
+
+  memset (__s, 0, sizeof (__s));
+  return __regex_setnode (__P, __s, 1, -1);
+}
+
+static int
+__regex_bracket (struct __regex_parse *__P)
+{
+  static const char __names[][7] =
+    {
+      "alpha", "upper", "lower", "digit", "xdigit", "space",
+      "print", "punct", "graph", "cntrl", "blank", "alnum"
+    };
+  unsigned int __s[8];
+  int __neg = 0;
+  int __first = 1;
+  int __c;
+  int __d;
+  int __i;
+  int __b;
+
+  memset (__s, 0, sizeof (__s));
+  if (*__P->__p == '^')
+    {
+      __neg = 1;
+      ++__P->__p;
+    }
+  for (;; __first = 0)
+    {
+      __c = *__P->__p++;
+      if (__c == '\0')
+	goto __unsupported;
+      if (__c == ']' && !__first)
+	break;
+      if (__c == '[' && (*__P->__p == '=' || *__P->__p == '.'))
+	goto __unsupported;
+      if (__c == '[' && *__P->__p == ':')
+	{
+	  const unsigned char *__e = __P->__p + 1;
+	  size_t __len;
+
+	  while (*__e != '\0' && !(*__e == ':' && __e[1] == ']'))
+	    ++__e;
+	  if (*__e == '\0')
+	    goto __unsupported;
+	  __len = __e - (__P->__p + 1);
+	  for (__i = 0; __i < 12; ++__i)
+	    if (strlen (__names[__i]) == __len
+		&& memcmp (__names[__i], __P->__p + 1, __len) == 0)
+	      break;
+	  if (__i == 12 || ((__P->__cflags & REG_ICASE) && (__i == 1 || __i == 2)))
+	    goto __unsupported;
+	  for (__b = 1; __b < 256; ++__b)
+	    {
+	      int __in;
+
+	      switch (__i)
+		{
+		case 0: __in = isalpha (__b); break;
+		case 1: __in = isupper (__b); break;
+		case 2: __in = islower (__b); break;
+		case 3: __in = isdigit (__b); break;
+		case 4: __in = isxdigit (__b); break;
+		case 5: __in = isspace (__b); break;
+		case 6: __in = isprint (__b); break;
+		case 7: __in = ispunct (__b); break;
+		case 8: __in = isgraph (__b); break;
+		case 9: __in = iscntrl (__b); break;
+		case 10: __in = __b == ' ' || __b == '\t'; break;
+		default: __in = isalnum (__b); break;
+		}
+	      if (__in)
+		__REGEX_SETBIT (__s, (__P->__cflags & REG_ICASE)
+				     ? tolower (__b) : __b);
+	    }
+	  __P->__p = __e + 2;
+	  continue;
+	}
+      __d = __c;
+      if (__P->__p[0] == '-' && __P->__p[1] != ']' && __P->__p[1] != '\0')
+	{
+	  if (__P->__p[1] == '[')
+	    goto __unsupported;
+	  __d = __P->__p[1];
+	  __P->__p += 2;
+	  if (__d < __c)
+	    goto __unsupported;
+	}
+      /* Each byte of a range is translated, not its ends. */
+      for (__b = __c; __b <= __d; ++__b)
+	__REGEX_SETBIT (__s, (__P->__cflags & REG_ICASE) ? tolower (__b) : __b);
+    }
+  return __regex_setnode (__P, __s, __neg, -1);
+
+ __unsupported:
+  __P->__ok = 0;
+  return -1;
+}
+
+static int __regex_parse_alt (struct __regex_parse *__P);
+
+/* An interval after its opening brace. */
+static int
+__regex_interval (struct __regex_parse *__P, int *__min, int *__max)
+{
+  int __ext = __P->__cflags & REG_EXTENDED;
+
+  if (!isdigit (*__P->__p))
+    return 0;
+  for (*__min = 0; isdigit (*__P->__p); ++__P->__p)
+    if ((*__min = *__min * 10 + (*__P->__p - '0')) > RE_DUP_MAX)
+      return 0;
+  *__max = *__min;
+  if (*__P->__p == ',')
+    {
+      ++__P->__p;
+      *__max = -1;
+      if (isdigit (*__P->__p))
+	for (*__max = 0; isdigit (*__P->__p); ++__P->__p)
+	  if ((*__max = *__max * 10 + (*__P->__p - '0')) > RE_DUP_MAX)
+	    return 0;
+    }
+  if (__ext ? *__P->__p != '}' : (__P->__p[0] != '\\' || __P->__p[1] != '}'))
+    return 0;
+  __P->__p += __ext ? 1 : 2;
+  return *__max < 0 || *__max >= *__min;
+}
+
+/* A piece: an atom and its repetitions.  START is nonzero at the
+   beginning of a branch, where a BRE takes * literally. */
+static int
+__regex_parse_piece (struct __regex_parse *__P, int __start)
+{
+  int __ext = __P->__cflags & REG_EXTENDED;
+  int __anchors = __P->__anchors;
+  int __c = *__P->__p;
+  int __n;
+  int __r;
+  int __min;
+  int __max;
+
+  if (__ext)
+    {
+      ++__P->__p;
+      switch (__c)
+	{
+	case '(':
+	  if (++__P->__depth > __REGEX_DEPTH)
+	    goto __unsupported;
+	  __n = __regex_parse_alt (__P);
+	  if (*__P->__p != ')')
+	    goto __unsupported;
+	  ++__P->__p;
+	  --__P->__depth;
+	  break;
+	case ')': case '*': case '+': case '?': case '{':
+	  goto __unsupported;
+	case '^':
+	  __n = __regex_anchor (__P, __REGEX_BOL);
+	  break;
+	case '$':
+	  __n = __regex_anchor (__P, __REGEX_EOL);
+	  break;
+	case '.':
+	  __n = __regex_dot (__P);
+	  break;
+	case '[':
+	  __n = __regex_bracket (__P);
+	  break;
+	case '\\':
+	  __c = *__P->__p++;
+	  if (__c == '\0' || strchr ("^.[$()|*+?{\\}", __c) == NULL)
+	    goto __unsupported;
+	  __n = __regex_literal (__P, __c);
+	  break;
+	default:
+	  __n = __regex_literal (__P, __c);
+	  break;
+	}
+    }
+  else
+    {
+      ++__P->__p;
+      if (__c == '\\')
+	{
+	  __c = *__P->__p++;
+	  if (__c == '(')
+	    {
+	      if (++__P->__depth > __REGEX_DEPTH)
+		goto __unsupported;
+	      __n = __regex_parse_alt (__P);
+	      if (__P->__p[0] != '\\' || __P->__p[1] != ')')
+		goto __unsupported;
+	      __P->__p += 2;
+	      --__P->__depth;
+	    }
+	  else if (__c != '\0' && strchr (".[]*^$\\/", __c) != NULL)
+	    __n = __regex_literal (__P, __c);
+	  else
+	    goto __unsupported;
+	}
+      else if (__c == '*' && __start)
+	__n = __regex_literal (__P, '*');
+      else if (__c == '^' && __start)
+	{
+	  /* A * right after a leading ^ is literal too. */
+	  __n = __regex_anchor (__P, __REGEX_BOL);
+	  if (*__P->__p == '*')
+	    return __n;
+	}
+      else if (__c == '$' && (*__P->__p == '\0'
+			      || (__P->__p[0] == '\\' && __P->__p[1] == ')')))
+	__n = __regex_anchor (__P, __REGEX_EOL);
+      else if (__c == '.')
+	__n = __regex_dot (__P);
+      else if (__c == '[')
+	__n = __regex_bracket (__P);
+      else
+	__n = __regex_literal (__P, __c);
+    }
+
+  for (;;)
+    {
+      __c = *__P->__p;
+      if (__c == '*')
+	{
+	  ++__P->__p;
+	  __min = 0;
+	  __max = -1;
+	}
+      else if (__ext && (__c == '+' || __c == '?'))
+	{
+	  ++__P->__p;
+	  __min = __c == '+';
+	  __max = __c == '+' ? -1 : 1;
+	}
+      else if (__ext && __c == '{')
+	{
+	  ++__P->__p;
+	  if (!__regex_interval (__P, &__min, &__max))
+	    goto __unsupported;
+	}
+      else if (!__ext && __c == '\\' && __P->__p[1] == '{')
+	{
+	  __P->__p += 2;
+	  if (!__regex_interval (__P, &__min, &__max))
+	    goto __unsupported;
+	}
+      else
+	return __n;
+      if (__n < 0 || __P->__anchors != __anchors)
+	goto __unsupported;
+      __r = __regex_node (__P, __REGEX_REP);
+      if (__r < 0)
+	return -1;
+      __P->__ast[__r].__min = __min;
+      __P->__ast[__r].__max = __max;
+      __regex_add (__P, __r, __n);
+      __n = __r;
+    }
+
+ __unsupported:
+  __P->__ok = 0;
+  return -1;
+}
+
+static int
+__regex_parse_branch (struct __regex_parse *__P)
+{
+  int __ext = __P->__cflags & REG_EXTENDED;
+  int __cat = __regex_node (__P, __REGEX_CAT);
+  int __start = 1;
+  int __n;
+
+  while (__P->__ok && *__P->__p != '\0')
+    {
+      if (__ext ? *__P->__p == '|' || (*__P->__p == ')' && __P->__depth > 0)
+	  : __P->__p[0] == '\\' && (__P->__p[1] == ')' || __P->__p[1] == '|'))
+	break;
+      if (__P->__eol)
+	{
+	  __P->__ok = 0;
+	  break;
+	}
+      __n = __regex_parse_piece (__P, __start);
+      if (__n < 0)
+	break;
+      __regex_add (__P, __cat, __n);
+      __P->__bol = 0;
+      __start = !__ext && __P->__ast[__n].__type == __REGEX_BOL
+		&& __P->__ast[__cat].__first == __n;
+    }
+  return __P->__ok ? __cat : -1;
+}
+
+static int
+__regex_parse_alt (struct __regex_parse *__P)
+{
+  int __bol = __P->__bol;
+  int __eol = 0;
+  int __alt = -1;
+  int __n;
+
+  for (;;)
+    {
+      __P->__bol = __bol;
+      __P->__eol = 0;
+      __n = __regex_parse_branch (__P);
+      if (__n < 0)
+	return -1;
+      __eol |= __P->__eol;
+      __P->__eol = __eol;
+      if ((__P->__cflags & REG_EXTENDED) && *__P->__p == '|')
+	{
+	  if (__alt < 0 && (__alt = __regex_node (__P, __REGEX_ALT)) < 0)
+	    return -1;
+	  __regex_add (__P, __alt, __n);
+	  ++__P->__p;
+	  continue;
+	}
+      if (!(__P->__cflags & REG_EXTENDED) && __P->__p[0] == '\\'
+	  && __P->__p[1] == '|')
+	{
+	  __P->__ok = 0;
+	  return -1;
+	}
+      if (__alt < 0)
+	return __n;
+      __regex_add (__P, __alt, __n);
+      return __alt;
+    }
+}
+
+/**********************************************************************/
+/* Required literal.  For each subtree: whether it matches only one
+   string, a prefix and a suffix of every string it matches, and a
+   string every match contains. */
+
+struct __regex_lit
+{
+  int __exact;
+  int __nl, __nr, __nm;
+  unsigned char __l[__REGEX_LIT];
+  unsigned char __r[__REGEX_LIT];
+  unsigned char __m[__REGEX_LIT];
+};
+
+static void
+__regex_lit_exact (struct __regex_lit *__x, const unsigned char *__s, int __n)
+{
+  __x->__exact = 1;
+  __x->__nl = __x->__nr = __x->__nm = __n;
+  memcpy (__x->__l, __s, __n);
+  memcpy (__x->__r, __s, __n);
+  memcpy (__x->__m, __s, __n);
+}
+
+/* A followed by B, into A. */
+static void
+__regex_lit_cat (struct __regex_lit *__a, const struct __regex_lit *__b)
+{
+  unsigned char __j[2 * __REGEX_LIT];
+  int __n;
+
+  if (__a->__exact && __b->__exact && __a->__nl + __b->__nl <= __REGEX_LIT)
+    {
+      memcpy (__j, __a->__l, __a->__nl);
+      memcpy (__j + __a->__nl, __b->__l, __b->__nl);
+      __regex_lit_exact (__a, __j, __a->__nl + __b->__nl);
+      return;
+    }
+
+  /* The suffix of A and the prefix of B join across the boundary. */
+  memcpy (__j, __a->__r, __a->__nr);
+  memcpy (__j + __a->__nr, __b->__l, __b->__nl);
+  __n = __a->__nr + __b->__nl;
+  if (__n > __REGEX_LIT)
+    __n = __REGEX_LIT;
+  if (__b->__nm > __a->__nm && __b->__nm >= __n)
+    {
+      memcpy (__a->__m, __b->__m, __b->__nm);
+      __a->__nm = __b->__nm;
+    }
+  else if (__n > __a->__nm)
+    {
+      memcpy (__a->__m, __j, __n);
+      __a->__nm = __n;
+    }
+
+  if (__a->__exact)
+    {
+      memcpy (__j, __a->__l, __a->__nl);
+      memcpy (__j + __a->__nl, __b->__l, __b->__nl);
+      __n = __a->__nl + __b->__nl;
+      __a->__nl = __n > __REGEX_LIT ? __REGEX_LIT : __n;
+      memcpy (__a->__l, __j, __a->__nl);
+    }
+  if (__b->__exact)
+    {
+      memcpy (__j, __a->__r, __a->__nr);
+      memcpy (__j + __a->__nr, __b->__r, __b->__nr);
+      __n = __a->__nr + __b->__nr;
+      __a->__nr = __n > __REGEX_LIT ? __REGEX_LIT : __n;
+      memcpy (__a->__r, __j + __n - __a->__nr, __a->__nr);
+    }
+  else
+    {
+      memcpy (__a->__r, __b->__r, __b->__nr);
+      __a->__nr = __b->__nr;
+    }
+  __a->__exact = 0;
+}
+
+/* A or B, into A. */
+static void
+__regex_lit_alt (struct __regex_lit *__a, const struct __regex_lit *__b)
+{
+  int __n;
+
+  if (__a->__exact && __b->__exact && __a->__nl == __b->__nl
+      && memcmp (__a->__l, __b->__l, __a->__nl) == 0)
+    return;
+  for (__n = 0; __n < __a->__nl && __n < __b->__nl
+		&& __a->__l[__n] == __b->__l[__n]; ++__n)
+    ;
+  __a->__nl = __n;
+  for (__n = 0; __n < __a->__nr && __n < __b->__nr
+		&& __a->__r[__a->__nr - 1 - __n] == __b->__r[__b->__nr - 1 - __n];
+       ++__n)
+    ;
+  memmove (__a->__r, __a->__r + __a->__nr - __n, __n);
+  __a->__nr = __n;
+  if (__a->__nl >= __a->__nr)
+    {
+      memcpy (__a->__m, __a->__l, __a->__nl);
+      __a->__nm = __a->__nl;
+    }
+  else
+    {
+      memcpy (__a->__m, __a->__r, __a->__nr);
+      __a->__nm = __a->__nr;
+    }
+  __a->__exact = 0;
+}
+
+static void
+__regex_lit (const struct __regex_parse *__P, int __n, struct __regex_lit *__x)
+{
+  const struct __regex_ast *__t = &__P->__ast[__n];
+  struct __regex_lit __y;
+  unsigned char __c;
+  int __i;
+
+  switch (__t->__type)
+    {
+    case __REGEX_SET:
+      if (__t->__c >= 0)
+	{
+	  __c = __t->__c;
+	  __regex_lit_exact (__x, &__c, 1);
+	  return;
+	}
+      break;
+    case __REGEX_CAT:
+      __regex_lit_exact (__x, (const unsigned char *) "", 0);
+      for (__i = __t->__first; __i >= 0; __i = __P->__ast[__i].__next)
+	{
+	  __regex_lit (__P, __i, &__y);
+	  __regex_lit_cat (__x, &__y);
+	}
+      return;
+    case __REGEX_ALT:
+      __regex_lit (__P, __t->__first, __x);
+      for (__i = __P->__ast[__t->__first].__next; __i >= 0;
+	   __i = __P->__ast[__i].__next)
+	{
+	  __regex_lit (__P, __i, &__y);
+	  __regex_lit_alt (__x, &__y);
+	}
+      return;
+    case __REGEX_REP:
+      if (__t->__min > 0)
+	{
+	  __regex_lit (__P, __t->__first, __x);
+	  if (__t->__min != 1 || __t->__max != 1)
+	    __x->__exact = 0;
+	  return;
+	}
+      break;
+    default:
+      __regex_lit_exact (__x, (const unsigned char *) "", 0);
+      return;
+    }
+  memset (__x, 0, sizeof (*__x));
+}
+
+/**********************************************************************/
+/* NFA, built from the tree as Thompson's construction. */
+
+enum
+{
+  __REGEX_NFA_SET,		/* Consumes a byte out of __set */
+  __REGEX_NFA_SPLIT,		/* Goes on to both __out and __out1 */
+  __REGEX_NFA_BOL,
+  __REGEX_NFA_EOL,
+  __REGEX_NFA_MATCH
+};
+
+struct __regex_nfa
+{
+  int __op;
+  int __set;
+  int __out;
+  int __out1;
+};
+
+struct __regex_build
+{
+  const struct __regex_parse *__P;
+  struct __regex_nfa *__nfa;
+  int __n;
+  int __ok;
+};
+
+static int
+__regex_nfa_node (struct __regex_build *__B, int __op, int __out, int __out1)
+{
+  if (__B->__n == __REGEX_NFA_NODES)
+    {
+      __B->__ok = 0;
+      return 0;
+    }
+  __B->__nfa[__B->__n].__op = __op;
+  __B->__nfa[__B->__n].__set = -1;
+  __B->__nfa[__B->__n].__out = __out;
+  __B->__nfa[__B->__n].__out1 = __out1;
+  return __B->__n++;
+}
+
+/* Emits tree node N so that it continues at NEXT; returns its start. */
+static int
+__regex_emit (struct __regex_build *__B, int __n, int __next)
+{
+  const struct __regex_ast *__t = &__B->__P->__ast[__n];
+  int __s;
+  int __i;
+  int __k;
+
+  if (!__B->__ok)
+    return 0;
+  switch (__t->__type)
+    {
+    case __REGEX_SET:
+      __s = __regex_nfa_node (__B, __REGEX_NFA_SET, __next, -1);
+      __B->__nfa[__s].__set = __t->__set;
+      return __s;
+    case __REGEX_CAT:
+      for (__i = __t->__last; __i >= 0; __i = __B->__P->__ast[__i].__prev)
+	__next = __regex_emit (__B, __i, __next);
+      return __next;
+    case __REGEX_ALT:
+      __s = __regex_emit (__B, __t->__last, __next);
+      for (__i = __B->__P->__ast[__t->__last].__prev; __i >= 0;
+	   __i = __B->__P->__ast[__i].__prev)
+	__s = __regex_nfa_node (__B, __REGEX_NFA_SPLIT,
+				__regex_emit (__B, __i, __next), __s);
+      return __s;
+    case __REGEX_REP:
+      if (__t->__max < 0)
+	{
+	  /* A loop back through a split, after __min copies. */
+	  __s = __regex_nfa_node (__B, __REGEX_NFA_SPLIT, -1, __next);
+	  if (!__B->__ok)
+	    return 0;
+	  __B->__nfa[__s].__out = __regex_emit (__B, __t->__first, __s);
+	}
+      else
+	{
+	  /* __max - __min nested optional copies, after __min copies. */
+	  __s = __next;
+	  for (__k = __t->__max - __t->__min; __k > 0 && __B->__ok; --__k)
+	    __s = __regex_nfa_node (__B, __REGEX_NFA_SPLIT,
+				    __regex_emit (__B, __t->__first, __s),
+				    __next);
+	}
+      for (__k = __t->__min; __k > 0 && __B->__ok; --__k)
+	__s = __regex_emit (__B, __t->__first, __s);
+      return __s;
+    case __REGEX_BOL:
+      return __regex_nfa_node (__B, __REGEX_NFA_BOL, __next, -1);
+    case __REGEX_EOL:
+      return __regex_nfa_node (__B, __REGEX_NFA_EOL, __next, -1);
+    default:
+      return __next;
+    }
+}
+
+/**********************************************************************/
+/* DFA, by the subset construction.  A DFA state is a set of NFA
+   nodes: the byte-consuming ones, the match node, and the $ nodes
+   still waiting for the next byte to tell whether they hold.  ^ is
+   decided as nodes are added, from whether the previous byte ended a
+   line, which is part of the state too.  The start nodes are added
+   after every byte, so a match may begin anywhere. */
+
+struct __regex_subset
+{
+  struct __regex_build *__B;
+  int __start;
+  int __newline;		/* REG_NEWLINE */
+  int *__mark;
+  int __gen;
+  int *__stack;
+  int *__list;			/* Closure being built */
+  int __nlist;
+  int **__states;		/* Node lists, each led by its length */
+  int *__bol;
+  int *__hash;			/* Open addressing, 2 * __REGEX_DFA_STATES */
+  int __nstates;
+};
+
+/* Adds the nodes reachable from N without consuming a byte.  $ holds
+   if EOL, ^ if BOL. */
+static void
+__regex_closure (struct __regex_subset *__S, int __n, int __bol, int __eol)
+{
+  const struct __regex_nfa *__nfa = __S->__B->__nfa;
+  int __sp = 0;
+
+  __S->__stack[__sp++] = __n;
+  while (__sp > 0)
+    {
+      __n = __S->__stack[--__sp];
+      if (__n < 0 || __S->__mark[__n] == __S->__gen)
+	continue;
+      __S->__mark[__n] = __S->__gen;
+      switch (__nfa[__n].__op)
+	{
+	case __REGEX_NFA_SPLIT:
+	  __S->__stack[__sp++] = __nfa[__n].__out1;
+	  __S->__stack[__sp++] = __nfa[__n].__out;
+	  break;
+	case __REGEX_NFA_BOL:
+	  if (__bol)
+	    __S->__stack[__sp++] = __nfa[__n].__out;
+	  break;
+	case __REGEX_NFA_EOL:
+	  if (__eol)
+	    __S->__stack[__sp++] = __nfa[__n].__out;
+	  else
+	    __S->__list[__S->__nlist++] = __n;
+	  break;
+	default:
+	  __S->__list[__S->__nlist++] = __n;
+	  break;
+	}
+    }
+}
+
+/* Nonzero if the closure reached the match node. */
+static int
+__regex_matched (struct __regex_subset *__S)
+{
+  int __i;
+
+  for (__i = 0; __i < __S->__nlist; ++__i)
+    if (__S->__B->__nfa[__S->__list[__i]].__op == __REGEX_NFA_MATCH)
+      return 1;
+  return 0;
+}
+
+/* The DFA state for the closure just built, added if new; 0 if it
+   matched, -1 if there are too many states. */
+static int
+__regex_intern (struct __regex_subset *__S, int __bol)
+{
+  unsigned int __h = 2166136261U ^ __bol;
+  int *__l;
+  int __i;
+  int __j;
+  int __t;
+
+  if (__regex_matched (__S))
+    return 0;
+  /* Sorted, so equal sets compare equal. */
+  for (__i = 1; __i < __S->__nlist; ++__i)
+    for (__j = __i, __t = __S->__list[__i];
+	 __j > 0 && __S->__list[__j - 1] > __t; --__j)
+      __S->__list[__j] = __S->__list[__j - 1], __S->__list[__j - 1] = __t;
+  for (__i = 0; __i < __S->__nlist; ++__i)
+    __h = (__h ^ __S->__list[__i]) * 16777619U;
+
+  for (__i = __h % (2 * __REGEX_DFA_STATES); __S->__hash[__i] >= 0;
+       __i = (__i + 1) % (2 * __REGEX_DFA_STATES))
+    {
+      __l = __S->__states[__S->__hash[__i]];
+      if (__S->__bol[__S->__hash[__i]] == __bol && __l[0] == __S->__nlist
+	  && memcmp (__l + 1, __S->__list, __S->__nlist * sizeof (int)) == 0)
+	return __S->__hash[__i];
+    }
+  if (__S->__nstates == __REGEX_DFA_STATES)
+    return -1;
+  __l = (int *) malloc ((__S->__nlist + 1) * sizeof (int));
+  if (__l == NULL)
+    return -1;
+  __l[0] = __S->__nlist;
+  memcpy (__l + 1, __S->__list, __S->__nlist * sizeof (int));
+  __S->__states[__S->__nstates] = __l;
+  __S->__bol[__S->__nstates] = __bol;
+  __S->__hash[__i] = __S->__nstates;
+  return __S->__nstates++;
+}
+
+/* The state after byte C in state ST. */
+static int
+__regex_step (struct __regex_subset *__S, int __st, int __c)
+{
+  const struct __regex_nfa *__nfa = __S->__B->__nfa;
+  const unsigned int (*__sets)[8] =
+    (const unsigned int (*)[8]) __S->__B->__P->__sets;
+  int *__l = __S->__states[__st];
+  int __nl = __S->__newline && __c == '\n';
+  int *__in;
+  int __nin;
+  int __i;
+
+  /* A newline satisfies the $ nodes waiting on it first. */
+  __in = __l + 1;
+  __nin = __l[0];
+  if (__nl)
+    {
+      ++__S->__gen;
+      __S->__nlist = 0;
+      for (__i = 0; __i < __l[0]; ++__i)
+	__regex_closure (__S, __l[1 + __i], __S->__bol[__st], 1);
+      if (__regex_matched (__S))
+	return 0;
+      __in = __S->__stack + __REGEX_NFA_NODES;
+      memcpy (__in, __S->__list, __S->__nlist * sizeof (int));
+      __nin = __S->__nlist;
+    }
+
+  ++__S->__gen;
+  __S->__nlist = 0;
+  for (__i = 0; __i < __nin; ++__i)
+    if (__nfa[__in[__i]].__op == __REGEX_NFA_SET
+	&& __REGEX_BIT (__sets[__nfa[__in[__i]].__set], __c))
+      __regex_closure (__S, __nfa[__in[__i]].__out, __nl, 0);
+  __regex_closure (__S, __S->__start, __nl, 0);
+  return __regex_intern (__S, __nl);
+}
+
+static void
+__regex_dfa_free (struct __regex_dfa *__d)
+{
+  if (__d != NULL)
+    {
+      free (__d->__next);
+      free (__d->__flags);
+      free (__d);
+    }
+}
+
+static struct __regex_dfa *
+__regex_dfa_build (struct __regex_build *__B, int __start)
+{
+  const struct __regex_parse *__P = __B->__P;
+  struct __regex_subset __S;
+  struct __regex_dfa *__d;
+  short __map[512];
+  unsigned char __rep[256];
+  unsigned char __class[256];
+  int __st;
+  int __i;
+  int __b;
+  int __t;
+  int __n;
+
+  __d = (struct __regex_dfa *) calloc (1, sizeof (*__d));
+  memset (&__S, 0, sizeof (__S));
+  __S.__B = __B;
+  __S.__start = __start;
+  __S.__newline = (__P->__cflags & REG_NEWLINE) != 0;
+  __S.__mark = (int *) calloc (__B->__n, sizeof (int));
+  __S.__stack = (int *) malloc (2 * __REGEX_NFA_NODES * sizeof (int));
+  __S.__list = (int *) malloc (__REGEX_NFA_NODES * sizeof (int));
+  __S.__states = (int **) calloc (__REGEX_DFA_STATES, sizeof (int *));
+  __S.__bol = (int *) malloc (__REGEX_DFA_STATES * sizeof (int));
+  __S.__hash = (int *) malloc (2 * __REGEX_DFA_STATES * sizeof (int));
+  if (__d == NULL || __S.__mark == NULL || __S.__stack == NULL
+      || __S.__list == NULL || __S.__states == NULL || __S.__bol == NULL
+      || __S.__hash == NULL)
+    goto __fail;
+  memset (__S.__hash, -1, 2 * __REGEX_DFA_STATES * sizeof (int));
+
+  /* Byte classes: split by every set, and by newline. */
+  memset (__d->__class, 0, sizeof (__d->__class));
+  __d->__nclasses = 1;
+  for (__i = -1; __i < __P->__nsets; ++__i)
+    {
+      memset (__map, -1, sizeof (__map));
+      __n = 0;
+      for (__b = 0; __b < 256; ++__b)
+	{
+	  int __in = __i < 0 ? __b == '\n'
+				 : __REGEX_BIT (__P->__sets[__i], __b) != 0;
+	  int __k = 2 * __d->__class[__b] + __in;
+
+	  if (__map[__k] < 0)
+	    __map[__k] = __n++;
+	  __class[__b] = __map[__k];
+	}
+      memcpy (__d->__class, __class, sizeof (__class));
+      __d->__nclasses = __n;
+    }
+  for (__b = 255; __b >= 0; --__b)
+    __rep[__d->__class[__b]] = __b;
+
+  /* State 0 matches; then the two starts, and whatever they reach. */
+  __S.__list[0] = 0;
+  __S.__states[0] = (int *) malloc (sizeof (int));
+  if (__S.__states[0] == NULL)
+    goto __fail;
+  __S.__states[0][0] = 0;
+  __S.__bol[0] = 0;
+  __S.__nstates = 1;
+  for (__i = 0; __i < 2; ++__i)
+    {
+      ++__S.__gen;
+      __S.__nlist = 0;
+      __regex_closure (&__S, __start, !__i, 0);
+      if ((__t = __regex_intern (&__S, !__i)) < 0)
+	goto __fail;
+      __d->__start[__i] = __t;
+    }
+  __d->__next = (unsigned short *) malloc (__REGEX_DFA_STATES
+					   * __d->__nclasses
+					   * sizeof (unsigned short));
+  if (__d->__next == NULL)
+    goto __fail;
+  for (__b = 0; __b < (int) __d->__nclasses; ++__b)
+    __d->__next[__b] = 0;
+  for (__st = 1; __st < __S.__nstates; ++__st)
+    for (__b = 0; __b < (int) __d->__nclasses; ++__b)
+      {
+	if ((__t = __regex_step (&__S, __st, __rep[__b])) < 0)
+	  goto __fail;
+	__d->__next[__st * __d->__nclasses + __b] = __t;
+      }
+  __d->__nstates = __S.__nstates;
+
+  /* Which states match at the end of the string, and which cannot
+     change any more. */
+  __d->__flags = (unsigned char *) calloc (__d->__nstates, 1);
+  if (__d->__flags == NULL)
+    goto __fail;
+  __d->__flags[0] = __REGEX_DFA_STOP;
+  for (__st = 1; __st < __S.__nstates; ++__st)
+    {
+      ++__S.__gen;
+      __S.__nlist = 0;
+      for (__i = 0; __i < __S.__states[__st][0]; ++__i)
+	__regex_closure (&__S, __S.__states[__st][1 + __i], __S.__bol[__st], 1);
+      if (__regex_matched (&__S))
+	__d->__flags[__st] |= __REGEX_DFA_EOL;
+      else
+	{
+	  for (__b = 0; __b < (int) __d->__nclasses; ++__b)
+	    if (__d->__next[__st * __d->__nclasses + __b] != __st)
+	      break;
+	  if (__b == (int) __d->__nclasses)
+	    __d->__flags[__st] |= __REGEX_DFA_STOP;
+	}
+    }
+  __d->__next = (unsigned short *) realloc (__d->__next, __d->__nstates
+					    * __d->__nclasses
+					    * sizeof (unsigned short));
+  goto __done;
+
+ __fail:
+  __regex_dfa_free (__d);
+  __d = NULL;
+ __done:
+  if (__S.__states != NULL)
+    for (__i = 0; __i < __S.__nstates; ++__i)
+      free (__S.__states[__i]);
+  free (__S.__states);
+  free (__S.__bol);
+  free (__S.__hash);
+  free (__S.__list);
+  free (__S.__stack);
+  free (__S.__mark);
+  return __d;
+}
+
+/* Fills in the literal and the DFA of a pattern regcomp accepted. */
+static void
+__regex_analyze (struct __regex_cached *__e)
+{
+  struct __regex_parse __P;
+  struct __regex_build __B;
+  struct __regex_lit __x;
+  int __root;
+  int __match;
+
+  memset (&__P, 0, sizeof (__P));
+  __P.__p = (const unsigned char *) __e->__pattern;
+  __P.__cflags = __e->__cflags;
+  __P.__ok = 1;
+  __P.__bol = 1;
+  __root = __regex_parse_alt (&__P);
+  if (__root >= 0 && *__P.__p != '\0')
+    __P.__ok = 0;
+
+  if (__P.__ok)
+    {
+      if (!(__P.__cflags & REG_ICASE))
+	{
+	  __regex_lit (&__P, __root, &__x);
+	  memcpy (__e->__lit, __x.__m, __x.__nm);
+	  __e->__lit[__x.__nm] = '\0';
+	}
+      __B.__P = &__P;
+      __B.__n = 0;
+      __B.__ok = 1;
+      __B.__nfa = (struct __regex_nfa *) malloc (__REGEX_NFA_NODES
+						 * sizeof (*__B.__nfa));
+      if (__B.__nfa != NULL)
+	{
+	  __match = __regex_nfa_node (&__B, __REGEX_NFA_MATCH, -1, -1);
+	  __root = __regex_emit (&__B, __root, __match);
+	  if (__B.__ok)
+	    __e->__dfa = __regex_dfa_build (&__B, __root);
+	  free (__B.__nfa);
+	}
+    }
+  free (__P.__ast);
+  free (__P.__sets);
+}
+
+/**********************************************************************/
+/* Cache. */
+
+static unsigned int
+__regex_cache_hash (const char *__pattern, int __cflags)
+{
+  return __uclibc_fnv1a (__UCLIBC_FNV_BASIS ^ __cflags, __pattern);
+}
+
+static void
+__regex_cache_use (struct __regex_cached *__e)
+{
+  if (__e->__newer != NULL)
+    __e->__newer->__older = __e->__older;
+  else if (__regex_cache_newest == __e)
+    __regex_cache_newest = __e->__older;
+  if (__e->__older != NULL)
+    __e->__older->__newer = __e->__newer;
+  else if (__regex_cache_oldest == __e)
+    __regex_cache_oldest = __e->__newer;
+
+  __e->__newer = NULL;
+  __e->__older = __regex_cache_newest;
+  if (__regex_cache_newest != NULL)
+    __regex_cache_newest->__newer = __e;
+  __regex_cache_newest = __e;
+  if (__regex_cache_oldest == NULL)
+    __regex_cache_oldest = __e;
+}
+
+static void
+__regex_cache_free (struct __regex_cached *__e)
+{
+  regfree (&__e->__re);
+  __regex_dfa_free (__e->__dfa);
+  free (__e);
+}
+
+/* Unlinks an unused pattern; the caller frees it outside the lock. */
+static void
+__regex_cache_unlink (struct __regex_cached *__e)
+{
+  struct __regex_cached **__pp;
+
+  for (__pp = &__regex_cache_table[__e->__hash % __REGEX_CACHE_BUCKETS];
+       *__pp != __e; __pp = &(*__pp)->__next)
+    ;
+  *__pp = __e->__next;
+  if (__e->__newer != NULL)
+    __e->__newer->__older = __e->__older;
+  else
+    __regex_cache_newest = __e->__older;
+  if (__e->__older != NULL)
+    __e->__older->__newer = __e->__newer;
+  else
+    __regex_cache_oldest = __e->__newer;
+  --__regex_cache_count;
+  if (__e->__dfa != NULL)
+    --__regex_cache_st.dfa_entries;
+}
+
+int
+regcomp_cached (const regex_cached_t **__preg, const char *__pattern,
+		int __cflags)
+{
+  unsigned int __hash = __regex_cache_hash (__pattern, __cflags);
+  struct __regex_cached *__e;
+  struct __regex_cached *__n;
+  struct __regex_cached *__evicted = NULL;
+  int __err;
+
+  __pthread_futex_lock (&__regex_cache_lock_v);
+  for (__e = __regex_cache_table[__hash % __REGEX_CACHE_BUCKETS];
+       __e != NULL; __e = __e->__next)
+    if (__e->__hash == __hash && __e->__cflags == __cflags
+	&& strcmp (__e->__pattern, __pattern) == 0)
+      {
+	++__e->__refs;
+	__regex_cache_use (__e);
+	++__regex_cache_st.hits;
+	__pthread_futex_unlock (&__regex_cache_lock_v);
+	*__preg = __e;
+	return 0;
+      }
+  ++__regex_cache_st.misses;
+  __pthread_futex_unlock (&__regex_cache_lock_v);
+
+  /* Compiled outside the lock. */
+  __n = (struct __regex_cached *) calloc (1, sizeof (*__n)
+					  + strlen (__pattern));
+  if (__n == NULL)
+    return REG_ESPACE;
+  strcpy (__n->__pattern, __pattern);
+  __n->__hash = __hash;
+  __n->__cflags = __cflags;
+  __n->__refs = 1;
+  if ((__err = regcomp (&__n->__re, __pattern, __cflags)) != 0)
+    {
+      free (__n);
+      return __err;
+    }
+  __regex_analyze (__n);
+
+  __pthread_futex_lock (&__regex_cache_lock_v);
+  for (__e = __regex_cache_table[__hash % __REGEX_CACHE_BUCKETS];
+       __e != NULL; __e = __e->__next)
+    if (__e->__hash == __hash && __e->__cflags == __cflags
+	&& strcmp (__e->__pattern, __pattern) == 0)
+      break;
+  if (__e != NULL)
+    {
+      /* Another thread compiled it meanwhile. */
+      ++__e->__refs;
+      __regex_cache_use (__e);
+      __evicted = __n;
+      __n->__next = NULL;
+    }
+  else
+    {
+      __e = __n;
+      __e->__next = __regex_cache_table[__hash % __REGEX_CACHE_BUCKETS];
+      __regex_cache_table[__hash % __REGEX_CACHE_BUCKETS] = __e;
+      __regex_cache_use (__e);
+      ++__regex_cache_count;
+      if (__e->__dfa != NULL)
+	++__regex_cache_st.dfa_entries;
+      for (__n = __regex_cache_oldest;
+	   __n != NULL && __regex_cache_count > __REGEX_CACHE_MAX; )
+	{
+	  struct __regex_cached *__newer = __n->__newer;
+
+	  if (__n->__refs == 0)
+	    {
+	      __regex_cache_unlink (__n);
+	      __n->__next = __evicted;
+	      __evicted = __n;
+	      ++__regex_cache_st.evictions;
+	    }
+	  __n = __newer;
+	}
+    }
+  __pthread_futex_unlock (&__regex_cache_lock_v);
+
+  while (__evicted != NULL)
+    {
+      __n = __evicted->__next;
+      __regex_cache_free (__evicted);
+      __evicted = __n;
+    }
+  *__preg = __e;
+  return 0;
+}
+
+int
+regexec_cached (const regex_cached_t *__preg, const char *__string,
+		size_t __nmatch, regmatch_t __pmatch[], int __eflags)
+{
+  const struct __regex_dfa *__d = __preg->__dfa;
+  const unsigned char *__s;
+  unsigned int __st;
+
+  if (__preg->__lit[0] != '\0'
+      && (__preg->__lit[1] == '\0' ? strchr (__string, __preg->__lit[0])
+	  : strstr (__string, __preg->__lit)) == NULL)
+    {
+      __pthread_atomic_add (&__regex_cache_prefilter, 1);
+      return REG_NOMATCH;
+    }
+
+  if (__d != NULL)
+    {
+      __s = (const unsigned char *) __string;
+      __st = __d->__start[(__eflags & REG_NOTBOL) != 0];
+      while (!(__d->__flags[__st] & __REGEX_DFA_STOP) && *__s != '\0')
+	__st = __d->__next[__st * __d->__nclasses + __d->__class[*__s++]];
+      if (__st != 0
+	  && ((__eflags & REG_NOTEOL) || !(__d->__flags[__st] & __REGEX_DFA_EOL)))
+	{
+	  __pthread_atomic_add (&__regex_cache_dfa, 1);
+	  return REG_NOMATCH;
+	}
+      if (__nmatch == 0 || (__preg->__cflags & REG_NOSUB))
+	{
+	  __pthread_atomic_add (&__regex_cache_dfa, 1);
+	  return 0;
+	}
+    }
+
+  __pthread_atomic_add (&__regex_cache_regexec, 1);
+  return regexec (&__preg->__re, __string, __nmatch, __pmatch, __eflags);
+}
+
+void
+regfree_cached (const regex_cached_t *__preg)
+{
+  __pthread_futex_lock (&__regex_cache_lock_v);
+  --((struct __regex_cached *) __preg)->__refs;
+  __pthread_futex_unlock (&__regex_cache_lock_v);
+}
+
+void
+regex_cache_flush (void)
+{
+  struct __regex_cached *__e;
+  struct __regex_cached *__older;
+  struct __regex_cached *__freed = NULL;
+
+  __pthread_futex_lock (&__regex_cache_lock_v);
+  for (__e = __regex_cache_newest; __e != NULL; __e = __older)
+    {
+      __older = __e->__older;
+      if (__e->__refs == 0)
+	{
+	  __regex_cache_unlink (__e);
+	  __e->__next = __freed;
+	  __freed = __e;
+	}
+    }
+  __pthread_futex_unlock (&__regex_cache_lock_v);
+
+  while (__freed != NULL)
+    {
+      __e = __freed->__next;
+      __regex_cache_free (__freed);
+      __freed = __e;
+    }
+}
+
+void
+regex_cache_stats (struct regex_cache_stats *__st)
+{
+  __pthread_futex_lock (&__regex_cache_lock_v);
+  *__st = __regex_cache_st;
+  __st->entries = __regex_cache_count;
+  __pthread_futex_unlock (&__regex_cache_lock_v);
+  __st->prefilter_rejects = (unsigned int) __regex_cache_prefilter;
+  __st->dfa_runs = (unsigned int) __regex_cache_dfa;
+  __st->regexec_runs = (unsigned int) __regex_cache_regexec;
+}
+
+#endif /* _BITS_UCLIBC_REGEX_CACHE_H */
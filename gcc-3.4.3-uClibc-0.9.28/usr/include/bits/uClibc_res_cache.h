@@ -0,0 +1,1279 @@
+/* Caching stub resolver for uClibc.
+ *
+ * GNU Library General Public License (LGPL) version 2 or later.
+ *
+ * The resolver in libc re-reads /etc/resolv.conf and /etc/hosts and
+ * asks a name server on every lookup.  Define _RES_CACHE_DEFINE in
+ * exactly one source file of the program before including <resolv.h>;
+ * that file then defines the res_cache_* functions declared there.
+ *
+ * Only code that calls the res_cache_* functions gets the cache.  The
+ * libc gethostbyname, gethostbyname_r, getaddrinfo and res_query are
+ * left alone and still go to the name server every time, as does
+ * anything inside libc or other libraries that uses them.  Programs
+ * opt in by calling the res_cache_* names in their place.
+ *
+ *  - res_cache_query is res_query with a cache in front of it.  An
+ *    answer is kept for the smallest TTL among its answer records; "no
+ *    such name" and "no such data" replies for the SOA minimum they
+ *    carry (RFC 2308), or a minute without one.  Server failures and
+ *    timeouts are not cached.
+ *  - res_cache_gethostbyname, res_cache_gethostbyname_r and
+ *    res_cache_getaddrinfo look a name up in /etc/hosts, then through
+ *    res_cache_query, and otherwise behave like the libc functions.
+ *    Names without a dot are tried with the resolv.conf search domains
+ *    first.  Results are IPv4 only, as libc is built without IPv6.
+ *    Lists from res_cache_getaddrinfo are freed with
+ *    res_cache_freeaddrinfo.
+ *  - /etc/hosts is kept in a hash table, and it and /etc/resolv.conf
+ *    are re-read when they change, checked at most once a second.
+ *  - res_cache_nameservers overrides the resolv.conf name servers,
+ *    e.g. with a stand-in server on a loopback port in tests.
+ *  - res_cache_stats reports hits, misses and failures, and
+ *    res_cache_flush empties the cache.
+ *
+ * Queries go out over UDP, and again over TCP if the reply was
+ * truncated.  One lock guards the cache, the hosts table and the
+ * configuration.  It is not held while waiting for a name server, so
+ * concurrent misses on one name may each send a query.
+ */
+
+#ifndef _RESOLV_H_
+#error Always include <resolv.h> rather than <bits/uClibc_res_cache.h>
+#endif
+
+#ifndef _BITS_UCLIBC_RES_CACHE_H
+#define _BITS_UCLIBC_RES_CACHE_H	1
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <bits/uClibc_fnv.h>
+
+#define __RES_CACHE_BUCKETS	64	/* Cache hash chains */
+#define __RES_CACHE_MAX		256	/* Cached answers */
+#define __RES_CACHE_NEG_TTL	60	/* Without an SOA to go by */
+#define __RES_CACHE_MAX_TTL	86400
+#define __RES_CACHE_HOSTS	256	/* Hosts table hash chains */
+#define __RES_CACHE_ADDRS	16	/* Addresses per name */
+#define __RES_CACHE_SEARCH	6	/* Search domains */
+#define __RES_CACHE_PACKETSZ	4096	/* Largest reply kept, via TCP */
+
+/**********************************************************************/
+/* Lock. */
+
+/* Taken with __pthread_futex_lock. */
+typedef volatile int __res_cache_lock_t;
+
+/**********************************************************************/
+/* State. */
+
+/* A cached reply: the whole packet, or the h_errno of a negative one. */
+struct __res_cache_ent
+{
+  struct __res_cache_ent *__next;
+  unsigned int __hash;
+  unsigned short __class;
+  unsigned short __type;
+  time_t __expires;
+  int __herr;
+  int __len;
+  unsigned char *__packet;
+  char __name[1];
+};
+
+struct __res_cache_host
+{
+  struct __res_cache_host *__next;
+  unsigned int __hash;
+  struct in_addr __addr;
+  const char *__canon;		/* First name on the line */
+  char __name[1];
+};
+
+/* A file re-read when it changes. */
+struct __res_cache_file
+{
+  time_t __checked;
+  time_t __mtime;
+  off_t __size;
+  ino_t __ino;
+  int __seen;
+};
+
+static __res_cache_lock_t __res_cache_lock_v;
+static struct __res_cache_ent *__res_cache_table[__RES_CACHE_BUCKETS];
+static unsigned int __res_cache_count;
+static struct res_cache_stats __res_cache_st;
+
+static struct __res_cache_host *__res_cache_hosts[__RES_CACHE_HOSTS];
+static struct __res_cache_file __res_cache_hosts_file;
+
+static struct __res_cache_file __res_cache_conf_file;
+static struct sockaddr_in __res_cache_ns[MAXNS];
+static int __res_cache_nns;
+static struct sockaddr_in __res_cache_ns_override[MAXNS];
+static int __res_cache_nns_override;
+static char __res_cache_search[__RES_CACHE_SEARCH][MAXDNAME];
+static int __res_cache_nsearch;
+static int __res_cache_timeout = 5;
+static int __res_cache_attempts = 2;
+static unsigned int __res_cache_seed;
+
+/**********************************************************************/
+/* Names. */
+
+static __inline int
+__res_cache_tolower (int __c)
+{
+  return __c >= 'A' && __c <= 'Z' ? __c + ('a' - 'A') : __c;
+}
+
+/* Copies NAME lowercased and without a trailing dot into BUF, which
+   holds MAXDNAME bytes.  Returns its length, or -1 if it is not a
+   valid domain name. */
+static int
+__res_cache_norm (const char *__name, char *__buf)
+{
+  int __len = 0;
+  int __label = 0;
+
+  for (; *__name != '\0'; ++__name)
+    {
+      if (*__name == '.')
+	{
+	  if (__label == 0)
+	    return -1;
+	  __label = 0;
+	}
+      else if (++__label > 63)
+	return -1;
+      if (__len >= NS_MAXDNAME - 2)
+	return -1;
+      __buf[__len++] = __res_cache_tolower ((unsigned char) *__name);
+    }
+  if (__len > 0 && __buf[__len - 1] == '.')
+    --__len;
+  if (__len == 0 || __len > 253)
+    return -1;
+  __buf[__len] = '\0';
+  return __len;
+}
+
+static unsigned int
+__res_cache_hash (const char *__name)
+{
+  /* FNV-1a of the lower-cased name. */
+  unsigned int __h = __UCLIBC_FNV_BASIS;
+
+  while (*__name != '\0')
+    __h = __uclibc_fnv1a_step (__h, __res_cache_tolower
+			       ((unsigned char) *__name++));
+  return __h;
+}
+
+static int
+__res_cache_strcaseeq (const char *__a, const char *__b)
+{
+  while (*__a != '\0'
+	 && __res_cache_tolower ((unsigned char) *__a)
+	    == __res_cache_tolower ((unsigned char) *__b))
+    ++__a, ++__b;
+  return *__a == '\0' && *__b == '\0';
+}
+
+/**********************************************************************/
+/* Configuration files. */
+
+/* Nonzero if PATH should be read again: its modification time, size
+   or inode changed since the last time.  Checks at most once a
+   second. */
+static int
+__res_cache_changed (const char *__path, struct __res_cache_file *__f,
+		     time_t __now)
+{
+  struct stat __st;
+
+  if (__f->__checked == __now)
+    return 0;
+  __f->__checked = __now;
+  if (stat (__path, &__st) != 0)
+    {
+      __st.st_mtime = 0;
+      __st.st_size = 0;
+      __st.st_ino = 0;
+    }
+  if (__st.st_mtime == __f->__mtime && __st.st_size == __f->__size
+      && __st.st_ino == __f->__ino && __f->__seen)
+    return 0;
+  __f->__seen = 1;
+  __f->__mtime = __st.st_mtime;
+  __f->__size = __st.st_size;
+  __f->__ino = __st.st_ino;
+  ++__res_cache_st.reloads;
+  return 1;
+}
+
+/* Splits a line into whitespace-separated words, in place.  Stops at
+   a comment. */
+static int
+__res_cache_words (char *__line, char **__w, int __max)
+{
+  int __n = 0;
+
+  for (;;)
+    {
+      while (*__line == ' ' || *__line == '\t' || *__line == '\r'
+	     || *__line == '\n')
+	*__line++ = '\0';
+      if (*__line == '\0' || *__line == '#' || *__line == ';'
+	  || __n == __max)
+	{
+	  *__line = '\0';
+	  return __n;
+	}
+      __w[__n++] = __line;
+      while (*__line != '\0' && *__line != ' ' && *__line != '\t'
+	     && *__line != '\r' && *__line != '\n')
+	++__line;
+    }
+}
+
+static void
+__res_cache_load_conf (void)
+{
+  char __line[512];
+  char *__w[2 + __RES_CACHE_SEARCH];
+  struct in_addr __a;
+  FILE *__fp;
+  int __n;
+  int __i;
+
+  __res_cache_nns = 0;
+  __res_cache_nsearch = 0;
+  __res_cache_timeout = 5;
+  __res_cache_attempts = 2;
+  __fp = fopen (_PATH_RESCONF, "r");
+  if (__fp != NULL)
+    {
+      while (fgets (__line, sizeof (__line), __fp) != NULL)
+	{
+	  __n = __res_cache_words (__line, __w, 2 + __RES_CACHE_SEARCH);
+	  if (__n < 2)
+	    continue;
+	  if (strcmp (__w[0], "nameserver") == 0)
+	    {
+	      if (__res_cache_nns < MAXNS && inet_aton (__w[1], &__a))
+		{
+		  memset (&__res_cache_ns[__res_cache_nns], 0,
+			  sizeof (struct sockaddr_in));
+		  __res_cache_ns[__res_cache_nns].sin_family = AF_INET;
+		  __res_cache_ns[__res_cache_nns].sin_port = htons (NAMESERVER_PORT);
+		  __res_cache_ns[__res_cache_nns++].sin_addr = __a;
+		}
+	    }
+	  else if (strcmp (__w[0], "domain") == 0
+		   || strcmp (__w[0], "search") == 0)
+	    {
+	      /* The last of them wins. */
+	      __res_cache_nsearch = 0;
+	      for (__i = 1; __i < __n; ++__i)
+		if (__res_cache_norm (__w[__i],
+				      __res_cache_search[__res_cache_nsearch])
+		    > 0)
+		  ++__res_cache_nsearch;
+	    }
+	  else if (strcmp (__w[0], "options") == 0)
+	    for (__i = 1; __i < __n; ++__i)
+	      {
+		if (strncmp (__w[__i], "timeout:", 8) == 0)
+		  __res_cache_timeout = atoi (__w[__i] + 8);
+		else if (strncmp (__w[__i], "attempts:", 9) == 0)
+		  __res_cache_attempts = atoi (__w[__i] + 9);
+	      }
+	}
+      fclose (__fp);
+    }
+  if (__res_cache_timeout < 1)
+    __res_cache_timeout = 1;
+  if (__res_cache_attempts < 1)
+    __res_cache_attempts = 1;
+  if (__res_cache_nns == 0)
+    {
+      memset (&__res_cache_ns[0], 0, sizeof (struct sockaddr_in));
+      __res_cache_ns[0].sin_family = AF_INET;
+      __res_cache_ns[0].sin_port = htons (NAMESERVER_PORT);
+      __res_cache_ns[0].sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+      __res_cache_nns = 1;
+    }
+}
+
+static void
+__res_cache_load_hosts (void)
+{
+  char __line[512];
+  char *__w[16];
+  struct __res_cache_host *__h;
+  struct __res_cache_host *__canon;
+  struct __res_cache_host **__p;
+  struct in_addr __a;
+  unsigned int __i;
+  size_t __len;
+  FILE *__fp;
+  int __n;
+  int __j;
+
+  for (__i = 0; __i < __RES_CACHE_HOSTS; ++__i)
+    while ((__h = __res_cache_hosts[__i]) != NULL)
+      {
+	__res_cache_hosts[__i] = __h->__next;
+	free (__h);
+      }
+  __fp = fopen (_PATH_HOSTS, "r");
+  if (__fp == NULL)
+    return;
+  while (fgets (__line, sizeof (__line), __fp) != NULL)
+    {
+      __n = __res_cache_words (__line, __w, 16);
+      if (__n < 2 || !inet_aton (__w[0], &__a))
+	continue;
+      __canon = NULL;
+      for (__j = 1; __j < __n; ++__j)
+	{
+	  __len = strlen (__w[__j]);
+	  __h = (struct __res_cache_host *) malloc (sizeof (*__h) + __len);
+	  if (__h == NULL)
+	    break;
+	  memcpy (__h->__name, __w[__j], __len + 1);
+	  __h->__hash = __res_cache_hash (__h->__name);
+	  __h->__addr = __a;
+	  if (__canon == NULL)
+	    __canon = __h;
+	  __h->__canon = __canon->__name;
+	  /* At the tail, so a name's addresses keep the file's order. */
+	  for (__p = &__res_cache_hosts[__h->__hash % __RES_CACHE_HOSTS];
+	       *__p != NULL; __p = &(*__p)->__next)
+	    ;
+	  __h->__next = NULL;
+	  *__p = __h;
+	}
+    }
+  fclose (__fp);
+}
+
+/* The lock is held. */
+static void
+__res_cache_refresh (void)
+{
+  time_t __now = time (NULL);
+  int __fd;
+
+  if (__res_cache_seed == 0)
+    {
+      /* Query IDs are random, so that replies are hard to forge. */
+      __fd = open ("/dev/urandom", O_RDONLY);
+      if (__fd >= 0)
+	{
+	  if (read (__fd, &__res_cache_seed, sizeof (__res_cache_seed)) < 0)
+	    __res_cache_seed = 0;
+	  close (__fd);
+	}
+      __res_cache_seed ^= (unsigned int) __now ^ ((unsigned int) getpid () << 16);
+      if (__res_cache_seed == 0)
+	__res_cache_seed = 1;
+    }
+
+  if (__res_cache_changed (_PATH_RESCONF, &__res_cache_conf_file, __now))
+    __res_cache_load_conf ();
+  if (__res_cache_changed (_PATH_HOSTS, &__res_cache_hosts_file, __now))
+    __res_cache_load_hosts ();
+}
+
+/**********************************************************************/
+/* The answer cache.  The lock is held. */
+
+static void
+__res_cache_unlink (struct __res_cache_ent *__e)
+{
+  struct __res_cache_ent **__p;
+
+  for (__p = &__res_cache_table[__e->__hash % __RES_CACHE_BUCKETS];
+       *__p != __e; __p = &(*__p)->__next)
+    ;
+  *__p = __e->__next;
+  free (__e);
+  --__res_cache_count;
+}
+
+static struct __res_cache_ent *
+__res_cache_find (const char *__name, unsigned int __hash, int __class,
+		  int __type)
+{
+  struct __res_cache_ent *__e;
+
+  for (__e = __res_cache_table[__hash % __RES_CACHE_BUCKETS]; __e != NULL;
+       __e = __e->__next)
+    if (__e->__hash == __hash && __e->__class == __class
+	&& __e->__type == __type && strcmp (__e->__name, __name) == 0)
+      return __e;
+  return NULL;
+}
+
+static void
+__res_cache_insert (const char *__name, unsigned int __hash, int __class,
+		    int __type, int __herr, unsigned int __ttl,
+		    const unsigned char *__packet, int __len)
+{
+  struct __res_cache_ent *__e;
+  struct __res_cache_ent *__victim;
+  size_t __nlen = strlen (__name);
+  time_t __now = time (NULL);
+  unsigned int __i;
+
+  __e = __res_cache_find (__name, __hash, __class, __type);
+  if (__e != NULL)
+    __res_cache_unlink (__e);
+  if (__res_cache_count >= __RES_CACHE_MAX)
+    {
+      /* Evict whatever expires first; expired entries go before that. */
+      __victim = NULL;
+      for (__i = 0; __i < __RES_CACHE_BUCKETS; ++__i)
+	for (__e = __res_cache_table[__i]; __e != NULL; __e = __e->__next)
+	  if (__victim == NULL || __e->__expires < __victim->__expires)
+	    __victim = __e;
+      __res_cache_unlink (__victim);
+      ++__res_cache_st.evictions;
+    }
+
+  __e = (struct __res_cache_ent *) malloc (sizeof (*__e) + __nlen + __len);
+  if (__e == NULL)
+    return;
+  memcpy (__e->__name, __name, __nlen + 1);
+  __e->__packet = (unsigned char *) __e->__name + __nlen + 1;
+  memcpy (__e->__packet, __packet, __len);
+  __e->__len = __len;
+  __e->__hash = __hash;
+  __e->__class = __class;
+  __e->__type = __type;
+  __e->__herr = __herr;
+  __e->__expires = __now + __ttl;
+  __e->__next = __res_cache_table[__hash % __RES_CACHE_BUCKETS];
+  __res_cache_table[__hash % __RES_CACHE_BUCKETS] = __e;
+  ++__res_cache_count;
+}
+
+/**********************************************************************/
+/* Packets. */
+
+static __inline unsigned int
+__res_cache_get16 (const unsigned char *__p)
+{
+  return (__p[0] << 8) | __p[1];
+}
+
+static __inline unsigned int
+__res_cache_get32 (const unsigned char *__p)
+{
+  return ((unsigned int) __p[0] << 24) | (__p[1] << 16) | (__p[2] << 8)
+	 | __p[3];
+}
+
+/* Expands the possibly compressed name at P in the message [MSG, END)
+   into BUF (MAXDNAME bytes, may be NULL).  Returns the end of the name
+   at P, or NULL if it is malformed. */
+static const unsigned char *
+__res_cache_name (const unsigned char *__msg, const unsigned char *__end,
+		  const unsigned char *__p, char *__buf)
+{
+  const unsigned char *__next = NULL;
+  int __len = 0;
+  int __hops = 0;
+  unsigned int __n;
+
+  for (;;)
+    {
+      if (__p >= __end)
+	return NULL;
+      __n = *__p;
+      if ((__n & 0xc0) == 0xc0)
+	{
+	  if (__p + 1 >= __end || ++__hops > 64)
+	    return NULL;
+	  if (__next == NULL)
+	    __next = __p + 2;
+	  __p = __msg + (((__n & 0x3f) << 8) | __p[1]);
+	  continue;
+	}
+      if (__n & 0xc0)
+	return NULL;
+      ++__p;
+      if (__n == 0)
+	break;
+      if (__p + __n > __end || __len + __n + 1 >= NS_MAXDNAME)
+	return NULL;
+      if (__buf != NULL)
+	{
+	  if (__len != 0)
+	    __buf[__len++] = '.';
+	  memcpy (__buf + __len, __p, __n);
+	}
+      else if (__len != 0)
+	++__len;
+      __len += __n;
+      __p += __n;
+    }
+  if (__buf != NULL)
+    __buf[__len] = '\0';
+  return __next != NULL ? __next : __p;
+}
+
+/* Builds a query for NAME into BUF; returns its length or -1. */
+static int
+__res_cache_mkquery (const char *__name, int __class, int __type,
+		     unsigned int __id, unsigned char *__buf)
+{
+  unsigned char *__p = __buf + HFIXEDSZ;
+  const char *__dot;
+  size_t __n;
+
+  memset (__buf, 0, HFIXEDSZ);
+  __buf[0] = __id >> 8;
+  __buf[1] = __id;
+  __buf[2] = 0x01;		/* RD */
+  __buf[5] = 1;			/* QDCOUNT */
+  while (*__name != '\0')
+    {
+      __dot = strchr (__name, '.');
+      __n = __dot != NULL ? (size_t) (__dot - __name) : strlen (__name);
+      if (__n == 0 || __n > 63)
+	return -1;
+      *__p++ = __n;
+      memcpy (__p, __name, __n);
+      __p += __n;
+      __name += __n;
+      if (*__name == '.')
+	++__name;
+    }
+  *__p++ = 0;
+  *__p++ = __type >> 8;
+  *__p++ = __type;
+  *__p++ = __class >> 8;
+  *__p++ = __class;
+  return __p - __buf;
+}
+
+/* Nonzero if ANS answers the query Q of QLEN bytes: same ID, a
+   response, and the same question. */
+static int
+__res_cache_matches (const unsigned char *__q, int __qlen,
+		     const unsigned char *__ans, int __len)
+{
+  int __i;
+
+  if (__len < __qlen || __ans[0] != __q[0] || __ans[1] != __q[1]
+      || !(__ans[2] & 0x80) || __res_cache_get16 (__ans + 4) != 1)
+    return 0;
+  for (__i = HFIXEDSZ; __i < __qlen; ++__i)
+    if (__res_cache_tolower (__ans[__i]) != __res_cache_tolower (__q[__i]))
+      return 0;
+  return 1;
+}
+
+/* How long to keep the reply ANS: the smallest TTL of the answers, or
+   for a negative reply the SOA minimum in the authority section. */
+static unsigned int
+__res_cache_ttl (const unsigned char *__ans, int __len, int __negative)
+{
+  const unsigned char *__end = __ans + __len;
+  const unsigned char *__p = __ans + HFIXEDSZ;
+  unsigned int __an = __res_cache_get16 (__ans + 6);
+  unsigned int __ns = __res_cache_get16 (__ans + 8);
+  unsigned int __ttl = __negative ? __RES_CACHE_NEG_TTL : __RES_CACHE_MAX_TTL;
+  unsigned int __t;
+  unsigned int __type;
+  unsigned int __rdlen;
+  unsigned int __i;
+
+  __p = __res_cache_name (__ans, __end, __p, NULL);
+  if (__p == NULL || __p + QFIXEDSZ > __end)
+    return 0;
+  __p += QFIXEDSZ;
+  for (__i = 0; __i < __an + __ns; ++__i)
+    {
+      __p = __res_cache_name (__ans, __end, __p, NULL);
+      if (__p == NULL || __p + RRFIXEDSZ > __end)
+	return 0;
+      __type = __res_cache_get16 (__p);
+      __t = __res_cache_get32 (__p + 4);
+      __rdlen = __res_cache_get16 (__p + 8);
+      __p += RRFIXEDSZ;
+      if (__p + __rdlen > __end)
+	return 0;
+      if (__t > 0x7fffffff)
+	__t = 0;
+      if (__i < __an)
+	{
+	  if (!__negative && __t < __ttl)
+	    __ttl = __t;
+	}
+      else if (__negative && __type == T_SOA && __rdlen >= 20)
+	{
+	  /* min (TTL, MINIMUM), MINIMUM being the last field. */
+	  __ttl = __res_cache_get32 (__p + __rdlen - 4);
+	  if (__t < __ttl)
+	    __ttl = __t;
+	}
+      __p += __rdlen;
+    }
+  return __ttl < __RES_CACHE_MAX_TTL ? __ttl : __RES_CACHE_MAX_TTL;
+}
+
+/**********************************************************************/
+/* Transport. */
+
+/* Reads N bytes, waiting at most TIMEOUT seconds for each part. */
+static int
+__res_cache_readn (int __fd, unsigned char *__buf, int __n, int __timeout)
+{
+  struct pollfd __pfd;
+  int __got;
+
+  __pfd.fd = __fd;
+  __pfd.events = POLLIN;
+  for (; __n > 0; __buf += __got, __n -= __got)
+    if (poll (&__pfd, 1, __timeout * 1000) <= 0
+	|| (__got = read (__fd, __buf, __n)) <= 0)
+      return -1;
+  return 0;
+}
+
+/* The query Q over TCP, for replies too large for UDP. */
+static int
+__res_cache_tcp (const struct sockaddr_in *__ns, const unsigned char *__q,
+		 int __qlen, unsigned char *__ans, int __anslen, int __timeout)
+{
+  unsigned char __hdr[2];
+  int __fd;
+  int __len = -1;
+
+  __fd = socket (AF_INET, SOCK_STREAM, 0);
+  if (__fd < 0)
+    return -1;
+  fcntl (__fd, F_SETFD, FD_CLOEXEC);
+  __hdr[0] = __qlen >> 8;
+  __hdr[1] = __qlen;
+  if (connect (__fd, (const struct sockaddr *) __ns, sizeof (*__ns)) == 0
+      && write (__fd, __hdr, 2) == 2 && write (__fd, __q, __qlen) == __qlen
+      && __res_cache_readn (__fd, __hdr, 2, __timeout) == 0)
+    {
+      __len = __res_cache_get16 (__hdr);
+      if (__len < HFIXEDSZ || __len > __anslen
+	  || __res_cache_readn (__fd, __ans, __len, __timeout) != 0
+	  || !__res_cache_matches (__q, __qlen, __ans, __len))
+	__len = -1;
+    }
+  close (__fd);
+  return __len;
+}
+
+/* Sends the query Q to the name servers NS in turn, ATTEMPTS times
+   round, until one answers.  Returns the length of the reply in ANS,
+   or -1. */
+static int
+__res_cache_send (const struct sockaddr_in *__ns, int __nns, int __timeout,
+		  int __attempts, const unsigned char *__q, int __qlen,
+		  unsigned char *__ans, int __anslen)
+{
+  struct sockaddr_in __from;
+  socklen_t __fromlen;
+  struct pollfd __pfd;
+  time_t __deadline;
+  int __fd;
+  int __len = -1;
+  int __n;
+  int __try;
+  int __i;
+
+  __fd = socket (AF_INET, SOCK_DGRAM, 0);
+  if (__fd < 0)
+    return -1;
+  fcntl (__fd, F_SETFD, FD_CLOEXEC);
+  __pfd.fd = __fd;
+  __pfd.events = POLLIN;
+  for (__try = 0; __try < __attempts && __len < 0; ++__try)
+    for (__i = 0; __i < __nns && __len < 0; ++__i)
+      {
+	if (sendto (__fd, __q, __qlen, 0,
+		    (const struct sockaddr *) &__ns[__i],
+		    sizeof (__ns[__i])) != __qlen)
+	  continue;
+	__deadline = time (NULL) + __timeout;
+	for (;;)
+	  {
+	    __n = __deadline - time (NULL);
+	    if (__n <= 0 || poll (&__pfd, 1, __n * 1000) <= 0)
+	      break;
+	    __fromlen = sizeof (__from);
+	    __n = recvfrom (__fd, __ans, __anslen, 0,
+			    (struct sockaddr *) &__from, &__fromlen);
+	    /* Anything not from the server or not answering this query
+	       is a stray or a spoofing attempt. */
+	    if (__n < HFIXEDSZ
+		|| __from.sin_addr.s_addr != __ns[__i].sin_addr.s_addr
+		|| __from.sin_port != __ns[__i].sin_port
+		|| !__res_cache_matches (__q, __qlen, __ans, __n))
+	      continue;
+	    if (__ans[2] & 0x02)	/* TC */
+	      __n = __res_cache_tcp (&__ns[__i], __q, __qlen, __ans,
+				     __anslen, __timeout);
+	    if (__n >= HFIXEDSZ)
+	      __len = __n;
+	    break;
+	  }
+      }
+  close (__fd);
+  return __len;
+}
+
+/**********************************************************************/
+/* Queries. */
+
+int
+res_cache_query (const char *__dname, int __class, int __type,
+		 u_char *__answer, int __anslen)
+{
+  char __name[NS_MAXDNAME];
+  unsigned char __q[HFIXEDSZ + NS_MAXDNAME + QFIXEDSZ];
+  struct sockaddr_in __ns[MAXNS];
+  struct __res_cache_ent *__e;
+  unsigned char *__ans;
+  unsigned int __hash;
+  unsigned int __ttl;
+  int __nns;
+  int __timeout;
+  int __attempts;
+  int __qlen;
+  int __len;
+  int __herr;
+  int __rcode;
+
+  if (__res_cache_norm (__dname, __name) < 0)
+    {
+      h_errno = NO_RECOVERY;
+      return -1;
+    }
+  __hash = __res_cache_hash (__name) ^ ((unsigned int) __type * 31);
+
+  __pthread_futex_lock (&__res_cache_lock_v);
+  __res_cache_refresh ();
+  __e = __res_cache_find (__name, __hash, __class, __type);
+  if (__e != NULL && __e->__expires <= time (NULL))
+    {
+      __res_cache_unlink (__e);
+      __e = NULL;
+      ++__res_cache_st.expired;
+    }
+  if (__e != NULL)
+    {
+      __herr = __e->__herr;
+      __len = __e->__len < __anslen ? __e->__len : __anslen;
+      memcpy (__answer, __e->__packet, __len);
+      if (__herr != 0)
+	++__res_cache_st.negative_hits;
+      else
+	++__res_cache_st.hits;
+      __pthread_futex_unlock (&__res_cache_lock_v);
+      if (__herr != 0)
+	{
+	  h_errno = __herr;
+	  return -1;
+	}
+      return __len;
+    }
+  ++__res_cache_st.misses;
+  if (__res_cache_nns_override > 0)
+    {
+      __nns = __res_cache_nns_override;
+      memcpy (__ns, __res_cache_ns_override, sizeof (__ns));
+    }
+  else
+    {
+      __nns = __res_cache_nns;
+      memcpy (__ns, __res_cache_ns, sizeof (__ns));
+    }
+  __timeout = __res_cache_timeout;
+  __attempts = __res_cache_attempts;
+  __res_cache_seed ^= __res_cache_seed << 13;
+  __res_cache_seed ^= __res_cache_seed >> 17;
+  __res_cache_seed ^= __res_cache_seed << 5;
+  __qlen = __res_cache_mkquery (__name, __class, __type,
+				__res_cache_seed & 0xffff, __q);
+  __pthread_futex_unlock (&__res_cache_lock_v);
+
+  __ans = (unsigned char *) malloc (__RES_CACHE_PACKETSZ);
+  if (__qlen < 0 || __ans == NULL)
+    {
+      free (__ans);
+      h_errno = NETDB_INTERNAL;
+      return -1;
+    }
+  __len = __res_cache_send (__ns, __nns, __timeout, __attempts, __q, __qlen,
+			    __ans, __RES_CACHE_PACKETSZ);
+  __rcode = __len < 0 ? -1 : (__ans[3] & 0x0f);
+  if (__rcode == NXDOMAIN)
+    __herr = HOST_NOT_FOUND;
+  else if (__rcode == NOERROR && __res_cache_get16 (__ans + 6) == 0)
+    __herr = NO_DATA;
+  else if (__rcode == NOERROR)
+    __herr = 0;
+  else
+    {
+      __pthread_futex_lock (&__res_cache_lock_v);
+      ++__res_cache_st.failures;
+      __pthread_futex_unlock (&__res_cache_lock_v);
+      free (__ans);
+      h_errno = __rcode < 0 || __rcode == SERVFAIL ? TRY_AGAIN : NO_RECOVERY;
+      return -1;
+    }
+
+  __ttl = __res_cache_ttl (__ans, __len, __herr != 0);
+  if (__ttl > 0)
+    {
+      __pthread_futex_lock (&__res_cache_lock_v);
+      __res_cache_insert (__name, __hash, __class, __type, __herr, __ttl,
+			  __ans, __len);
+      __pthread_futex_unlock (&__res_cache_lock_v);
+    }
+  if (__len > __anslen)
+    __len = __anslen;
+  memcpy (__answer, __ans, __len);
+  free (__ans);
+  if (__herr != 0)
+    {
+      h_errno = __herr;
+      return -1;
+    }
+  return __len;
+}
+
+/* The addresses of NAME in the hosts table, in file order, in ADDRS
+   (at most __RES_CACHE_ADDRS), and its canonical name in CANON
+   (MAXDNAME bytes).  Returns how many. */
+static int
+__res_cache_lookup_hosts (const char *__name, struct in_addr *__addrs,
+			  char *__canon)
+{
+  struct __res_cache_host *__h;
+  unsigned int __hash;
+  int __n = 0;
+
+  __hash = __res_cache_hash (__name);
+  __pthread_futex_lock (&__res_cache_lock_v);
+  __res_cache_refresh ();
+  for (__h = __res_cache_hosts[__hash % __RES_CACHE_HOSTS]; __h != NULL;
+       __h = __h->__next)
+    if (__h->__hash == __hash && __res_cache_strcaseeq (__h->__name, __name)
+	&& __n < __RES_CACHE_ADDRS)
+      {
+	if (__n == 0)
+	  {
+	    strncpy (__canon, __h->__canon, NS_MAXDNAME - 1);
+	    __canon[NS_MAXDNAME - 1] = '\0';
+	  }
+	__addrs[__n++] = __h->__addr;
+      }
+  if (__n > 0)
+    ++__res_cache_st.hosts_hits;
+  __pthread_futex_unlock (&__res_cache_lock_v);
+  return __n;
+}
+
+/* The A records of NAME from the name servers, in ADDRS (at most
+   __RES_CACHE_ADDRS), and its canonical name in CANON (MAXDNAME
+   bytes).  Returns how many, or 0 with *HERR set. */
+static int
+__res_cache_lookup_1 (const char *__name, struct in_addr *__addrs,
+		      char *__canon, int *__herr)
+{
+  const unsigned char *__end;
+  const unsigned char *__p;
+  const unsigned char *__rr;
+  unsigned char *__ans;
+  unsigned int __an;
+  unsigned int __rdlen;
+  unsigned int __i;
+  int __len;
+  int __n = 0;
+
+  __ans = (unsigned char *) malloc (__RES_CACHE_PACKETSZ);
+  if (__ans == NULL)
+    {
+      *__herr = NETDB_INTERNAL;
+      return 0;
+    }
+  __len = res_cache_query (__name, C_IN, T_A, __ans, __RES_CACHE_PACKETSZ);
+  if (__len < 0)
+    {
+      *__herr = h_errno;
+      free (__ans);
+      return 0;
+    }
+  __end = __ans + __len;
+  __an = __res_cache_get16 (__ans + 6);
+  __p = __res_cache_name (__ans, __end, __ans + HFIXEDSZ, NULL);
+  if (__p != NULL)
+    __p += QFIXEDSZ;
+  for (__i = 0; __i < __an && __p != NULL && __n < __RES_CACHE_ADDRS; ++__i)
+    {
+      __rr = __p;
+      __p = __res_cache_name (__ans, __end, __p, NULL);
+      if (__p == NULL || __p + RRFIXEDSZ > __end)
+	break;
+      __rdlen = __res_cache_get16 (__p + 8);
+      if (__p + RRFIXEDSZ + __rdlen > __end)
+	break;
+      if (__res_cache_get16 (__p) == T_A && __res_cache_get16 (__p + 2) == C_IN
+	  && __rdlen == 4)
+	{
+	  if (__n == 0)
+	    __res_cache_name (__ans, __end, __rr, __canon);
+	  memcpy (&__addrs[__n++], __p + RRFIXEDSZ, 4);
+	}
+      __p += RRFIXEDSZ + __rdlen;
+    }
+  free (__ans);
+  if (__n == 0)
+    *__herr = NO_DATA;
+  return __n;
+}
+
+/* The addresses of NAME: numeric, then from the hosts table, then from
+   the name servers with the search domains. */
+static int
+__res_cache_lookup (const char *__name, struct in_addr *__addrs,
+		    char *__canon, int *__herr)
+{
+  char __fqdn[NS_MAXDNAME];
+  char __search[__RES_CACHE_SEARCH][NS_MAXDNAME];
+  size_t __len;
+  int __nsearch;
+  int __n;
+  int __i;
+  int __again = 0;
+
+  if (inet_aton (__name, &__addrs[0]))
+    {
+      strncpy (__canon, __name, NS_MAXDNAME - 1);
+      __canon[NS_MAXDNAME - 1] = '\0';
+      return 1;
+    }
+  __len = strlen (__name);
+  if (__len == 0 || __len >= NS_MAXDNAME)
+    {
+      *__herr = HOST_NOT_FOUND;
+      return 0;
+    }
+  __n = __res_cache_lookup_hosts (__name, __addrs, __canon);
+  if (__n > 0)
+    return __n;
+
+  __nsearch = 0;
+  if (strchr (__name, '.') == NULL)
+    {
+      __pthread_futex_lock (&__res_cache_lock_v);
+      __res_cache_refresh ();
+      __nsearch = __res_cache_nsearch;
+      memcpy (__search, __res_cache_search, sizeof (__search));
+      __pthread_futex_unlock (&__res_cache_lock_v);
+    }
+  for (__i = 0; __i <= __nsearch; ++__i)
+    {
+      if (__i < __nsearch)
+	{
+	  if (__len + 1 + strlen (__search[__i]) >= NS_MAXDNAME)
+	    continue;
+	  memcpy (__fqdn, __name, __len);
+	  __fqdn[__len] = '.';
+	  strcpy (__fqdn + __len + 1, __search[__i]);
+	}
+      else
+	strcpy (__fqdn, __name);
+      __n = __res_cache_lookup_1 (__fqdn, __addrs, __canon, __herr);
+      if (__n > 0)
+	return __n;
+      if (*__herr == TRY_AGAIN)
+	__again = 1;
+    }
+  if (__again)
+    *__herr = TRY_AGAIN;
+  return 0;
+}
+
+/**********************************************************************/
+/* Interfaces. */
+
+int
+res_cache_gethostbyname_r (const char *__name, struct hostent *__ret,
+			   char *__buf, size_t __buflen,
+			   struct hostent **__result, int *__h_errnop)
+{
+  struct in_addr __addrs[__RES_CACHE_ADDRS];
+  char __canon[NS_MAXDNAME];
+  char **__ptrs;
+  size_t __clen;
+  size_t __nlen;
+  size_t __need;
+  size_t __pad;
+  int __herr;
+  int __n;
+  int __i;
+
+  *__result = NULL;
+  __n = __res_cache_lookup (__name, __addrs, __canon, &__herr);
+  if (__n == 0)
+    {
+      *__h_errnop = __herr;
+      return __herr == NETDB_INTERNAL ? errno : 0;
+    }
+
+  /* The pointers of h_addr_list and h_aliases, the addresses, the
+     canonical name and the name asked for as an alias. */
+  __pad = -(unsigned long int) __buf & (sizeof (char *) - 1);
+  __clen = strlen (__canon) + 1;
+  __nlen = strlen (__name) + 1;
+  __need = __pad + (__n + 3) * sizeof (char *) + __n * sizeof (__addrs[0])
+	   + __clen + __nlen;
+  if (__buflen < __need)
+    {
+      *__h_errnop = NETDB_INTERNAL;
+      return ERANGE;
+    }
+  __ptrs = (char **) (__buf + __pad);
+  __buf = (char *) (__ptrs + __n + 3);
+  __ret->h_addr_list = __ptrs;
+  for (__i = 0; __i < __n; ++__i)
+    {
+      __ptrs[__i] = __buf;
+      memcpy (__buf, &__addrs[__i], sizeof (__addrs[0]));
+      __buf += sizeof (__addrs[0]);
+    }
+  __ptrs[__n] = NULL;
+  __ret->h_aliases = __ptrs + __n + 1;
+  __ret->h_name = (char *) memcpy (__buf, __canon, __clen);
+  __buf += __clen;
+  __ret->h_aliases[0] = NULL;
+  __ret->h_aliases[1] = NULL;
+  if (!__res_cache_strcaseeq (__canon, __name))
+    __ret->h_aliases[0] = (char *) memcpy (__buf, __name, __nlen);
+  __ret->h_addrtype = AF_INET;
+  __ret->h_length = sizeof (__addrs[0]);
+  *__result = __ret;
+  *__h_errnop = 0;
+  return 0;
+}
+
+struct hostent *
+res_cache_gethostbyname (const char *__name)
+{
+  static struct hostent __h;
+  static char __buf[NS_MAXDNAME * 2 + __RES_CACHE_ADDRS * 8 + 64];
+  struct hostent *__result;
+  int __herr;
+
+  res_cache_gethostbyname_r (__name, &__h, __buf, sizeof (__buf), &__result,
+			     &__herr);
+  if (__result == NULL)
+    h_errno = __herr;
+  return __result;
+}
+
+int
+res_cache_getaddrinfo (const char *__node, const char *__service,
+		       const struct addrinfo *__hints,
+		       struct addrinfo **__res)
+{
+  static const int __socktypes[2] = { SOCK_STREAM, SOCK_DGRAM };
+  struct in_addr __addrs[__RES_CACHE_ADDRS];
+  char __canon[NS_MAXDNAME];
+  int __ports[2];
+  struct addrinfo __none;
+  struct addrinfo *__ai;
+  struct addrinfo **__tail;
+  struct sockaddr_in *__sin;
+  struct servent *__se;
+  size_t __clen;
+  unsigned long int __port;
+  char *__endp;
+  int __herr;
+  int __n;
+  int __i;
+  int __s;
+
+  *__res = NULL;
+  if (__hints == NULL)
+    {
+      memset (&__none, 0, sizeof (__none));
+      __hints = &__none;
+    }
+  if (__hints->ai_flags & ~(AI_PASSIVE | AI_CANONNAME | AI_NUMERICHOST))
+    return EAI_BADFLAGS;
+  if (__hints->ai_family != AF_UNSPEC && __hints->ai_family != AF_INET)
+    return EAI_FAMILY;
+  if (__hints->ai_socktype != 0 && __hints->ai_socktype != SOCK_STREAM
+      && __hints->ai_socktype != SOCK_DGRAM)
+    return EAI_SOCKTYPE;
+  if (__node == NULL && __service == NULL)
+    return EAI_NONAME;
+
+  /* The port for each socket type, or -1 where the service has none. */
+  for (__s = 0; __s < 2; ++__s)
+    {
+      __ports[__s] = -1;
+      if (__hints->ai_socktype != 0
+	  && __hints->ai_socktype != __socktypes[__s])
+	continue;
+      if (__service == NULL)
+	__ports[__s] = 0;
+      else
+	{
+	  __port = strtoul (__service, &__endp, 10);
+	  if (*__service != '\0' && *__endp == '\0')
+	    __ports[__s] = __port <= 0xffff ? (int) htons (__port) : -1;
+	  else if ((__se = getservbyname (__service,
+					  __s == 0 ? "tcp" : "udp")) != NULL)
+	    __ports[__s] = __se->s_port;
+	}
+    }
+  if (__ports[0] < 0 && __ports[1] < 0)
+    return EAI_SERVICE;
+
+  if (__node == NULL)
+    {
+      __addrs[0].s_addr = htonl (__hints->ai_flags & AI_PASSIVE
+				 ? INADDR_ANY : INADDR_LOOPBACK);
+      strcpy (__canon, "localhost");
+      __n = 1;
+    }
+  else if (__hints->ai_flags & AI_NUMERICHOST)
+    {
+      if (!inet_aton (__node, &__addrs[0]))
+	return EAI_NONAME;
+      strncpy (__canon, __node, NS_MAXDNAME - 1);
+      __canon[NS_MAXDNAME - 1] = '\0';
+      __n = 1;
+    }
+  else
+    {
+      __n = __res_cache_lookup (__node, __addrs, __canon, &__herr);
+      if (__n == 0)
+	switch (__herr)
+	  {
+	  case HOST_NOT_FOUND:
+	    return EAI_NONAME;
+	  case NO_DATA:
+	    return EAI_NODATA;
+	  case TRY_AGAIN:
+	    return EAI_AGAIN;
+	  case NETDB_INTERNAL:
+	    return EAI_SYSTEM;
+	  default:
+	    return EAI_FAIL;
+	  }
+    }
+
+  /* Each entry is one block, with its address and, for the first, the
+     canonical name. */
+  __tail = __res;
+  for (__i = 0; __i < __n; ++__i)
+    for (__s = 0; __s < 2; ++__s)
+      {
+	if (__ports[__s] < 0)
+	  continue;
+	__clen = (__hints->ai_flags & AI_CANONNAME) && *__res == NULL
+		 ? strlen (__canon) + 1 : 0;
+	__ai = (struct addrinfo *) malloc (sizeof (*__ai) + sizeof (*__sin)
+					   + __clen);
+	if (__ai == NULL)
+	  {
+	    res_cache_freeaddrinfo (*__res);
+	    *__res = NULL;
+	    return EAI_MEMORY;
+	  }
+	memset (__ai, 0, sizeof (*__ai) + sizeof (*__sin));
+	__sin = (struct sockaddr_in *) (__ai + 1);
+	__sin->sin_family = AF_INET;
+	__sin->sin_port = __ports[__s];
+	__sin->sin_addr = __addrs[__i];
+	__ai->ai_family = AF_INET;
+	__ai->ai_socktype = __socktypes[__s];
+	__ai->ai_protocol = __hints->ai_protocol != 0 ? __hints->ai_protocol
+			    : __s == 0 ? IPPROTO_TCP : IPPROTO_UDP;
+	__ai->ai_addrlen = sizeof (*__sin);
+	__ai->ai_addr = (struct sockaddr *) __sin;
+	if (__clen != 0)
+	  __ai->ai_canonname = (char *) memcpy (__sin + 1, __canon, __clen);
+	*__tail = __ai;
+	__tail = &__ai->ai_next;
+      }
+  return 0;
+}
+
+void
+res_cache_freeaddrinfo (struct addrinfo *__ai)
+{
+  struct addrinfo *__next;
+
+  for (; __ai != NULL; __ai = __next)
+    {
+      __next = __ai->ai_next;
+      free (__ai);
+    }
+}
+
+int
+res_cache_nameservers (const struct sockaddr_in *__addrs, int __n)
+{
+  if (__n < 0 || __n > MAXNS)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+  __pthread_futex_lock (&__res_cache_lock_v);
+  if (__n > 0)
+    memcpy (__res_cache_ns_override, __addrs, __n * sizeof (*__addrs));
+  __res_cache_nns_override = __n;
+  __pthread_futex_unlock (&__res_cache_lock_v);
+  return 0;
+}
+
+void
+res_cache_flush (void)
+{
+  unsigned int __i;
+
+  __pthread_futex_lock (&__res_cache_lock_v);
+  for (__i = 0; __i < __RES_CACHE_BUCKETS; ++__i)
+    while (__res_cache_table[__i] != NULL)
+      __res_cache_unlink (__res_cache_table[__i]);
+  __pthread_futex_unlock (&__res_cache_lock_v);
+}
+
+void
+res_cache_stats (struct res_cache_stats *__st)
+{
+  __pthread_futex_lock (&__res_cache_lock_v);
+  *__st = __res_cache_st;
+  __st->entries = __res_cache_count;
+  __pthread_futex_unlock (&__res_cache_lock_v);
+}
+
+#endif /* _BITS_UCLIBC_RES_CACHE_H */
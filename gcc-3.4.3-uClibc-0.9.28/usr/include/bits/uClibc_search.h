@@ -0,0 +1,500 @@
+/* Red-black tsearch family and a growable hsearch_r.
+ *
+ * GNU Library General Public License (LGPL) version 2 or later.
+ *
+ * The tsearch in libc builds an unbalanced tree, so keys inserted in
+ * order (sequence numbers, timestamps, increasing ids) turn it into a
+ * linked list with O(n) searches.  <search.h> maps tsearch, tfind,
+ * tdelete, twalk and tdestroy onto the red-black versions below, which
+ * keep the tree height under 2 log2 n.  The void ** root interface is
+ * unchanged, and the key is still the first member of a node, so code
+ * that dereferences the returned nodes keeps working.  Trees must not
+ * be shared with objects compiled against the old header.
+ *
+ * hcreate_grow_r, hsearch_grow_r and hdestroy_grow_r work like the _r
+ * hash functions, but the table doubles when it is three quarters full
+ * instead of refusing new entries.  The entries are moved a few at a
+ * time by the following ENTER calls, so no single call pays for the
+ * whole rehash.  An ENTRY returned by hsearch_grow_r stays valid only
+ * until the next ENTER on the same table.
+ */
+
+#ifndef _SEARCH_H
+#error Always include <search.h> rather than <bits/uClibc_search.h>
+#endif
+
+#ifndef _BITS_UCLIBC_SEARCH_H
+#define _BITS_UCLIBC_SEARCH_H	1
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <bits/uClibc_fnv.h>
+
+/* Deeper than any red-black tree that fits in the address space, with
+   room for the extra level tdelete pushes while rebalancing. */
+#define __UCLIBC_TSEARCH_DEPTH	(16 * sizeof (void *))
+
+typedef struct __uclibc_tnode
+  {
+    const void *__key;		/* Must be first; see <search.h>. */
+    struct __uclibc_tnode *__left;
+    struct __uclibc_tnode *__right;
+    unsigned int __red;
+  }
+*__uclibc_tnode_t;
+
+static __inline void *
+__uclibc_tfind (const void *__key, void *const *__rootp,
+		__compar_fn_t __compar)
+{
+  __uclibc_tnode_t __n;
+  int __c;
+
+  if (__rootp == NULL)
+    return NULL;
+  for (__n = (__uclibc_tnode_t) *__rootp; __n != NULL; )
+    {
+      __c = __compar (__key, __n->__key);
+      if (__c == 0)
+	return __n;
+      __n = __c < 0 ? __n->__left : __n->__right;
+    }
+  return NULL;
+}
+
+static __inline void *
+__uclibc_tsearch (const void *__key, void **__rootp, __compar_fn_t __compar)
+{
+  __uclibc_tnode_t *__path[__UCLIBC_TSEARCH_DEPTH];
+  __uclibc_tnode_t *__link;
+  __uclibc_tnode_t __n;
+  __uclibc_tnode_t __x;
+  __uclibc_tnode_t __p;
+  __uclibc_tnode_t __g;
+  __uclibc_tnode_t __u;
+  unsigned int __depth;
+  int __c;
+
+  if (__rootp == NULL)
+    return NULL;
+
+  /* __path[i] is the link to the node at depth i. */
+  __depth = 0;
+  for (__link = (__uclibc_tnode_t *) __rootp; *__link != NULL; )
+    {
+      __c = __compar (__key, (*__link)->__key);
+      if (__c == 0)
+	return *__link;
+      __path[__depth++] = __link;
+      __link = __c < 0 ? &(*__link)->__left : &(*__link)->__right;
+    }
+
+  __n = (__uclibc_tnode_t) malloc (sizeof (*__n));
+  if (__n == NULL)
+    return NULL;
+  __n->__key = __key;
+  __n->__left = __n->__right = NULL;
+  __n->__red = 1;
+  *__link = __n;
+  __path[__depth] = __link;
+
+  /* While the new node and its parent are both red, either recolor and
+     move two levels up, or rotate once or twice and stop. */
+  while (__depth > 0)
+    {
+      __x = *__path[__depth];
+      __p = *__path[__depth - 1];
+      if (!__p->__red)
+	break;
+      /* A red parent is never the root. */
+      __g = *__path[__depth - 2];
+      __u = __g->__left == __p ? __g->__right : __g->__left;
+      if (__u != NULL && __u->__red)
+	{
+	  __p->__red = __u->__red = 0;
+	  __g->__red = 1;
+	  __depth -= 2;
+	  continue;
+	}
+      if (__g->__left == __p)
+	{
+	  if (__p->__right == __x)
+	    {
+	      __p->__right = __x->__left;
+	      __x->__left = __p;
+	      __p = __x;
+	    }
+	  __g->__left = __p->__right;
+	  __p->__right = __g;
+	}
+      else
+	{
+	  if (__p->__left == __x)
+	    {
+	      __p->__left = __x->__right;
+	      __x->__right = __p;
+	      __p = __x;
+	    }
+	  __g->__right = __p->__left;
+	  __p->__left = __g;
+	}
+      *__path[__depth - 2] = __p;
+      __p->__red = 0;
+      __g->__red = 1;
+      break;
+    }
+  (*(__uclibc_tnode_t *) __rootp)->__red = 0;
+  return __n;
+}
+
+static __inline void *
+__uclibc_tdelete (const void *__restrict __key, void **__restrict __rootp,
+		  __compar_fn_t __compar)
+{
+  __uclibc_tnode_t *__path[__UCLIBC_TSEARCH_DEPTH];
+  __uclibc_tnode_t *__link;
+  __uclibc_tnode_t __z;
+  __uclibc_tnode_t __x;
+  __uclibc_tnode_t __p;
+  __uclibc_tnode_t __w;
+  __uclibc_tnode_t __l;
+  void *__ret;
+  unsigned int __depth;
+  int __c;
+
+  if (__rootp == NULL || *__rootp == NULL)
+    return NULL;
+
+  /* As in tsearch, __path[i] is the link to the node at depth i; the
+     deleted node's own link is __link.  POSIX leaves the result for
+     the root unspecified, except that it is not NULL. */
+  __depth = 0;
+  __ret = __rootp;
+  for (__link = (__uclibc_tnode_t *) __rootp; ; )
+    {
+      if (*__link == NULL)
+	return NULL;
+      __c = __compar (__key, (*__link)->__key);
+      if (__c == 0)
+	break;
+      __ret = *__link;
+      __path[__depth++] = __link;
+      __link = __c < 0 ? &(*__link)->__left : &(*__link)->__right;
+    }
+
+  /* A node with two children takes its successor's key, and the
+     successor, which has no left child, is unlinked instead. */
+  __z = *__link;
+  if (__z->__left != NULL && __z->__right != NULL)
+    {
+      __path[__depth++] = __link;
+      for (__link = &__z->__right; (*__link)->__left != NULL;
+	   __link = &(*__link)->__left)
+	__path[__depth++] = __link;
+      __z->__key = (*__link)->__key;
+      __z = *__link;
+    }
+  *__link = __z->__left != NULL ? __z->__left : __z->__right;
+  __c = __z->__red;
+  free (__z);
+  if (__c)
+    return __ret;
+
+  /* A black node went away: the subtree at __link is one black node
+     short.  Push the deficit up, or fix it with at most three
+     rotations. */
+  while (__depth > 0)
+    {
+      __x = *__link;
+      if (__x != NULL && __x->__red)
+	break;
+      __p = *__path[__depth - 1];
+      if (__link == &__p->__left)
+	{
+	  __w = __p->__right;
+	  if (__w->__red)
+	    {
+	      __w->__red = 0;
+	      __p->__red = 1;
+	      __p->__right = __w->__left;
+	      __w->__left = __p;
+	      *__path[__depth - 1] = __w;
+	      __path[__depth++] = &__w->__left;
+	      __w = __p->__right;
+	    }
+	  if ((__w->__left == NULL || !__w->__left->__red)
+	      && (__w->__right == NULL || !__w->__right->__red))
+	    {
+	      __w->__red = 1;
+	      __link = __path[--__depth];
+	      continue;
+	    }
+	  if (__w->__right == NULL || !__w->__right->__red)
+	    {
+	      __l = __w->__left;
+	      __l->__red = 0;
+	      __w->__red = 1;
+	      __w->__left = __l->__right;
+	      __l->__right = __w;
+	      __p->__right = __w = __l;
+	    }
+	  __w->__red = __p->__red;
+	  __p->__red = 0;
+	  __w->__right->__red = 0;
+	  __p->__right = __w->__left;
+	  __w->__left = __p;
+	}
+      else
+	{
+	  __w = __p->__left;
+	  if (__w->__red)
+	    {
+	      __w->__red = 0;
+	      __p->__red = 1;
+	      __p->__left = __w->__right;
+	      __w->__right = __p;
+	      *__path[__depth - 1] = __w;
+	      __path[__depth++] = &__w->__right;
+	      __w = __p->__left;
+	    }
+	  if ((__w->__left == NULL || !__w->__left->__red)
+	      && (__w->__right == NULL || !__w->__right->__red))
+	    {
+	      __w->__red = 1;
+	      __link = __path[--__depth];
+	      continue;
+	    }
+	  if (__w->__left == NULL || !__w->__left->__red)
+	    {
+	      __l = __w->__right;
+	      __l->__red = 0;
+	      __w->__red = 1;
+	      __w->__right = __l->__left;
+	      __l->__left = __w;
+	      __p->__left = __w = __l;
+	    }
+	  __w->__red = __p->__red;
+	  __p->__red = 0;
+	  __w->__left->__red = 0;
+	  __p->__left = __w->__right;
+	  __w->__right = __p;
+	}
+      *__path[__depth - 1] = __w;
+      return __ret;
+    }
+  if (*__link != NULL)
+    (*__link)->__red = 0;
+  return __ret;
+}
+
+static __inline void
+__uclibc_twalk_1 (__uclibc_tnode_t __n, __action_fn_t __action, int __level)
+{
+  if (__n->__left == NULL && __n->__right == NULL)
+    {
+      __action (__n, leaf, __level);
+      return;
+    }
+  __action (__n, preorder, __level);
+  if (__n->__left != NULL)
+    __uclibc_twalk_1 (__n->__left, __action, __level + 1);
+  __action (__n, postorder, __level);
+  if (__n->__right != NULL)
+    __uclibc_twalk_1 (__n->__right, __action, __level + 1);
+  __action (__n, endorder, __level);
+}
+
+static __inline void
+__uclibc_twalk (const void *__root, __action_fn_t __action)
+{
+  if (__root != NULL && __action != NULL)
+    __uclibc_twalk_1 ((__uclibc_tnode_t) __root, __action, 0);
+}
+
+#ifdef __USE_GNU
+static __inline void
+__uclibc_tdestroy (void *__root, __free_fn_t __freefct)
+{
+  __uclibc_tnode_t __n = (__uclibc_tnode_t) __root;
+
+  if (__n == NULL)
+    return;
+  __uclibc_tdestroy (__n->__left, __freefct);
+  __uclibc_tdestroy (__n->__right, __freefct);
+  __freefct ((void *) __n->__key);
+  free (__n);
+}
+#endif
+
+#ifdef __USE_GNU
+struct __uclibc_hslot
+  {
+    unsigned int __hash;
+    ENTRY __entry;		/* key is NULL while the slot is empty. */
+  };
+
+static __inline unsigned int
+__uclibc_hhash (const char *__key)
+{
+  return __uclibc_fnv1a (__UCLIBC_FNV_BASIS, __key);
+}
+
+/* The slot holding KEY in a table of SIZE slots, or the empty slot
+   where it would go. */
+static __inline struct __uclibc_hslot *
+__uclibc_hprobe (struct __uclibc_hslot *__table, unsigned int __size,
+		 const char *__key, unsigned int __hash)
+{
+  unsigned int __i = __hash & (__size - 1);
+
+  while (__table[__i].__entry.key != NULL
+	 && (__table[__i].__hash != __hash
+	     || strcmp (__table[__i].__entry.key, __key) != 0))
+    __i = (__i + 1) & (__size - 1);
+  return &__table[__i];
+}
+
+static __inline int
+hcreate_grow_r (size_t __nel, struct hsearch_grow_data *__htab)
+{
+  unsigned int __size;
+
+  if (__htab == NULL)
+    {
+      errno = EINVAL;
+      return 0;
+    }
+  if (__htab->table != NULL)
+    return 0;
+  for (__size = 8; __size / 4 * 3 < __nel; __size *= 2)
+    if (__size >= 1U << 30)
+      {
+	errno = ENOMEM;
+	return 0;
+      }
+  __htab->table = (struct __uclibc_hslot *)
+    calloc (__size, sizeof (struct __uclibc_hslot));
+  if (__htab->table == NULL)
+    return 0;
+  __htab->size = __size;
+  __htab->filled = 0;
+  __htab->old_table = NULL;
+  __htab->old_size = 0;
+  __htab->old_filled = 0;
+  __htab->old_next = 0;
+  return 1;
+}
+
+static __inline void
+hdestroy_grow_r (struct hsearch_grow_data *__htab)
+{
+  if (__htab == NULL)
+    {
+      errno = EINVAL;
+      return;
+    }
+  free (__htab->table);
+  free (__htab->old_table);
+  __htab->table = __htab->old_table = NULL;
+}
+
+/* Moves entries out of the old table until COUNT have been moved or it
+   is empty, then frees it. */
+static __inline void
+__uclibc_hmigrate (struct hsearch_grow_data *__htab, unsigned int __count)
+{
+  struct __uclibc_hslot *__old = __htab->old_table;
+  struct __uclibc_hslot *__s;
+
+  while (__count != 0 && __htab->old_filled != 0)
+    {
+      __s = &__old[__htab->old_next++];
+      if (__s->__entry.key == NULL)
+	continue;
+      *__uclibc_hprobe (__htab->table, __htab->size, __s->__entry.key,
+			__s->__hash) = *__s;
+      ++__htab->filled;
+      --__htab->old_filled;
+      --__count;
+    }
+  if (__htab->old_filled == 0)
+    {
+      free (__old);
+      __htab->old_table = NULL;
+    }
+}
+
+/* Like hsearch_r.  ENTER never fails for lack of room unless the table
+   cannot be grown. */
+static __inline int
+hsearch_grow_r (ENTRY __item, ACTION __action, ENTRY **__retval,
+		struct hsearch_grow_data *__htab)
+{
+  struct __uclibc_hslot *__s;
+  struct __uclibc_hslot *__t;
+  const unsigned int __hash = __uclibc_hhash (__item.key);
+
+  /* Entries in the new table were entered or moved last, so look there
+     first; the old table still holds whatever has not been moved. */
+  __s = __uclibc_hprobe (__htab->table, __htab->size, __item.key, __hash);
+  if (__s->__entry.key == NULL && __htab->old_table != NULL)
+    {
+      __t = __uclibc_hprobe (__htab->old_table, __htab->old_size,
+			     __item.key, __hash);
+      if (__t->__entry.key != NULL)
+	__s = __t;
+    }
+  if (__s->__entry.key != NULL)
+    {
+      *__retval = &__s->__entry;
+      return 1;
+    }
+  if (__action == FIND)
+    {
+      *__retval = NULL;
+      errno = ESRCH;
+      return 0;
+    }
+
+  if (__htab->filled + __htab->old_filled + 1 > __htab->size / 4 * 3
+      && __htab->size < 1U << 30)
+    {
+      /* Grow.  Moving four entries per ENTER empties the old table long
+	 before the new one fills up again; flushing it here only matters
+	 when the last attempt to grow failed. */
+      if (__htab->old_table != NULL)
+	__uclibc_hmigrate (__htab, ~0U);
+      __t = (struct __uclibc_hslot *)
+	calloc (2 * __htab->size, sizeof (struct __uclibc_hslot));
+      if (__t != NULL)
+	{
+	  __htab->old_table = __htab->table;
+	  __htab->old_size = __htab->size;
+	  __htab->old_filled = __htab->filled;
+	  __htab->old_next = 0;
+	  __htab->table = __t;
+	  __htab->size *= 2;
+	  __htab->filled = 0;
+	}
+    }
+  if (__htab->old_table != NULL)
+    __uclibc_hmigrate (__htab, 4);
+  else if (__htab->filled + 1 >= __htab->size)
+    {
+      /* One slot must stay empty to end the probes. */
+      *__retval = NULL;
+      errno = ENOMEM;
+      return 0;
+    }
+
+  __s = __uclibc_hprobe (__htab->table, __htab->size, __item.key, __hash);
+  __s->__hash = __hash;
+  __s->__entry = __item;
+  ++__htab->filled;
+  *__retval = &__s->__entry;
+  return 1;
+}
+#endif
+
+#endif /* _BITS_UCLIBC_SEARCH_H */
@@ -517,3 +517,196 @@ extern FILE *__stdout;			/* For putchar() macro. */
 # endif
 
 #endif /* __STDIO_PUTC_MACRO */
+
+/**********************************************************************/
+/* Bulk transfers through the getc/putc windows.
+ *
+ * The library keeps __bufpos..__bufgetc_u readable and
+ * __bufpos..__bufputc_u writable whenever a plain buffer copy is all
+ * that getc/putc would have to do (narrow, fully buffered, no ungot
+ * chars, ...); otherwise the window is empty.  A request that fits
+ * entirely inside the window is done here with a single copy, anything
+ * else goes to the library unchanged.  fgets only takes the fast path
+ * when the whole line (or __n - 1 chars) is already buffered, so a
+ * fallback never sees a partially consumed line.
+ */
+
+/* First define the default definitions.  They overriden below as necessary. */
+#define __FREAD_UNLOCKED(__p, __z, __n, __stream) \
+		(fread_unlocked)((__p),(__z),(__n),(__stream))
+#define __FREAD(__p, __z, __n, __stream) \
+		(fread)((__p),(__z),(__n),(__stream))
+#define __FGETS_UNLOCKED(__s, __n, __stream) \
+		(fgets_unlocked)((__s),(__n),(__stream))
+#define __FGETS(__s, __n, __stream)	(fgets)((__s),(__n),(__stream))
+#define __FWRITE_UNLOCKED(__p, __z, __n, __stream) \
+		(fwrite_unlocked)((__p),(__z),(__n),(__stream))
+#define __FWRITE(__p, __z, __n, __stream) \
+		(fwrite)((__p),(__z),(__n),(__stream))
+
+/* Nonzero if __z * __n bytes is not zero and can be computed without
+ * overflow.  Keeps the fast path free of a (software) division on ARM;
+ * zero-sized requests go to the library, which returns 0 for them. */
+#define __STDIO_SMALL_REQUEST(__z, __n)								\
+		((__z) != 0 && (__n) != 0 && (((__z) | (__n)) >> 16) == 0)
+
+#ifdef __STDIO_GETC_MACRO
+
+static __inline int
+__stdio_getc_window_read(void *__restrict __p, size_t __bytes,
+						 __FILE *__restrict __stream)
+{
+	__ssize_t __avail = __stream->__bufgetc_u - __stream->__bufpos;
+
+	if ((__avail <= 0) || ((size_t) __avail < __bytes)) {
+		return 0;
+	}
+	__builtin_memcpy(__p, __stream->__bufpos, __bytes);
+	__stream->__bufpos += __bytes;
+	return 1;
+}
+
+static __inline char *
+__stdio_getc_window_gets(char *__restrict __s, int __n,
+						 __FILE *__restrict __stream)
+{
+	unsigned char *__p = __stream->__bufpos;
+	unsigned char *__e = __stream->__bufgetc_u;
+	char *__d = __s;
+
+	if ((__n <= 1) || (__e <= __p)) {
+		return 0;
+	}
+	if (__e - __p >= __n) {
+		__e = __p + (__n - 1);
+	} else {
+		/* Window shorter than the caller's buffer: a line must end in it. */
+		while ((__p < __e) && (*__p != '\n')) {
+			++__p;
+		}
+		if (__p == __e) {
+			return 0;
+		}
+		__e = __p + 1;
+		__p = __stream->__bufpos;
+	}
+	while (__p < __e) {
+		if ((*__d++ = *__p++) == '\n') {
+			break;
+		}
+	}
+	*__d = 0;
+	__stream->__bufpos = __p;
+	return __s;
+}
+
+# undef  __FREAD_UNLOCKED
+# define __FREAD_UNLOCKED(__p, __z, __n, __stream)						\
+		(__extension__ ({												\
+			void *__P = (__p);											\
+			size_t __Z = (__z);											\
+			size_t __N = (__n);											\
+			FILE *__S = (__stream);										\
+			((__STDIO_SMALL_REQUEST(__Z, __N)							\
+			  && __stdio_getc_window_read(__P, __Z * __N, __S))		\
+			 ? __N														\
+			 : (fread_unlocked)(__P, __Z, __N, __S));					\
+		}) )
+
+# undef  __FGETS_UNLOCKED
+# define __FGETS_UNLOCKED(__s, __n, __stream)							\
+		(__extension__ ({												\
+			char *__D = (__s);											\
+			int __N = (__n);											\
+			FILE *__S = (__stream);										\
+			(__stdio_getc_window_gets(__D, __N, __S)					\
+			 ?: (fgets_unlocked)(__D, __N, __S));						\
+		}) )
+
+# ifdef __UCLIBC_HAS_THREADS__
+/* Streams switched to FSETLOCKING_BYCALLER (or not yet shared because
+ * threads were never started) never take the stream lock, so they can
+ * use the window directly just like getc/putc above. */
+#  undef  __FREAD
+#  define __FREAD(__p, __z, __n, __stream)								\
+		(__extension__ ({												\
+			void *__P = (__p);											\
+			size_t __Z = (__z);											\
+			size_t __N = (__n);											\
+			FILE *__S = (__stream);										\
+			((__S->__user_locking && __STDIO_SMALL_REQUEST(__Z, __N)	\
+			  && __stdio_getc_window_read(__P, __Z * __N, __S))		\
+			 ? __N														\
+			 : (fread)(__P, __Z, __N, __S));							\
+		}) )
+
+#  undef  __FGETS
+#  define __FGETS(__s, __n, __stream)									\
+		(__extension__ ({												\
+			char *__D = (__s);											\
+			int __N = (__n);											\
+			FILE *__S = (__stream);										\
+			((__S->__user_locking										\
+			  && __stdio_getc_window_gets(__D, __N, __S))				\
+			 ? __D														\
+			 : (fgets)(__D, __N, __S));									\
+		}) )
+# else
+#  undef  __FREAD
+#  define __FREAD(__p, __z, __n, __stream) \
+		__FREAD_UNLOCKED((__p),(__z),(__n),(__stream))
+#  undef  __FGETS
+#  define __FGETS(__s, __n, __stream)	__FGETS_UNLOCKED((__s),(__n),(__stream))
+# endif
+
+#endif /* __STDIO_GETC_MACRO */
+
+#ifdef __STDIO_PUTC_MACRO
+
+static __inline int
+__stdio_putc_window_write(__const void *__restrict __p, size_t __bytes,
+						  __FILE *__restrict __stream)
+{
+	__ssize_t __avail = __stream->__bufputc_u - __stream->__bufpos;
+
+	if ((__avail <= 0) || ((size_t) __avail < __bytes)) {
+		return 0;
+	}
+	__builtin_memcpy(__stream->__bufpos, __p, __bytes);
+	__stream->__bufpos += __bytes;
+	return 1;
+}
+
+# undef  __FWRITE_UNLOCKED
+# define __FWRITE_UNLOCKED(__p, __z, __n, __stream)						\
+		(__extension__ ({												\
+			__const void *__P = (__p);									\
+			size_t __Z = (__z);											\
+			size_t __N = (__n);											\
+			FILE *__S = (__stream);										\
+			((__STDIO_SMALL_REQUEST(__Z, __N)							\
+			  && __stdio_putc_window_write(__P, __Z * __N, __S))		\
+			 ? __N														\
+			 : (fwrite_unlocked)(__P, __Z, __N, __S));					\
+		}) )
+
+# ifdef __UCLIBC_HAS_THREADS__
+#  undef  __FWRITE
+#  define __FWRITE(__p, __z, __n, __stream)							\
+		(__extension__ ({												\
+			__const void *__P = (__p);									\
+			size_t __Z = (__z);											\
+			size_t __N = (__n);											\
+			FILE *__S = (__stream);										\
+			((__S->__user_locking && __STDIO_SMALL_REQUEST(__Z, __N)	\
+			  && __stdio_putc_window_write(__P, __Z * __N, __S))		\
+			 ? __N														\
+			 : (fwrite)(__P, __Z, __N, __S));							\
+		}) )
+# else
+#  undef  __FWRITE
+#  define __FWRITE(__p, __z, __n, __stream) \
+		__FWRITE_UNLOCKED((__p),(__z),(__n),(__stream))
+# endif
+
+#endif /* __STDIO_PUTC_MACRO */
@@ -0,0 +1,176 @@
+/* Per-second cache of localtime_r and strftime, for timestamps.
+ *
+ * GNU Library General Public License (LGPL) version 2 or later.
+ *
+ * A logger stamping thousands of lines a second calls localtime_r and
+ * strftime for each, and both redo the same work until the second
+ * changes.  Here strftime_parse splits a format once, at its %N
+ * fields, into a struct strftime_format that any number of caches and
+ * threads may share.  A struct strftime_cache then holds the local
+ * time and the formatted text of the last second it was asked for:
+ * strftime_cached copies that text and writes only the %N digits,
+ * and localtime_cached returns the held struct tm.
+ *
+ * A new second goes through localtime_r and strftime as before, and
+ * localtime_r calls tzset, which with __UCLIBC_HAS_TZ_FILE_READ_MANY__
+ * rereads __UCLIBC_TZ_FILE_PATH__ when TZ is not set.  A change of TZ
+ * or of that file therefore shows from the next second on, and costs
+ * nothing within a second.
+ *
+ * A cache is not locked: give each thread its own.
+ */
+
+#ifndef _TIME_H
+#error Always include <time.h> rather than <bits/uClibc_strftime_cache.h>
+#endif
+
+#ifndef _BITS_UCLIBC_STRFTIME_CACHE_H
+#define _BITS_UCLIBC_STRFTIME_CACHE_H	1
+
+#include <errno.h>
+#include <string.h>
+
+/* Parses FORMAT, which is as for strftime plus %N for the nine digits
+   of the nanoseconds and %1N to %9N for their first one to nine.
+   Returns 0, or -1 with errno EINVAL if FORMAT has more than eight %N
+   fields or is too long to keep. */
+static __inline int
+strftime_parse (struct strftime_format *__fmt, const char *__format)
+{
+  char *__t = __fmt->text;
+  char *__end = __fmt->text + sizeof (__fmt->text) - 1;
+  int __d;
+
+  __fmt->nfrac = 0;
+  /* Each piece has a leading space, so strftime never returns 0 for
+     one that formats to nothing. */
+  *__t++ = ' ';
+  while (*__format != '\0')
+    {
+      if (__format[0] == '%'
+	  && (__format[1] == 'N'
+	      || (__format[1] >= '1' && __format[1] <= '9'
+		  && __format[2] == 'N')))
+	{
+	  __d = __format[1] == 'N' ? 9 : __format[1] - '0';
+	  __format += __format[1] == 'N' ? 2 : 3;
+	  if (__fmt->nfrac == sizeof (__fmt->digits) || __t + 2 > __end)
+	    goto __invalid;
+	  __fmt->digits[__fmt->nfrac++] = __d;
+	  *__t++ = '\0';
+	  *__t++ = ' ';
+	  continue;
+	}
+      /* Whatever follows a % is strftime's, so %%N stays literal. */
+      if (__format[0] == '%' && __format[1] != '\0')
+	{
+	  if (__t + 2 > __end)
+	    goto __invalid;
+	  *__t++ = *__format++;
+	}
+      if (__t + 1 > __end)
+	goto __invalid;
+      *__t++ = *__format++;
+    }
+  *__t = '\0';
+  return 0;
+
+ __invalid:
+  __fmt->text[0] = '\0';
+  __fmt->nfrac = 0;
+  errno = EINVAL;
+  return -1;
+}
+
+/* Sets up CACHE for FORMAT, which stays the caller's.  FORMAT may be
+   NULL for a cache used only through localtime_cached. */
+static __inline void
+strftime_cache_init (struct strftime_cache *__cache,
+		     const struct strftime_format *__format)
+{
+  __cache->format = __format;
+  __cache->valid = 0;
+  __cache->len = (size_t) -1;
+}
+
+/* Takes CACHE to second SEC. */
+static __inline void
+__strftime_cache_fill (struct strftime_cache *__cache, time_t __sec)
+{
+  const struct strftime_format *__fmt = __cache->format;
+  const char *__piece;
+  char __tmp[sizeof (__cache->text) + 1];
+  size_t __len = 0;
+  size_t __n;
+  int __i;
+
+  __cache->valid = 0;
+  __cache->len = (size_t) -1;
+  if (localtime_r (&__sec, &__cache->tm) == NULL)
+    return;
+  __cache->sec = __sec;
+  __cache->valid = 1;
+  if (__fmt == NULL)
+    return;
+
+  for (__piece = __fmt->text, __i = 0; ; ++__i)
+    {
+      __n = strftime (__tmp, sizeof (__cache->text) - __len + 1, __piece,
+		      &__cache->tm);
+      if (__n == 0)
+	return;
+      memcpy (__cache->text + __len, __tmp + 1, __n - 1);
+      __len += __n - 1;
+      if (__i == __fmt->nfrac)
+	break;
+      if (__len + __fmt->digits[__i] >= sizeof (__cache->text))
+	return;
+      __cache->frac[__i] = __len;
+      __len += __fmt->digits[__i];
+      __piece += strlen (__piece) + 1;
+    }
+  __cache->text[__len] = '\0';
+  __cache->len = __len;
+}
+
+/* The local time of SEC, as localtime_r gives it, or NULL with errno
+   set if localtime_r fails.  It stays valid until CACHE moves to
+   another second. */
+static __inline const struct tm *
+localtime_cached (struct strftime_cache *__cache, time_t __sec)
+{
+  if (!__cache->valid || __cache->sec != __sec)
+    __strftime_cache_fill (__cache, __sec);
+  return __cache->valid ? &__cache->tm : NULL;
+}
+
+/* Formats SEC and NSEC, 0 to 999999999 nanoseconds into it, with the
+   format of CACHE into S, as strftime would.  Returns the length
+   written before the terminating NUL, or 0 if it does not fit in
+   MAXSIZE bytes or in the cache, or if localtime_r fails. */
+static __inline size_t
+strftime_cached (char *__restrict __s, size_t __maxsize,
+		 struct strftime_cache *__restrict __cache,
+		 time_t __sec, long __nsec)
+{
+  const struct strftime_format *__fmt = __cache->format;
+  char __digits[9];
+  unsigned long __ns;
+  int __i;
+
+  if (!__cache->valid || __cache->sec != __sec)
+    __strftime_cache_fill (__cache, __sec);
+  if (__cache->len >= __maxsize)
+    return 0;
+  memcpy (__s, __cache->text, __cache->len + 1);
+  if (__fmt->nfrac != 0)
+    {
+      for (__ns = __nsec, __i = 8; __i >= 0; --__i, __ns /= 10)
+	__digits[__i] = '0' + __ns % 10;
+      for (__i = 0; __i < __fmt->nfrac; ++__i)
+	memcpy (__s + __cache->frac[__i], __digits, __fmt->digits[__i]);
+    }
+  return __cache->len;
+}
+
+#endif /* _BITS_UCLIBC_STRFTIME_CACHE_H */
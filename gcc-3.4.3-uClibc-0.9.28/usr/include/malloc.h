@@ -126,7 +126,7 @@ extern __malloc_ptr_t memalign __MALLOC_P ((size_t __alignment, size_t __size));
 /* Allocate SIZE bytes on a page boundary.  */
 extern __malloc_ptr_t valloc __MALLOC_P ((size_t __size)) __attribute_malloc__;
 
-#ifdef __MALLOC_STANDARD__
+#if defined __MALLOC_STANDARD__ || defined _MALLOC_TC_DEFINE
 
 /* SVID2/XPG mallinfo structure */
 struct mallinfo {
@@ -174,15 +174,32 @@ extern void malloc_stats(FILE *file);
 #define M_MMAP_THRESHOLD    -3
 #define M_MMAP_MAX          -4
 #define M_CHECK_ACTION      -5
+/* Thread-caching malloc only: bytes each thread may cache. */
+#define M_THREAD_CACHE_MAX  -6
 
 /* General SVID/XPG interface to tunable parameters. */
 extern int mallopt __MALLOC_P ((int __param, int __val));
 
-#endif /* __MALLOC_STANDARD__ */
+/* Sampling heap profiler, in the thread-caching malloc only: see
+   <bits/uClibc_malloc_tc.h>.  Start sampling about once every
+   SAMPLE_BYTES allocated bytes; stop; write the live-allocation stacks
+   and a size histogram to a descriptor or to a file. */
+extern int malloc_profile_start(size_t __sample_bytes);
+extern void malloc_profile_stop(void);
+extern int malloc_profile_dump(int __fd);
+extern int malloc_profile_save(__const char *__filename);
+
+#endif /* __MALLOC_STANDARD__ || _MALLOC_TC_DEFINE */
 
 
 #ifdef __cplusplus
 }; /* end of extern "C" */
 #endif
 
+/* Defined in one source file of a program, selects the thread-caching
+   size-class malloc instead of the one in libc; see the header. */
+#ifdef _MALLOC_TC_DEFINE
+# include <bits/uClibc_malloc_tc.h>
+#endif
+
 #endif /* malloc.h */
@@ -350,6 +350,23 @@ extern int matherr (struct exception *__exc);
 # include <bits/mathinline.h>
 #endif
 
+/* There is no FPU and libm computes the float functions in double;
+   these are computed in integer arithmetic instead.  */
+#if (defined __USE_MISC || defined __USE_ISOC99) && !defined __NO_MATH_INLINES
+# include <bits/uClibc_mathf.h>
+# define sqrtf(_x)	__uclibc_sqrtf (_x)
+# define expf(_x)	__uclibc_expf (_x)
+# define logf(_x)	__uclibc_logf (_x)
+# define log10f(_x)	__uclibc_log10f (_x)
+# define powf(_x, _y)	__uclibc_powf ((_x), (_y))
+# define sinf(_x)	__uclibc_sinf (_x)
+# define cosf(_x)	__uclibc_cosf (_x)
+# ifdef __USE_ISOC99
+#  define exp2f(_x)	__uclibc_exp2f (_x)
+#  define log2f(_x)	__uclibc_log2f (_x)
+# endif
+#endif
+
 
 #if __USE_ISOC99
 /* ISO C99 defines some macros to compare number while taking care
@@ -558,11 +558,45 @@ extern size_t regerror _RE_ARGS ((int __errcode, const regex_t *__preg,
 
 extern void regfree _RE_ARGS ((regex_t *__preg));
 
+/* Cached patterns, defined by the one source file that defines
+   _REGEX_CACHE_DEFINE; see <bits/uClibc_regex_cache.h>.  */
+typedef struct __regex_cached regex_cached_t;
+
+struct regex_cache_stats
+{
+  unsigned long hits;			/* found compiled */
+  unsigned long misses;			/* compiled by regcomp */
+  unsigned long evictions;		/* freed for room */
+  unsigned long prefilter_rejects;	/* lacked the required literal */
+  unsigned long dfa_runs;		/* settled by the DFA alone */
+  unsigned long regexec_runs;		/* passed on to regexec */
+  unsigned int entries;			/* patterns cached now */
+  unsigned int dfa_entries;		/* ... with a DFA */
+};
+
+extern int regcomp_cached _RE_ARGS ((const regex_cached_t **__preg,
+				     const char *__pattern, int __cflags));
+
+extern int regexec_cached _RE_ARGS ((const regex_cached_t *__preg,
+				     const char *__string, size_t __nmatch,
+				     regmatch_t __pmatch[__restrict_arr],
+				     int __eflags));
+
+extern void regfree_cached _RE_ARGS ((const regex_cached_t *__preg));
+
+extern void regex_cache_flush _RE_ARGS ((void));
+
+extern void regex_cache_stats _RE_ARGS ((struct regex_cache_stats *__st));
+
 
 #ifdef __cplusplus
 }
 #endif	/* C++ */
 
+#ifdef _REGEX_CACHE_DEFINE
+# include <bits/uClibc_regex_cache.h>
+#endif
+
 #endif /* regex.h */
 
 /*
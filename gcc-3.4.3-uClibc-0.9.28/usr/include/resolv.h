@@ -370,4 +370,39 @@ int		res_nsend __P((res_state, const u_char *, int, u_char *, int));
 void		res_nclose __P((res_state));
 __END_DECLS
 
+/* Caching stub resolver, defined by the one source file that defines
+   _RES_CACHE_DEFINE; see <bits/uClibc_res_cache.h>.  The plain libc
+   lookups are not cached; only callers of these functions are.  */
+struct hostent;
+struct addrinfo;
+struct res_cache_stats {
+	unsigned long	hits;		/* answered from the cache */
+	unsigned long	negative_hits;	/* ... with a cached failure */
+	unsigned long	misses;		/* sent to a name server */
+	unsigned long	expired;	/* misses on an expired entry */
+	unsigned long	evictions;	/* entries dropped for room */
+	unsigned long	hosts_hits;	/* answered from /etc/hosts */
+	unsigned long	reloads;	/* configuration files read */
+	unsigned long	failures;	/* queries that got no answer */
+	unsigned int	entries;	/* answers cached now */
+};
+__BEGIN_DECLS
+int		res_cache_query __P((const char *, int, int, u_char *, int));
+int		res_cache_gethostbyname_r __P((const char *, struct hostent *,
+					       char *, size_t,
+					       struct hostent **, int *));
+struct hostent *res_cache_gethostbyname __P((const char *));
+int		res_cache_getaddrinfo __P((const char *, const char *,
+					   const struct addrinfo *,
+					   struct addrinfo **));
+void		res_cache_freeaddrinfo __P((struct addrinfo *));
+int		res_cache_nameservers __P((const struct sockaddr_in *, int));
+void		res_cache_flush __P((void));
+void		res_cache_stats __P((struct res_cache_stats *));
+__END_DECLS
+
+#ifdef _RES_CACHE_DEFINE
+# include <bits/uClibc_res_cache.h>
+#endif
+
 #endif /* !_RESOLV_H_ */
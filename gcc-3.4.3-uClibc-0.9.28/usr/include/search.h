@@ -108,6 +108,22 @@ extern int hsearch_r (ENTRY __item, ACTION __action, ENTRY **__retval,
 		      struct hsearch_data *__htab) __THROW;
 extern int hcreate_r (size_t __nel, struct hsearch_data *__htab) __THROW;
 extern void hdestroy_r (struct hsearch_data *__htab) __THROW;
+
+/* Data type for hcreate_grow_r, hsearch_grow_r and hdestroy_grow_r,
+   which are the reentrant functions with a table that grows as
+   needed.  */
+struct __uclibc_hslot;
+struct hsearch_grow_data
+  {
+    struct __uclibc_hslot *table;
+    unsigned int size;
+    unsigned int filled;
+    /* The table before it last grew, while its entries are moved.  */
+    struct __uclibc_hslot *old_table;
+    unsigned int old_size;
+    unsigned int old_filled;
+    unsigned int old_next;
+  };
 #endif
 
 
@@ -170,6 +186,18 @@ extern void *lfind (__const void *__key, __const void *__base,
 extern void *lsearch (__const void *__key, void *__base,
 		      size_t *__nmemb, size_t __size, __compar_fn_t __compar);
 
+/* The libc tsearch family does not balance its trees; these names are
+   red-black versions instead, and the growable hash functions are
+   defined here as well.  */
+#include <bits/uClibc_search.h>
+#define tsearch(_k, _r, _c)	__uclibc_tsearch ((_k), (_r), (_c))
+#define tfind(_k, _r, _c)	__uclibc_tfind ((_k), (_r), (_c))
+#define tdelete(_k, _r, _c)	__uclibc_tdelete ((_k), (_r), (_c))
+#define twalk(_r, _a)		__uclibc_twalk ((_r), (_a))
+#ifdef __USE_GNU
+# define tdestroy(_r, _f)	__uclibc_tdestroy ((_r), (_f))
+#endif
+
 __END_DECLS
 
 #endif /* search.h */
@@ -836,6 +836,19 @@ extern void funlockfile (FILE *__stream) __THROW;
 #define fputc_unlocked(_ch, _fp)     __FPUTC_UNLOCKED(_ch, _fp)
 #endif
 
+#define fread(_p, _z, _n, _fp)       __FREAD(_p, _z, _n, _fp)
+#define fwrite(_p, _z, _n, _fp)      __FWRITE(_p, _z, _n, _fp)
+#define fgets(_s, _n, _fp)           __FGETS(_s, _n, _fp)
+
+#ifdef __USE_MISC
+#define fread_unlocked(_p, _z, _n, _fp)  __FREAD_UNLOCKED(_p, _z, _n, _fp)
+#define fwrite_unlocked(_p, _z, _n, _fp) __FWRITE_UNLOCKED(_p, _z, _n, _fp)
+#endif
+
+#ifdef __USE_GNU
+#define fgets_unlocked(_s, _n, _fp)  __FGETS_UNLOCKED(_s, _n, _fp)
+#endif
+
 #define getchar()                    __GETC(__stdin)
 #define putchar(_ch)                 __PUTC((_ch), __stdout)
 
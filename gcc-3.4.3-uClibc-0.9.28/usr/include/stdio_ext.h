@@ -79,7 +79,134 @@ extern size_t __fpending (FILE *__fp);
 extern void _flushlbf (void);
 
 
-/* Set locking status of stream FP to TYPE.  */
+#ifdef __STDIO_BUFFERS
+/* Return the number of bytes already buffered for reading on FP,
+   including a pushed back character.  Zero if FP is not reading.  */
+static __inline size_t
+__freadahead (FILE *__fp)
+{
+  if (__fp->__modeflags & __FLAG_WRITING)
+    return 0;
+  return (__fp->__bufread - __fp->__bufpos)
+	 + ((__fp->__modeflags & __FLAG_UNGOT) ? 1 : 0);
+}
+
+/* Return a pointer to the bytes buffered for reading on FP and store
+   their number in *SIZEP, or return NULL if nothing can be read in
+   place (empty buffer, pushed back characters, or FP is writing).  The
+   bytes may be consumed with __freadptrinc without copying them.  */
+static __inline __const char *
+__freadptr (FILE *__fp, size_t *__sizep)
+{
+  size_t __size;
+
+  if (__fp->__modeflags & (__FLAG_WRITING | __FLAG_UNGOT))
+    return NULL;
+  __size = __fp->__bufread - __fp->__bufpos;
+  if (__size == 0)
+    return NULL;
+  *__sizep = __size;
+  return (__const char *) __fp->__bufpos;
+}
+
+/* Consume INCREMENT bytes of the buffer returned by __freadptr.
+   INCREMENT must not exceed the size it reported.  */
+static __inline void
+__freadptrinc (FILE *__fp, size_t __increment)
+{
+  __fp->__bufpos += __increment;
+}
+#endif
+
+
+/* Default buffer sizes chosen by __fsetdefaultbuf for each kind of
+   file.  Each can be overridden through the environment variable named
+   in the comment, which is read once, on first use.  */
+#define __STDIO_DEFBUF_FILE	16384	/* STDIO_BUFSIZ_FILE, full buffering */
+#define __STDIO_DEFBUF_TTY	256	/* STDIO_BUFSIZ_TTY, line buffering */
+#define __STDIO_DEFBUF_PIPE	512	/* STDIO_BUFSIZ_PIPE, full buffering */
+
+/* Declared here rather than through <stdlib.h> and <unistd.h>, so that
+   <stdio_ext.h> adds no other names for its users.  */
+extern char *getenv (__const char *__name) __THROW;
+extern unsigned long int strtoul (__const char *__restrict __nptr,
+				  char **__restrict __endptr, int __base)
+     __THROW;
+extern int isatty (int __fd) __THROW;
+#ifndef __USE_FILE_OFFSET64
+extern __off_t lseek (int __fd, __off_t __offset, int __whence) __THROW;
+#else
+# ifdef __REDIRECT
+extern __off64_t __REDIRECT (lseek,
+			     (int __fd, __off64_t __offset, int __whence)
+			     __THROW,
+			     lseek64);
+# else
+#  define lseek lseek64
+extern __off64_t lseek64 (int __fd, __off64_t __offset, int __whence) __THROW;
+# endif
+#endif
+
+/* The size for a file of KIND: 0 seekable, 1 terminal, 2 other.  */
+static __inline size_t
+__stdio_defbuf (int __kind)
+{
+  static size_t __size[3];
+  static __const char *__const __name[3] =
+    { "STDIO_BUFSIZ_FILE", "STDIO_BUFSIZ_TTY", "STDIO_BUFSIZ_PIPE" };
+  static __const size_t __dflt[3] =
+    { __STDIO_DEFBUF_FILE, __STDIO_DEFBUF_TTY, __STDIO_DEFBUF_PIPE };
+
+  if (__size[__kind] == 0)
+    {
+      __const char *__val = getenv (__name[__kind]);
+      unsigned long int __n;
+
+      __n = __val != NULL ? strtoul (__val, NULL, 0) : 0;
+      __size[__kind] = __n != 0 ? __n : __dflt[__kind];
+    }
+  return __size[__kind];
+}
+
+/* Return the buffer size __fsetdefaultbuf would pick for descriptor FD
+   and store the matching buffering mode in *MODE: seekable files, such
+   as regular files and block devices, get __STDIO_DEFBUF_FILE,
+   terminals __STDIO_DEFBUF_TTY, and pipes, sockets and other devices
+   __STDIO_DEFBUF_PIPE.  */
+static __inline size_t
+__fdefaultbufsize (int __fd, int *__mode)
+{
+  *__mode = _IOFBF;
+  if (lseek (__fd, 0, SEEK_CUR) != -1)
+    return __stdio_defbuf (0);
+  if (isatty (__fd))
+    {
+      *__mode = _IOLBF;
+      return __stdio_defbuf (1);
+    }
+  return __stdio_defbuf (2);
+}
+
+/* Give FP a library-allocated buffer sized for the kind of file it is
+   connected to, instead of the fixed BUFSIZ.  fopen and fdopen do not
+   do this themselves: the caller opts in for each stream, and, like
+   setvbuf, must do so before any other operation on FP.  The buffer is
+   used in place by all stdio calls and freed by fclose.  */
+static __inline int
+__fsetdefaultbuf (FILE *__fp)
+{
+  int __mode;
+  size_t __size = __fdefaultbufsize (fileno (__fp), &__mode);
+
+  return setvbuf (__fp, NULL, __mode, __size);
+}
+
+
+/* Set locking status of stream FP to TYPE.  With FSETLOCKING_BYCALLER
+   the stream lock is never taken, and the getc, putc, fread, fwrite
+   and fgets macros in <stdio.h> copy straight to or from the stream
+   buffer whenever the request fits in it, without calling into the
+   library at all.  */
 extern int __fsetlocking (FILE *__fp, int __type);
 
 __END_DECLS
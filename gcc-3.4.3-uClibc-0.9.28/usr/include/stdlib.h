@@ -638,6 +638,8 @@ typedef int (*__compar_fn_t) (__const void *, __const void *);
 typedef __compar_fn_t comparison_fn_t;
 # endif
 #endif
+/* Comparison functions that take an extra argument, for qsort_r.  */
+typedef int (*__compar_d_fn_t) (__const void *, __const void *, void *);
 
 __BEGIN_NAMESPACE_STD
 /* Do a binary search for KEY in BASE, which consists of NMEMB elements
@@ -656,6 +658,11 @@ extern int abs (int __x) __THROW __attribute__ ((__const__));
 extern long int labs (long int __x) __THROW __attribute__ ((__const__));
 __END_NAMESPACE_STD
 
+/* The libc qsort is a shell sort; qsort and qsort_r are an inline
+   introsort instead.  */
+#include <bits/uClibc_qsort.h>
+#define qsort(_b, _n, _z, _c) __uclibc_qsort ((_b), (_n), (_z), (_c))
+
 #ifdef __USE_ISOC99
 __extension__ extern long long int llabs (long long int __x)
      __THROW __attribute__ ((__const__));
@@ -437,6 +437,32 @@ extern int getdate_r (__const char *__restrict __string,
 
 __END_DECLS
 
+# ifdef __USE_GNU
+/* A strftime format parsed once for strftime_cached, which also takes
+   %N for the nanoseconds and %1N to %9N for their first digits.  */
+struct strftime_format
+  {
+    char text[128];		/* The pieces between %N fields */
+    unsigned char nfrac;	/* How many %N fields */
+    unsigned char digits[8];	/* Digits of each */
+  };
+
+/* The local time and the formatted text of one second, for one
+   format.  Each thread keeps its own.  */
+struct strftime_cache
+  {
+    const struct strftime_format *format;
+    time_t sec;
+    int valid;			/* TM holds SEC */
+    size_t len;			/* Length of TEXT, or (size_t) -1 */
+    struct tm tm;
+    unsigned char frac[8];	/* Where each %N field is in TEXT */
+    char text[128];
+  };
+
+#  include <bits/uClibc_strftime_cache.h>
+# endif
+
 #endif /* <time.h> included.  */
 
 #endif /* <time.h> not already included.  */